@@ -0,0 +1,51 @@
+#ifndef NET_CLASSIFY_H
+#define NET_CLASSIFY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "net_device.h"
+#include "net_packet.h"
+
+// ======================================================================
+// 接收分类
+// 接收线程在申请缓冲区之前按规则表匹配每一帧：
+//   丢弃 —— 不占用内存池，不进入接收环
+//   回调 —— 在接收线程中直接处理，不占用内存池
+//   队列 —— 放入指定的接收队列（队列0即net_receive_xxx使用的默认队列）
+// 规则按顺序匹配，第一条匹配的生效；都不匹配时放入队列0。
+// ======================================================================
+
+#define NET_RULE_MAX            64
+
+#define NET_MATCH_ETHERTYPE     0x01    // 去掉VLAN标签后的EtherType
+#define NET_MATCH_DST_MAC       0x02    // 目的MAC，按dst_mask比较
+#define NET_MATCH_VLAN          0x04    // 外层VLAN ID
+#define NET_MATCH_UNTAGGED      0x08    // 不带VLAN标签
+
+typedef enum {
+    NET_ACTION_QUEUE = 0,   // 放入接收队列queue
+    NET_ACTION_DROP,        // 丢弃
+    NET_ACTION_CALLBACK,    // 接收线程中回调，data只在回调期间有效
+} net_action_t;
+
+typedef struct {
+    uint32_t match;                     // NET_MATCH_xxx 组合，0匹配所有帧
+    uint16_t ethertype;
+    uint16_t vlan_id;
+    uint8_t dst_mac[NET_ETH_ALEN];
+    uint8_t dst_mask[NET_ETH_ALEN];     // 全0表示精确匹配；01:00:00:00:00:00匹配所有组播
+    uint8_t action;                     // net_action_t
+    uint8_t queue;                      // NET_ACTION_QUEUE的目标队列，小于配置的rx_queue_nr
+    net_dev_callback_t callback;        // NET_ACTION_CALLBACK
+    void *userdata;
+} net_rule_t;
+
+// 安装规则表，count为0清除全部规则；运行中可调用，接收线程从下一帧起使用新表
+int net_classify_set(net_device_t *dev, const net_rule_t *rules, int count);
+
+// 从指定队列批量零拷贝接收，语义同net_receive_burst；每个队列只能在一个线程中接收
+int net_receive_queue_burst(net_device_t *dev, int queue, uint8_t **buffers, size_t *lengths, int max);
+// 等待指定队列有数据，语义同net_receive_wait
+int net_receive_queue_wait(net_device_t *dev, int queue, int timeout_ms);
+
+#endif
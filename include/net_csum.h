@@ -0,0 +1,44 @@
+#ifndef NET_CSUM_H
+#define NET_CSUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ======================================================================
+// 校验和
+// 以太网CRC32(FCS)与互联网校验和(RFC 1071)，启动时按CPU特性选择实现：
+//   CRC32：PCLMULQDQ折叠 / slice-by-8查表
+//   互联网校验和：AVX2 / 64位标量累加
+// ======================================================================
+
+#define NET_FCS_LEN             4
+
+#define NET_CSUM_IMPL_GENERIC   0   // 只用可移植实现
+#define NET_CSUM_IMPL_BEST      1   // CPU支持的最快实现（默认）
+
+// 以太网CRC32，crc传0开始，可分段连续计算
+uint32_t net_crc32(uint32_t crc, const void *data, size_t length);
+
+// 互联网校验和的部分和（按内存字节序累加16位字），可分段累加
+// 分段时除最后一段外长度需为偶数
+uint32_t net_csum_partial(const void *data, size_t length, uint32_t sum);
+// 折叠并取反，结果按内存字节序直接写入报文
+uint16_t net_csum_fold(uint32_t sum);
+
+static inline uint16_t net_inet_csum(const void *data, size_t length) {
+    return net_csum_fold(net_csum_partial(data, length, 0));
+}
+
+// 在帧尾写入FCS（小端，先发低字节），返回新长度
+size_t net_fcs_append(uint8_t *frame, size_t length);
+// 校验帧尾的FCS，正确返回0
+int net_fcs_check(const uint8_t *frame, size_t length);
+
+// 校验以太帧中的IPv4头及UDP/TCP校验和；非IPv4或分片不校验
+// 返回 0：正确或无需校验；-1：校验失败
+int net_csum_verify_l4(const uint8_t *frame, size_t length);
+
+// 切换实现（基准测试用），返回当前实现名称
+const char *net_csum_select(int impl);
+
+#endif
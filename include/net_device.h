@@ -2,6 +2,8 @@
 #define NET_DEVICE_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
 #include <mempool.h>
 
 #define NET_LOG_LEVEL_DEBUG     0
@@ -10,53 +12,117 @@
 #define NET_LOG_LEVEL_ERROR     3
 
 #ifndef NET_LOG_LEVEL
-#define NET_LOG_LEVEL NET_LOG_LEVEL_DEBUG  // 默认日志级别
+#define NET_LOG_LEVEL NET_LOG_LEVEL_DEBUG  // 默认日志级别（编译期，低于此级别的日志不编译）
+#endif
+
+#ifndef NET_LOG_RUNTIME_LEVEL
+#define NET_LOG_RUNTIME_LEVEL NET_LOG_LEVEL_INFO  // 默认运行时级别：逐帧的DEBUG日志需net_log_set_level打开
+#endif
+
+#ifndef NET_LOG_ASYNC
+#define NET_LOG_ASYNC 1  // 日志写入每线程无锁环，由后台线程格式化输出
 #endif
 
 void net_base_log(uint8_t level, const char* file, int line, const char* fmt, ...);
 void net_base_hex(const unsigned char *data, size_t length);
 
+// 运行时日志级别，默认取NET_LOG_RUNTIME_LEVEL与NET_LOG_LEVEL中较高的一个；关闭的级别只有一次判断的开销
+extern uint8_t net_log_level;
+void net_log_set_level(uint8_t level);
+uint8_t net_log_get_level(void);
+// 立即输出所有未输出的日志
+void net_log_flush(void);
+
+#define NET_LOG_ON(level)  __builtin_expect(__atomic_load_n(&net_log_level, __ATOMIC_RELAXED) <= (level), 0)
+
 // 各级别日志宏
 #if NET_LOG_LEVEL <= NET_LOG_LEVEL_DEBUG
-#define NET_LOGD(fmt, ...) net_base_log(NET_LOG_LEVEL_DEBUG, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#define NET_LOGD(fmt, ...) (NET_LOG_ON(NET_LOG_LEVEL_DEBUG) ? net_base_log(NET_LOG_LEVEL_DEBUG, __FILE__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define NET_HEX_DUMP(data, length)  (NET_LOG_ON(NET_LOG_LEVEL_DEBUG) ? net_base_hex((const unsigned char *)data, (size_t)length) : (void)0)
 #else
 #define NET_LOGD(fmt, ...) ((void)0)
+#define NET_HEX_DUMP(data, length)  ((void)0)
 #endif
 
 #if NET_LOG_LEVEL <= NET_LOG_LEVEL_INFO
-#define NET_LOGI(fmt, ...)  net_base_log(NET_LOG_LEVEL_INFO, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#define NET_LOGI(fmt, ...)  (NET_LOG_ON(NET_LOG_LEVEL_INFO) ? net_base_log(NET_LOG_LEVEL_INFO, __FILE__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #else
 #define NET_LOGI(fmt, ...)  ((void)0)
 #endif
 
 #if NET_LOG_LEVEL <= NET_LOG_LEVEL_WARNING
-#define NET_LOGW(fmt, ...) net_base_log(NET_LOG_LEVEL_WARNING, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#define NET_LOGW(fmt, ...) (NET_LOG_ON(NET_LOG_LEVEL_WARNING) ? net_base_log(NET_LOG_LEVEL_WARNING, __FILE__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #else
 #define NET_LOGW(fmt, ...) ((void)0)
 #endif
 
-#define NET_HEX_DUMP(data, length)  net_base_hex((const unsigned char *)data, (size_t)length)
-
 // ERROR总是打印
 #define NET_LOGE(fmt, ...) net_base_log(NET_LOG_LEVEL_ERROR, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
 
-// 创建任务
+// 调用点限速：每个调用点每个窗口最多输出NET_LOG_RATELIMIT_BURST条
+#define NET_LOG_RATELIMIT_INTERVAL_MS   1000
+#define NET_LOG_RATELIMIT_BURST         10
+
+typedef struct {
+    uint32_t window_start;
+    uint32_t count;
+    uint32_t suppressed;
+    uint8_t initialized;
+} net_log_ratelimit_t;
+
+int net_log_ratelimit(net_log_ratelimit_t *rl);
+
+#define NET_LOG_RATELIMITED(LOG, fmt, ...) do { \
+        static net_log_ratelimit_t _net_rl; \
+        if (net_log_ratelimit(&_net_rl)) { \
+            LOG(fmt, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+// 任务
+//
+// 任务在固定数量的工作线程上执行，每个线程一个队列，空闲线程从其他队列窃取。
+// 第一次提交时按在线CPU数自动启动，也可以先调用net_task_pool_init指定线程数与绑核。
+// 任务应尽快返回；需要长期运行的循环请自己创建线程。
 
 #define NET_USE_ASYNC_TASK    1
+#define NET_TASK_WORKER_MAX   64
+#define NET_TASK_QUEUE_DEPTH  1024  // 每个工作线程的队列深度，2的幂
 
+// 启动任务池：worker_nr为0时取在线CPU数；cpus[i]为第i个线程的NET_CPU(n)，可为NULL
+int net_task_pool_init(uint32_t worker_nr, const int *cpus);
+// 执行完队列中的任务后停止工作线程，之后提交会重新启动
+void net_task_pool_shutdown(void);
+// 提交一次性任务，返回0已入队；队列全满时工作线程中直接执行，其他线程返回-1
+int net_task_submit(void (*fn)(void *), void *arg);
 
+// 创建可重复提交的任务句柄
 void *net_create_task(void (*start_routine)(void *), void *arg);
-
+// 提交执行一次，已在队列中或正在运行时返回-1
 int net_task_start(void *task);
-
+// 还在队列中的任务取消，正在运行的等待返回，然后释放句柄；不能在任务自身中调用
 int net_task_delete(void *task);
 
+// 计数信号量（初值1），无竞争时只有一次原子操作，等待时在futex上睡眠
 void *net_create_sem(void);
 int net_sem_wait(void *sem);
 int net_sem_post(void *sem);
 int net_sem_destroy(void *sem);
 
-#define NET_MTU_MAX 1500 // 假设最大传输单元为1500字节
+#define NET_MTU_MAX 1500 // 默认最大传输单元
+#define NET_MTU_JUMBO 9000 // 巨型帧
+#define NET_ETH_HLEN_MAX 22 // 以太网头+VLAN标签+FCS
+#define NET_BURST_MAX 64 // 批量收发单次系统调用最多处理的帧数
+
+// 传输后端
+#define NET_MODE_NONE   0x00  // 未指定，等同于NET_MODE_TCPIP
+#define NET_MODE_ETH    0x01  // 真实以太网硬件（Linux AF_PACKET + TPACKET_V3接收环）
+#define NET_MODE_TCPIP  0x02  // TCP/IP模拟链路
+#define NET_MODE_SHM    0x03  // 同一主机上的进程间共享内存链路（Linux）
+
+// 线程绑核：0表示不绑定，绑定到CPU n时填NET_CPU(n)
+#define NET_CPU_NONE    0
+#define NET_CPU(n)      ((n) + 1)
 
 
 
@@ -64,6 +130,8 @@ typedef enum {
     NET_MSG_TYPE_NONE = 0,
     NET_MSG_TYPE_RX_PACKET,
     NET_MSG_TYPE_TX_PACKET,
+    NET_MSG_TYPE_RX_OVERLOAD,   // 接收占用超过高水位，data为NULL，length为占用百分比
+    NET_MSG_TYPE_RX_RECOVER,    // 接收占用回落到低水位以下
     NET_MSG_TYPE_MAX
 }NET_MSG_TYPE;
 
@@ -71,38 +139,212 @@ typedef void (*net_dev_callback_t)(NET_MSG_TYPE msg_type, void *userdata, uint8_
 
 typedef struct net_device_ops
 {
-    void (*tx_callback)(uint8_t *buffer, size_t length); // 发送完成
+    void (*tx_callback)(uint8_t *buffer, size_t length); // 发送完成，net_send_zerocpy的缓冲区归还给调用者
     void (*rx_callback)(uint8_t *buffer, size_t length); // 接收完成
+    // 批量接收回调（rx_deliver为INLINE/DEFERRED时必须设置）：默认队列0的帧按批交付，
+    // 每次1~NET_RX_CALLBACK_BATCH帧，缓冲区所有权交给回调，用完net_packet_free（GRO链用net_packet_free_chain）
+    void (*rx_burst)(void *userdata, uint8_t **buffers, const size_t *lengths, int count);
 } net_device_ops_t;
 
+// 报文内存池大小等级，例如 {128, 1024}, {2048, 512}, {9216, 64}
+#define NET_POOL_CLASS_MAX 4
+#define NET_RX_QUEUE_MAX   8   // 接收队列数上限，见net_classify.h
+
+typedef struct {
+    uint32_t size;          // 块可用大小
+    uint32_t count;         // 块数
+} net_pool_class_t;
+
+// 校验和选项（net_device_config_t.csum_flags）
+#define NET_CSUM_TX_FCS     0x01    // 模拟链路上发送时在帧尾附加FCS
+#define NET_CSUM_RX_FCS     0x02    // 接收线程校验并去掉帧尾FCS，错误帧丢弃
+#define NET_CSUM_RX_L4      0x04    // 接收线程校验IPv4/UDP/TCP校验和，错误帧丢弃
+
+// 接收过载策略（net_device_config_t.rx_policy）
+// 占用取内存池与各接收队列占用百分比的最大值，超过高水位进入过载，回落到低水位以下恢复
+#define NET_RX_POLICY_BLOCK     0   // 过载时停止接收，等使用者释放缓冲区（TCP链路由窗口反压对端）
+#define NET_RX_POLICY_DROP_NEW  1   // 过载时丢弃新到的帧，继续接收
+#define NET_RX_POLICY_DROP_OLD  2   // 过载时接收接口先丢弃队列中最旧的帧，只交付较新的
+
+// 默认队列0的交付方式（net_device_config_t.rx_deliver）
+#define NET_RX_DELIVER_POLL     0   // 使用者调用net_receive_xxx轮询取帧
+#define NET_RX_DELIVER_INLINE   1   // 接收线程每攒满一批或一批接收结束时调用ops.rx_burst，
+                                    // 延迟最低，回调耗时直接占用接收线程
+#define NET_RX_DELIVER_DEFERRED 2   // 独立投递线程调用ops.rx_burst，接收线程不执行用户代码，
+                                    // 回调跟不上时按rx_policy处理
+#define NET_RX_CALLBACK_BATCH   32  // ops.rx_burst单次交付帧数上限
+
+// 设备配置，未填写（为0）的项使用默认值
+typedef struct {
+    net_pool_class_t pool[NET_POOL_CLASS_MAX]; // 大小等级，count为0的项忽略
+    uint32_t rx_queue_depth;    // 接收环深度
+    uint32_t mtu;               // 最大等级需能容纳 mtu + NET_ETH_HLEN_MAX
+    bool hugepages;             // 内存池使用大页，大页不可用时退回普通页
+    uint32_t csum_flags;        // NET_CSUM_xxx，默认不校验
+    uint32_t rx_queue_nr;       // 接收队列数（含默认队列0），供分类规则与RSS使用，默认1
+    uint32_t rx_rss_queues;     // RSS：本该进队列0的帧按对称流哈希分散到队列0..N-1，同一条流保持顺序；
+                                // 不超过rx_queue_nr，0或1不分散
+    uint8_t rx_policy;          // NET_RX_POLICY_xxx，默认BLOCK
+    uint8_t rx_high_pct;        // 过载高水位（百分比），默认90
+    uint8_t rx_low_pct;         // 恢复低水位（百分比），默认70
+    uint32_t tx_flush_us;       // TCP链路发送合并：不足一批的帧最多等待的微秒数，默认0（不等待）
+    bool rx_kernel_ts;          // TCP链路帧元数据用SO_TIMESTAMPING内核接收时间，默认用接收线程读到数据的时间
+                                // （开启后内核给本机每个报文打时间戳，有额外开销）
+    uint8_t rx_deliver;         // NET_RX_DELIVER_xxx，默认POLL；非POLL时队列0由设备消费，不要再对它调用net_receive_xxx
+    int rx_deliver_cpu;         // DEFERRED投递线程绑定的CPU，见NET_CPU()
+    bool io_uring;              // ETH模式使用io_uring后端（多发recv直接收进内存池块，需要Linux 6.0+），
+                                // 不可用时自动退回TPACKET_V3后端
+    uint8_t rx_gro_segs;        // GRO：一批之内同一条流的连续帧串成一条链（最多N帧）整条入队，
+                                // 零拷贝接口返回链头，见net_packet_next；net_receive_pool仍每次复制一帧；0或1关闭
+} net_device_config_t;
+
+struct net_backend;
+struct net_pool;
+struct net_ring;
+struct net_capture;
+struct net_stats;
+struct net_classifier;
+struct net_backpressure;
+struct net_dispatch;
+struct net_gro;
+
 typedef struct 
 {
+    uint8_t mode;           // 传输后端 NET_MODE_xxx
+    const char *ifname;     // NET_MODE_ETH 绑定的网卡名，如"eth0"
+    const char *remote;     // NET_MODE_TCPIP 对端地址"ip:port"，NULL为127.0.0.1:1069；
+                            // NET_MODE_SHM 链路名称，两端相同，NULL为"net-shm"
+    int rx_cpu;             // 接收线程绑定的CPU，见NET_CPU()
+    const net_device_config_t *config; // 设备配置，NULL使用默认配置
     net_device_ops_t ops;   // 设备操作函数指针
     void *userdata;         // 用户数据指针
-    mempool_t *mempool;     // 内存池指针
-    mempool_queue_t *mempool_queue; // 内存池队列指针
+    struct net_pool *pool;  // 报文内存池
+    struct net_ring *rx_ring; // 接收描述符环（接收线程单生产者，使用者单消费者）
 
     net_dev_callback_t callback; // 回调函数
 
+    const struct net_backend *backend; // 传输后端（内部使用）
+    void *backend_priv;                // 后端私有数据（内部使用）
+    struct net_capture *capture;       // 抓包状态（内部使用）
+    struct net_stats *stats;           // 统计计数（内部使用）
+    struct net_classifier *classifier; // 接收分类与附加接收队列（内部使用）
+    struct net_backpressure *backpressure; // 接收过载状态（内部使用）
+    struct net_dispatch *dispatch;     // 批量接收回调（内部使用）
+    struct net_gro *gro;               // 软件GRO，未开启时为NULL（内部使用）
 } net_device_t;
 
 uint32_t net_get_time_ms(void);
 
-// 发送以太网数据
+// 分散发送的一段数据
+typedef struct {
+    const void *base;
+    size_t length;
+} net_iovec_t;
+
+#define NET_IOV_MAX     16  // net_sendv单帧最多段数
+
+// 发送以太网数据（返回时数据已被复制，调用者可立即复用data）
+// TCP链路由发送线程异步写出：返回0表示已入队，断线期间帧排队等待重连
 int net_send(net_device_t *dev, uint8_t *data, size_t length);
+// 分散发送一帧：各段按顺序组成一帧（如lwIP的pbuf链），调用者不必先拼接；
+// 返回时数据已被复制或已交给内核，各段可立即复用。返回0成功
+int net_sendv(net_device_t *dev, const net_iovec_t *iov, int count);
+// 零拷贝发送：buffer必须来自net_packet_alloc，调用后所有权交给设备。
+// 发送完成（无论成功与否）时通过ops.tx_callback归还，由调用者net_packet_free或复用；
+// 未设置tx_callback时设备自动释放。返回0已提交，-1失败（缓冲区同样已归还）
+int net_send_zerocpy(net_device_t *dev, uint8_t *buffer, size_t length);
 // 接收以太网数据
 int net_receive_pool(net_device_t *dev, uint8_t *data, size_t length);
 
+// 接收类接口（net_receive_xxx / net_check_packet_input）同一设备只能在一个线程中调用
+
+// 检查是否有数据到达
+int net_check_packet_input(net_device_t *dev);
+// 等待数据到达：先短暂自旋再挂起，timeout_ms<0一直等待
+// 返回 1：有数据；0：超时
+int net_receive_wait(net_device_t *dev, int timeout_ms);
+
 // 零拷贝接收数据
 uint8_t *net_receive_zerocpy(net_device_t *dev);
 uint8_t *net_receive_zerocpy_with_length(net_device_t *dev, size_t *length);
 
+// 批量发送，返回成功发送（TCP链路为入队）的帧数，失败返回-1
+int net_send_burst(net_device_t *dev, uint8_t **data, const size_t *lengths, int count);
+// 批量零拷贝接收，最多取max帧，返回取到的帧数；每个缓冲区用net_packet_free释放（GRO链用net_packet_free_chain）
+int net_receive_burst(net_device_t *dev, uint8_t **buffers, size_t *lengths, int max);
+
 // 释放接收的数据
 uint8_t *net_packet_alloc(net_device_t *dev, size_t length);
 void net_packet_free(net_device_t *dev, uint8_t *buffer);
+// 释放接收到的GRO链（链头及net_packet_next串起的各帧），未合并的帧等同net_packet_free
+void net_packet_free_chain(net_device_t *dev, uint8_t *buffer);
 
 // 初始化网络设备
 int net_init(net_device_t *dev);
+// 关闭网络设备，释放后端与内存池
+void net_deinit(net_device_t *dev);
+
+// 开始抓包，收发的帧写入pcapng文件path（纳秒时间戳，带收发方向）
+int net_capture_start(net_device_t *dev, const char *path);
+// 停止抓包并刷出剩余数据
+void net_capture_stop(net_device_t *dev);
+
+// ======================================================================
+// 统计
+// ======================================================================
+
+// 对数-线性直方图（HDR风格）：每个2的幂区间再分16格，相对误差不超过1/16
+#define NET_HIST_SUB_BITS   4
+#define NET_HIST_MAX_BITS   40      // 超过2^41ns的值计入最后一格
+#define NET_HIST_BUCKETS    ((NET_HIST_MAX_BITS - NET_HIST_SUB_BITS + 2) << NET_HIST_SUB_BITS)
+
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[NET_HIST_BUCKETS];
+} net_hist_t;
+
+typedef struct {
+    // 接收
+    uint64_t rx_packets;            // 放入接收环的帧
+    uint64_t rx_bytes;
+    uint64_t rx_delivered;          // 已被使用者取走的帧（GRO链算一帧）
+    uint64_t rx_gro_merged;         // GRO接到链上、不单独入队的帧
+    uint64_t rx_drop_oversize;      // 帧超过缓冲区大小而丢弃
+    uint64_t rx_drop_desync;        // 流失步断开连接的次数
+    uint64_t rx_drop_kernel;        // 内核接收环满而丢弃（ETH模式）
+    uint64_t rx_drop_fcs;           // FCS错误而丢弃
+    uint64_t rx_drop_csum;          // IP/UDP/TCP校验和错误而丢弃
+    uint64_t rx_drop_filter;        // 分类规则丢弃
+    uint64_t rx_diverted;           // 分类规则回调直接处理
+    uint64_t rx_drop_overload;      // 过载策略丢弃（DROP_NEW丢新帧，DROP_OLD丢队列中的旧帧）
+    uint64_t rx_overload_events;    // 进入过载状态的次数
+    uint64_t rx_stall_nobuf;        // 内存池耗尽导致接收暂停的次数
+    uint64_t rx_stall_ring_full;    // 接收环满导致接收暂停的次数
+
+    // 发送
+    uint64_t tx_packets;
+    uint64_t tx_bytes;
+    uint64_t tx_errors;
+    uint64_t tx_drop_nobuf;         // 内存池耗尽而未发送
+
+    // 资源
+    uint32_t pool_capacity;
+    uint32_t pool_in_use;
+    uint32_t pool_free_min;         // 内存池空闲块低水位
+    uint32_t rx_ring_depth;
+    uint32_t rx_ring_depth_max;     // 接收环深度高水位
+
+    // 延迟(ns)
+    net_hist_t rx_latency;          // 入队到被取走
+    net_hist_t tx_latency;          // 一次后端发送调用耗时
+} net_device_stats_t;
+
+// 读取统计快照（计数器各自原子读取，彼此之间不保证是同一时刻）
+int net_get_stats(net_device_t *dev, net_device_stats_t *stats);
+// 直方图分位数，percentile取0~100，返回所在格的上界
+uint64_t net_hist_percentile(const net_hist_t *hist, double percentile);
 
 
 
@@ -0,0 +1,157 @@
+#ifndef NET_PACKET_H
+#define NET_PACKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "net_device.h"
+
+// ======================================================================
+// 带头部预留的报文缓冲区
+//
+// 描述符放在内存池块的开头，后面是缓冲区：
+//
+//  +-----------+----------+====================+----------+
+//  | net_pkt_t | headroom |  帧 (data, len)     | tailroom |
+//  +-----------+----------+====================+----------+
+//
+// 加/去头部只移动data指针，封装时不用搬动整帧。
+// ======================================================================
+
+#ifndef NET_PKT_HEADROOM
+#define NET_PKT_HEADROOM    64  // 默认预留：外层以太网/IP/UDP/VXLAN头加VLAN标签
+#endif
+
+#define NET_ETH_ALEN        6
+#define NET_ETH_HLEN        14
+#define NET_VLAN_HLEN       4
+
+#define NET_ETHERTYPE_IPV4  0x0800
+#define NET_ETHERTYPE_ARP   0x0806
+#define NET_ETHERTYPE_VLAN  0x8100
+#define NET_ETHERTYPE_IPV6  0x86DD
+#define NET_ETHERTYPE_QINQ  0x88A8
+
+typedef struct net_pkt {
+    uint8_t *data;      // 帧起始
+    uint32_t len;       // 帧长度
+    uint32_t size;      // buf大小
+    uint8_t buf[];
+} net_pkt_t;
+
+// 申请能容纳length字节帧的缓冲区，data位于NET_PKT_HEADROOM处，len为0
+net_pkt_t *net_pkt_alloc(net_device_t *dev, size_t length);
+void net_pkt_free(net_device_t *dev, net_pkt_t *pkt);
+// 由帧数据指针找回描述符（如tx_callback中归还的指针）
+net_pkt_t *net_pkt_from_data(net_device_t *dev, uint8_t *data);
+
+// 零拷贝发送，完成后tx_callback收到的是pkt->data
+static inline int net_pkt_send(net_device_t *dev, net_pkt_t *pkt) {
+    return net_send_zerocpy(dev, pkt->data, pkt->len);
+}
+
+static inline size_t net_pkt_headroom(const net_pkt_t *pkt) {
+    return (size_t)(pkt->data - pkt->buf);
+}
+
+static inline size_t net_pkt_tailroom(const net_pkt_t *pkt) {
+    return pkt->size - net_pkt_headroom(pkt) - pkt->len;
+}
+
+// 在帧前加n字节，返回新的帧起始；头部空间不足返回NULL
+static inline uint8_t *net_pkt_push(net_pkt_t *pkt, size_t n) {
+    if (n > net_pkt_headroom(pkt)) {
+        return NULL;
+    }
+    pkt->data -= n;
+    pkt->len += (uint32_t)n;
+    return pkt->data;
+}
+
+// 去掉帧前n字节，返回新的帧起始
+static inline uint8_t *net_pkt_pull(net_pkt_t *pkt, size_t n) {
+    if (n > pkt->len) {
+        return NULL;
+    }
+    pkt->data += n;
+    pkt->len -= (uint32_t)n;
+    return pkt->data;
+}
+
+// 在帧尾追加n字节，返回追加区域
+static inline uint8_t *net_pkt_put(net_pkt_t *pkt, size_t n) {
+    if (n > net_pkt_tailroom(pkt)) {
+        return NULL;
+    }
+    uint8_t *tail = pkt->data + pkt->len;
+    pkt->len += (uint32_t)n;
+    return tail;
+}
+
+// 把帧截短到len字节
+static inline void net_pkt_trim(net_pkt_t *pkt, size_t len) {
+    if (len < pkt->len) {
+        pkt->len = (uint32_t)len;
+    }
+}
+
+// ---------------------------------------------------------------- 接收元数据
+//
+// 接收接口返回的每个缓冲区前面紧挨着一个缓存行的元数据，由接收线程在入队前填好：
+// 内存池块、AF_PACKET接收环中的帧和共享内存槽都预留了这一行。
+// 用net_packet_meta直接按地址找到，不查表；net_packet_free之后失效。
+//
+// 开启GRO（net_device_config_t.rx_gro_segs）时接收接口返回的是链头：同一条流的
+// 后续帧用gro_next串在后面，每一段有自己的元数据，返回的长度只是链头这一帧的长度。
+// 用net_packet_next遍历，net_packet_free_chain整条释放（或逐段net_packet_free）。
+
+#define NET_PKT_META_SIZE   64
+
+#define NET_META_VLAN       0x01    // vlan_tci有效
+#define NET_META_HASH       0x02    // flow_hash有效
+#define NET_META_TS_KERNEL  0x04    // rx_ns来自内核时间戳，否则是接收线程取到帧的时间
+
+typedef struct net_pkt_meta {
+    uint64_t rx_ns;         // 接收时间（net_time_ns时钟）
+    uint64_t queue_ns;      // 放入接收队列的时间
+    uint32_t length;        // 帧长度
+    uint32_t flow_hash;     // 流哈希：开启RSS或GRO时为net_flow_hash，否则优先用内核/网卡提供的哈希
+    uint16_t vlan_tci;      // 最外层VLAN TCI（内核剥离的标签或帧内标签）
+    uint16_t ingress_port;  // 接收端口：ETH为网卡ifindex，其他模式为0
+    uint8_t queue;          // 分类后的接收队列
+    uint8_t flags;          // NET_META_xxx
+    uint16_t gro_segs;      // GRO链的帧数（只在链头有效），未合并的帧为1
+    uint8_t *gro_next;      // GRO链中的下一帧，NULL为链尾
+    uint64_t user[3];       // 留给使用者，库不读写
+} __attribute__((aligned(NET_PKT_META_SIZE))) net_pkt_meta_t;
+
+// 接收缓冲区的元数据：缓冲区起始之前的最后一个完整缓存行
+static inline net_pkt_meta_t *net_packet_meta(const uint8_t *buffer) {
+    return (net_pkt_meta_t *)(((uintptr_t)buffer - NET_PKT_META_SIZE) & ~(uintptr_t)(NET_PKT_META_SIZE - 1));
+}
+
+// GRO链中的下一帧，长度见其元数据的length；未开启GRO时总是NULL
+static inline uint8_t *net_packet_next(const uint8_t *buffer) {
+    return net_packet_meta(buffer)->gro_next;
+}
+
+// IPv4/IPv6的TCP/UDP按五元组、其他IP报文按地址对计算的流哈希，非IP帧返回0
+// 对称：交换源/目的地址与端口结果不变，连接的两个方向哈希相同；与网卡的RSS哈希值不同
+uint32_t net_flow_hash(const uint8_t *frame, size_t length);
+
+// ---------------------------------------------------------------- 以太网
+
+// 在平坦缓冲区开头写以太网头，返回写入字节数
+size_t net_eth_build_header(uint8_t *frame, const uint8_t dst[NET_ETH_ALEN],
+                            const uint8_t src[NET_ETH_ALEN], uint16_t ethertype);
+
+// 在帧前加以太网头
+int net_pkt_push_eth(net_pkt_t *pkt, const uint8_t dst[NET_ETH_ALEN],
+                     const uint8_t src[NET_ETH_ALEN], uint16_t ethertype);
+// 在MAC地址后插入802.1Q标签（tpid为NET_ETHERTYPE_VLAN或NET_ETHERTYPE_QINQ），只搬动12字节地址
+int net_pkt_push_vlan(net_pkt_t *pkt, uint16_t tpid, uint8_t pcp, uint16_t vid);
+// 去掉最外层VLAN标签，tci可为NULL；没有标签返回-1
+int net_pkt_pop_vlan(net_pkt_t *pkt, uint16_t *tci);
+// 跳过VLAN标签后的上层协议类型，帧不完整返回0
+uint16_t net_eth_get_type(const uint8_t *frame, size_t length);
+
+#endif
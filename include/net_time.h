@@ -0,0 +1,64 @@
+#ifndef NET_TIME_H
+#define NET_TIME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+// ======================================================================
+// 纳秒单调时钟
+//
+// x86-64上CPU声明不变TSC（CPUID 80000007H EDX[8]）时，net_time_ns读rdtsc，
+// 按对CLOCK_MONOTONIC校准出的乘数换算，不进内核也不走vDSO；
+// 否则（或编译时定义NET_TIME_NO_TSC）退回clock_gettime(CLOCK_MONOTONIC)。
+// 两种方式的原点都是CLOCK_MONOTONIC，校准前后读到的时间可以直接相减。
+//
+// 校准在第一次net_init时进行（约10ms），也可以提前调用net_time_init。
+// ======================================================================
+
+#if defined(__x86_64__) && !defined(NET_TIME_NO_TSC)
+#include <x86intrin.h>
+#define NET_TIME_TSC    1
+#else
+#define NET_TIME_TSC    0
+#endif
+
+typedef struct {
+    uint64_t tsc_base;          // 校准结束时的TSC
+    uint64_t ns_base;           // 同一时刻的CLOCK_MONOTONIC
+    uint64_t mult;              // 每个TSC周期的纳秒数，32位小数
+    bool tsc;                   // 校准完成后置位
+} net_clock_t;
+
+extern net_clock_t net_clock;
+
+// 校准时钟，可重复调用，只做一次
+void net_time_init(void);
+// 当前使用的时钟源："tsc"或"monotonic"
+const char *net_time_source(void);
+
+static inline uint64_t net_time_ns_monotonic(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t net_time_ns(void) {
+#if NET_TIME_TSC
+    if (__atomic_load_n(&net_clock.tsc, __ATOMIC_ACQUIRE)) {
+        uint64_t delta = __rdtsc() - net_clock.tsc_base;
+        return net_clock.ns_base + (uint64_t)(((unsigned __int128)delta * net_clock.mult) >> 32);
+    }
+#endif
+    return net_time_ns_monotonic();
+}
+
+// CLOCK_REALTIME时间戳（如SO_TIMESTAMPING、TPACKET帧头）换算到net_time_ns需要减去的偏移，
+// 每批接收取一次即可
+static inline int64_t net_time_realtime_offset(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec - net_time_ns());
+}
+
+#endif
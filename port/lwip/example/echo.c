@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include "lwip/init.h"
+#include "lwip/sys.h"
+#include "lwip/timeouts.h"
+#include "lwip/netif.h"
+#include "lwip/ip4_addr.h"
+#include "lwip/tcp.h"
+#include "netif/ethernet.h"
+#include "net_device.h"
+#include "netflex_if.h"
+
+// lwIP TCP回显服务（端口7）跑在net_device上：
+//   net_lwip_echo eth eth0 192.168.1.200
+//   net_lwip_echo tcp 127.0.0.1:1069 10.0.0.2
+//   net_lwip_echo shm net-shm 10.0.0.2
+// 可以ping该地址，或nc <ip> 7
+
+#define ECHO_PORT       7
+#define ECHO_WAIT_MS    10      // 无帧时最多等待的时间，之后处理lwIP定时器
+
+static volatile sig_atomic_t running = 1;
+
+// NO_SYS时lwIP定时器的时钟
+u32_t sys_now(void) {
+    return net_get_time_ms();
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+// 收到的数据原样写回，发送缓冲区不够时返回ERR_MEM，lwIP稍后重新交付
+static err_t echo_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+    (void)arg;
+
+    if (!p) {
+        tcp_close(pcb);
+        return ERR_OK;
+    }
+    if (err != ERR_OK) {
+        pbuf_free(p);
+        return err;
+    }
+    if (tcp_sndbuf(pcb) < p->tot_len) {
+        return ERR_MEM;
+    }
+
+    for (struct pbuf *q = p; q; q = q->next) {
+        tcp_write(pcb, q->payload, q->len, TCP_WRITE_FLAG_COPY | (q->next ? TCP_WRITE_FLAG_MORE : 0));
+    }
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+    tcp_output(pcb);
+    return ERR_OK;
+}
+
+static err_t echo_accept(void *arg, struct tcp_pcb *pcb, err_t err) {
+    (void)arg;
+
+    if (err != ERR_OK || !pcb) {
+        return ERR_VAL;
+    }
+    tcp_recv(pcb, echo_recv);
+    return ERR_OK;
+}
+
+static int echo_listen(void) {
+    struct tcp_pcb *pcb = tcp_new();
+
+    if (!pcb || tcp_bind(pcb, IP_ADDR_ANY, ECHO_PORT) != ERR_OK) {
+        fprintf(stderr, "Failed to bind echo port %d\n", ECHO_PORT);
+        return -1;
+    }
+    pcb = tcp_listen(pcb);
+    if (!pcb) {
+        return -1;
+    }
+    tcp_accept(pcb, echo_accept);
+    return 0;
+}
+
+static int parse_mode(const char *name, uint8_t *mode) {
+    if (strcmp(name, "eth") == 0) {
+        *mode = NET_MODE_ETH;
+    } else if (strcmp(name, "tcp") == 0) {
+        *mode = NET_MODE_TCPIP;
+    } else if (strcmp(name, "shm") == 0) {
+        *mode = NET_MODE_SHM;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    net_device_t dev = {0};
+    netflex_if_t nif = { .dev = &dev, .hwaddr = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 } };
+    struct netif netif;
+    ip4_addr_t ip, mask, gw;
+
+    if (argc < 4 || parse_mode(argv[1], &dev.mode) != 0 || !ip4addr_aton(argv[3], &ip)) {
+        fprintf(stderr, "usage: %s <eth|tcp|shm> <ifname|ip:port|name> <ip> [netmask] [gateway]\n", argv[0]);
+        return 1;
+    }
+    if (argc < 5 || !ip4addr_aton(argv[4], &mask)) {
+        IP4_ADDR(&mask, 255, 255, 255, 0);
+    }
+    if (argc < 6 || !ip4addr_aton(argv[5], &gw)) {
+        ip4_addr_set_zero(&gw);
+    }
+    if (dev.mode == NET_MODE_ETH) {
+        dev.ifname = argv[2];
+    } else {
+        dev.remote = argv[2];
+    }
+
+    net_log_set_level(NET_LOG_LEVEL_WARNING);
+    if (net_init(&dev) != 0) {
+        fprintf(stderr, "Failed to initialize network device\n");
+        return 1;
+    }
+
+    lwip_init();
+    if (!netif_add(&netif, &ip, &mask, &gw, &nif, netflex_if_init, ethernet_input)) {
+        fprintf(stderr, "Failed to add lwIP netif\n");
+        net_deinit(&dev);
+        return 1;
+    }
+    netif_set_default(&netif);
+    netif_set_up(&netif);
+
+    if (echo_listen() != 0) {
+        net_deinit(&dev);
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    printf("Echo server on %s:%d\n", argv[3], ECHO_PORT);
+
+    while (running) {
+        if (net_receive_wait(&dev, ECHO_WAIT_MS) > 0) {
+            while (netflex_if_poll(&netif) > 0) {
+            }
+        }
+        sys_check_timeouts();
+    }
+
+    netif_remove(&netif);
+    net_deinit(&dev);
+    return 0;
+}
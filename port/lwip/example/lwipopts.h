@@ -0,0 +1,36 @@
+#ifndef LWIPOPTS_H
+#define LWIPOPTS_H
+
+// net_lwip_echo示例的lwIP配置：NO_SYS，主循环轮询设备
+
+#define NO_SYS                      1
+#define SYS_LIGHTWEIGHT_PROT        0
+#define LWIP_NETCONN                0
+#define LWIP_SOCKET                 0
+
+#define LWIP_ETHERNET               1
+#define LWIP_ARP                    1
+#define LWIP_IPV4                   1
+#define LWIP_ICMP                   1
+#define LWIP_UDP                    1
+#define LWIP_TCP                    1
+
+// 接收缓冲区以pbuf_custom交给lwIP，帧头前不留填充
+#define LWIP_SUPPORT_CUSTOM_PBUF    1
+#define ETH_PAD_SIZE                0
+
+#define MEM_ALIGNMENT               8
+#define MEM_SIZE                    (256 * 1024)
+#define MEMP_NUM_PBUF               64
+#define MEMP_NUM_TCP_PCB            16
+#define PBUF_POOL_SIZE              64
+
+#define TCP_MSS                     1460
+#define TCP_WND                     (16 * TCP_MSS)
+#define TCP_SND_BUF                 (16 * TCP_MSS)
+#define TCP_SND_QUEUELEN            (4 * TCP_SND_BUF / TCP_MSS)
+#define MEMP_NUM_TCP_SEG            TCP_SND_QUEUELEN
+
+#define LWIP_STATS                  0
+
+#endif
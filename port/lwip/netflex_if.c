@@ -0,0 +1,151 @@
+#include <stdint.h>
+#include <string.h>
+#include "lwip/opt.h"
+#include "lwip/memp.h"
+#include "lwip/pbuf.h"
+#include "lwip/netif.h"
+#include "lwip/stats.h"
+#include "lwip/snmp.h"
+#include "lwip/etharp.h"
+#include "netif/ethernet.h"
+#include "net_device.h"
+#include "net_packet.h"
+#include "netflex_if.h"
+
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "netflex_if needs LWIP_SUPPORT_CUSTOM_PBUF=1"
+#endif
+#if ETH_PAD_SIZE
+#error "netflex_if needs ETH_PAD_SIZE=0: frames are handed to lwIP in place"
+#endif
+
+// 包装设备接收缓冲区的pbuf，pc必须在最前面：lwIP用struct pbuf*回调释放函数
+typedef struct {
+    struct pbuf_custom pc;
+    net_device_t *dev;
+    uint8_t *buffer;
+} netflex_rx_pbuf_t;
+
+LWIP_MEMPOOL_DECLARE(NETFLEX_RX_PBUF, NETFLEX_IF_RX_PBUFS, sizeof(netflex_rx_pbuf_t), "netflex rx pbuf");
+
+static void netflex_rx_pbuf_free(struct pbuf *p) {
+    netflex_rx_pbuf_t *rx = (netflex_rx_pbuf_t *)p;
+
+    net_packet_free(rx->dev, rx->buffer);
+    LWIP_MEMPOOL_FREE(NETFLEX_RX_PBUF, rx);
+}
+
+// 一帧交给lwIP，之后由lwIP释放
+static void netflex_if_input(struct netif *netif, net_device_t *dev, uint8_t *buffer, size_t length) {
+    netflex_rx_pbuf_t *rx = (netflex_rx_pbuf_t *)LWIP_MEMPOOL_ALLOC(NETFLEX_RX_PBUF);
+
+    if (!rx || length > 0xFFFF) {
+        if (rx) {
+            LWIP_MEMPOOL_FREE(NETFLEX_RX_PBUF, rx);
+        }
+        net_packet_free(dev, buffer);
+        LINK_STATS_INC(link.memerr);
+        LINK_STATS_INC(link.drop);
+        return;
+    }
+
+    rx->dev = dev;
+    rx->buffer = buffer;
+    rx->pc.custom_free_function = netflex_rx_pbuf_free;
+    struct pbuf *p = pbuf_alloced_custom(PBUF_RAW, (u16_t)length, PBUF_REF, &rx->pc, buffer, (u16_t)length);
+
+    LINK_STATS_INC(link.recv);
+    MIB2_STATS_NETIF_ADD(netif, ifinoctets, length);
+    if (netif->input(p, netif) != ERR_OK) {
+        LINK_STATS_INC(link.drop);
+        pbuf_free(p);
+    }
+}
+
+int netflex_if_poll(struct netif *netif) {
+    netflex_if_t *nif = (netflex_if_t *)netif->state;
+    uint8_t *buffers[NETFLEX_IF_RX_BATCH];
+    size_t lengths[NETFLEX_IF_RX_BATCH];
+    int frames = 0;
+
+    int n = net_receive_burst(nif->dev, buffers, lengths, NETFLEX_IF_RX_BATCH);
+    for (int i = 0; i < n; i++) {
+        // GRO链上的帧逐个交付，先取下一帧：交给lwIP后缓冲区可能已被释放
+        uint8_t *buffer = buffers[i];
+        size_t length = lengths[i];
+
+        while (buffer) {
+            uint8_t *next = net_packet_next(buffer);
+            netflex_if_input(netif, nif->dev, buffer, length);
+            buffer = next;
+            length = buffer ? net_packet_meta(buffer)->length : 0;
+            frames++;
+        }
+    }
+    return frames;
+}
+
+err_t netflex_if_output(struct netif *netif, struct pbuf *p) {
+    netflex_if_t *nif = (netflex_if_t *)netif->state;
+    net_iovec_t iov[NET_IOV_MAX];
+    int count = 0;
+    int ret;
+
+    for (struct pbuf *q = p; q && count <= NET_IOV_MAX; q = q->next) {
+        if (q->len == 0) {
+            continue;
+        }
+        if (count < NET_IOV_MAX) {
+            iov[count].base = q->payload;
+            iov[count].length = q->len;
+        }
+        count++;
+    }
+
+    if (count <= NET_IOV_MAX) {
+        ret = net_sendv(nif->dev, iov, count);
+    } else {
+        // 段数超过NET_IOV_MAX（很少见）：由lwIP拼成一块再发
+        struct pbuf *flat = pbuf_clone(PBUF_RAW, PBUF_RAM, p);
+        if (!flat) {
+            LINK_STATS_INC(link.memerr);
+            LINK_STATS_INC(link.drop);
+            return ERR_MEM;
+        }
+        ret = net_send(nif->dev, (uint8_t *)flat->payload, flat->len);
+        pbuf_free(flat);
+    }
+
+    if (ret != 0) {
+        LINK_STATS_INC(link.err);
+        return ERR_IF;
+    }
+    LINK_STATS_INC(link.xmit);
+    MIB2_STATS_NETIF_ADD(netif, ifoutoctets, p->tot_len);
+    return ERR_OK;
+}
+
+err_t netflex_if_init(struct netif *netif) {
+    static bool pool_ready;
+    netflex_if_t *nif = (netflex_if_t *)netif->state;
+
+    if (!nif || !nif->dev || !nif->dev->pool) {
+        return ERR_ARG;
+    }
+    if (!pool_ready) {
+        LWIP_MEMPOOL_INIT(NETFLEX_RX_PBUF);
+        pool_ready = true;
+    }
+
+    netif->name[0] = 'n';
+    netif->name[1] = 'f';
+    netif->output = etharp_output;
+    netif->linkoutput = netflex_if_output;
+    netif->mtu = (u16_t)(nif->dev->config && nif->dev->config->mtu ? nif->dev->config->mtu : NET_MTU_MAX);
+    netif->hwaddr_len = ETH_HWADDR_LEN;
+    memcpy(netif->hwaddr, nif->hwaddr, ETH_HWADDR_LEN);
+    netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET | NETIF_FLAG_LINK_UP;
+    MIB2_INIT_NETIF(netif, snmp_ifType_ethernet_csmacd, 0);
+
+    return ERR_OK;
+}
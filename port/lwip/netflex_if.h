@@ -0,0 +1,45 @@
+#ifndef NETFLEX_IF_H
+#define NETFLEX_IF_H
+
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "net_device.h"
+
+// ======================================================================
+// lwIP网络接口适配
+//
+// 接收：net_receive_burst取到的缓冲区包装成pbuf_custom（PBUF_REF）直接交给
+//       netif->input，lwIP释放pbuf时归还给设备（net_packet_free），不复制；
+//       开启GRO时链上的每一帧各成一个pbuf
+// 发送：pbuf链逐段组成net_iovec_t交给net_sendv，不先拼成一块
+//
+// 接收的pbuf在lwIP内排队（如TCP乱序队列）期间一直占用设备的接收缓冲区，
+// 内存池与NETFLEX_IF_RX_PBUFS要按lwIP可能持有的帧数留余量。
+// 需要LWIP_SUPPORT_CUSTOM_PBUF=1、ETH_PAD_SIZE=0。
+// ======================================================================
+
+#ifndef NETFLEX_IF_RX_PBUFS
+#define NETFLEX_IF_RX_PBUFS     256     // 同时交给lwIP的接收pbuf上限
+#endif
+
+#ifndef NETFLEX_IF_RX_BATCH
+#define NETFLEX_IF_RX_BATCH     32      // netflex_if_poll单次从设备取的帧数
+#endif
+
+typedef struct {
+    net_device_t *dev;          // 已net_init的设备
+    uint8_t hwaddr[NETIF_MAX_HWADDR_LEN];
+} netflex_if_t;
+
+// netif_add的init回调，state为netflex_if_t*：
+// netif_add(&netif, &ip, &mask, &gw, &nif, netflex_if_init, ethernet_input)
+err_t netflex_if_init(struct netif *netif);
+
+// 发送一帧（netif->linkoutput）
+err_t netflex_if_output(struct netif *netif, struct pbuf *p);
+
+// 取一批帧交给netif->input，返回交给lwIP的帧数。NO_SYS时在主循环调用，
+// 否则在tcpip线程中调用（如tcpip_callback），不能与lwIP并发
+int netflex_if_poll(struct netif *netif);
+
+#endif
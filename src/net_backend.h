@@ -0,0 +1,115 @@
+#ifndef NET_BACKEND_H
+#define NET_BACKEND_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+#include "net_device.h"
+#include "net_packet.h"
+
+// ======================================================================
+// 传输后端抽象（内部使用）
+// 每个后端负责建立链路、发送帧，并把收到的帧放入 dev->rx_ring
+// 后端接收线程是 dev->rx_ring 唯一的生产者，一批入队后调用 net_ring_notify
+// ======================================================================
+
+// 默认配置：小包与标准MTU两个等级
+#define NET_RX_QUEUE_DEPTH      256     // 接收队列深度
+#define NET_POOL_SMALL_SIZE     128
+#define NET_POOL_SMALL_NUM      256
+#define NET_POOL_LARGE_SIZE     2048
+#define NET_POOL_LARGE_NUM      256
+
+typedef struct net_backend {
+    const char *name;
+
+    // 建立链路并启动接收
+    int (*open)(net_device_t *dev);
+    void (*close)(net_device_t *dev);
+
+    // 发送一帧，返回0成功
+    int (*send)(net_device_t *dev, const uint8_t *data, size_t length);
+    // 批量发送，返回成功发送的帧数，一帧都未发出返回-1
+    int (*send_burst)(net_device_t *dev, uint8_t **data, const size_t *lengths, int count);
+    // 分散发送一帧（1~NET_IOV_MAX段，length为总长），返回0成功，可为NULL
+    int (*sendv)(net_device_t *dev, const net_iovec_t *iov, int count, size_t length);
+    // 零拷贝发送，完成后必须且只调用一次net_tx_complete（提交失败时也一样），可为NULL
+    int (*send_zerocpy)(net_device_t *dev, uint8_t *buffer, size_t length);
+
+    // 缓冲区不属于内存池时（如直接指向内核接收环）由后端回收
+    // 返回0表示已由后端回收，非0表示不是后端的缓冲区
+    int (*buffer_free)(net_device_t *dev, uint8_t *buffer);
+
+    // 消费端取走报文或释放了缓冲区，接收线程若在等待资源则唤醒
+    void (*rx_resume)(net_device_t *dev);
+
+    // 补充后端自己的统计（如内核丢包），可为NULL
+    void (*stats)(net_device_t *dev, net_device_stats_t *stats);
+
+    // open失败时改用的后端（如io_uring不可用时退回AF_PACKET），可为NULL
+    const struct net_backend *fallback;
+} net_backend_t;
+
+// 发送完成：通知使用者并归还net_send_zerocpy的缓冲区
+void net_tx_complete(net_device_t *dev, uint8_t *buffer, size_t length);
+
+// 把各段依次复制到dst
+static inline void net_iov_gather(uint8_t *dst, const net_iovec_t *iov, int count) {
+    for (int i = 0; i < count; i++) {
+        memcpy(dst, iov[i].base, iov[i].length);
+        dst += iov[i].length;
+    }
+}
+
+// 设备的校验和选项 NET_CSUM_xxx
+static inline uint32_t net_csum_flags(const net_device_t *dev) {
+    return dev->config ? dev->config->csum_flags : 0;
+}
+
+// 发送合并等待时间（微秒）
+static inline uint32_t net_tx_flush_us(const net_device_t *dev) {
+    return dev->config ? dev->config->tx_flush_us : 0;
+}
+
+// 接收线程入队前填写帧的元数据：VLAN取帧内最外层标签，流哈希用分类时RSS算出的hash，为0时由软件计算
+// flags可带NET_META_TS_KERNEL表示rx_ns是内核时间戳
+static inline void net_rx_meta_fill(net_pkt_meta_t *meta, const uint8_t *frame, size_t length, int queue,
+                                    uint32_t hash, uint64_t rx_ns, uint64_t queue_ns, uint8_t flags) {
+    uint16_t type = length >= NET_ETH_HLEN ? (uint16_t)((frame[12] << 8) | frame[13]) : 0;
+
+    meta->rx_ns = rx_ns;
+    meta->queue_ns = queue_ns;
+    meta->length = (uint32_t)length;
+    meta->flow_hash = hash ? hash : net_flow_hash(frame, length);
+    meta->vlan_tci = 0;
+    meta->ingress_port = 0;
+    meta->queue = (uint8_t)queue;
+    meta->gro_segs = 1;
+    meta->gro_next = NULL;
+    if ((type == NET_ETHERTYPE_VLAN || type == NET_ETHERTYPE_QINQ) && length >= NET_ETH_HLEN + NET_VLAN_HLEN) {
+        meta->vlan_tci = (uint16_t)((frame[14] << 8) | frame[15]);
+        flags |= NET_META_VLAN;
+    }
+    if (meta->flow_hash) {
+        flags |= NET_META_HASH;
+    }
+    meta->flags = flags;
+}
+
+// TCP链路是否使用内核接收时间戳
+static inline bool net_rx_kernel_ts(const net_device_t *dev) {
+    return dev->config ? dev->config->rx_kernel_ts : false;
+}
+
+// 设置后端线程名称，cpu为NET_CPU(n)时绑定到CPU n
+void net_thread_setup(pthread_t thread, const char *name, int cpu);
+
+extern const net_backend_t net_backend_tcp;
+#ifdef __linux__
+extern const net_backend_t net_backend_packet;
+extern const net_backend_t net_backend_shm;
+extern const net_backend_t net_backend_uring;
+#endif
+
+#endif
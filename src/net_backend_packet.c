@@ -0,0 +1,526 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "net_device.h"
+#include "net_backend.h"
+#include "net_ring.h"
+#include "net_capture.h"
+#include "net_stats.h"
+#include "net_csum.h"
+#include "net_classifier.h"
+#include "net_backpressure.h"
+#include "net_dispatch.h"
+#include "net_gro.h"
+
+// ======================================================================
+// AF_PACKET 后端（Linux 真实以太网）
+//
+// 接收使用 PACKET_MMAP TPACKET_V3 内存映射环：内核把帧直接写入与用户态
+// 共享的块中，接收线程只把帧在环内的地址放入接收队列，
+// net_receive_zerocpy_with_length 拿到的就是环内地址，不经过内存池拷贝。
+// 每块维护引用计数，块内所有帧都被 net_packet_free 后才归还内核。
+// PACKET_RESERVE让内核在每帧前多留空间，帧元数据直接写在环内帧前的缓存行。
+// ======================================================================
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#include <net/if.h>
+#include <net/ethernet.h>
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+
+#define PACKET_RING_BLOCK_SIZE   (256 * 1024) // 块大小，需为页大小整数倍
+#define PACKET_RING_BLOCK_NR     64           // 块数量，环总大小16MB
+#define PACKET_RING_FRAME_SIZE   2048         // V3下帧长可变，仅用于内核参数校验
+#define PACKET_RING_RETIRE_TOV   1            // 块未写满时最多1ms交给用户态
+#define PACKET_RING_RESERVE      128          // 帧前预留，对齐到缓存行后仍能放下元数据且不压到帧头
+
+typedef struct {
+    net_device_t *dev;
+    int fd;
+    int ifindex;
+    uint32_t csum_flags;        // NET_CSUM_xxx，只支持NET_CSUM_RX_L4
+
+    uint8_t *ring;              // mmap的接收环
+    size_t ring_size;
+    uint32_t block_size;
+    uint32_t block_nr;
+    uint32_t *block_refs;       // 每块引用：遍历中+1，每个未释放的帧+1
+
+    // 接收线程遍历位置
+    uint32_t cur_block;
+    uint32_t pkts_left;
+    struct tpacket3_hdr *next_pkt;
+
+    volatile bool running;
+    pthread_t thread_id;
+    int wake_fd;                // eventfd：停止线程或队列有空位时唤醒
+    int epoll_fd;               // 等fd（边沿触发）与wake_fd
+    bool wait_queue;            // 接收队列已满，等待消费端取走报文
+
+    uint64_t kernel_drops;      // PACKET_STATISTICS读后清零，在这里累计
+} packet_backend_t;
+
+static inline struct tpacket_block_desc *packet_block(packet_backend_t *pb, uint32_t index) {
+    return (struct tpacket_block_desc *)(pb->ring + (size_t)index * pb->block_size);
+}
+
+// 释放块的一个引用，归零时把块归还内核
+static void packet_block_put(packet_backend_t *pb, uint32_t index) {
+    if (__atomic_sub_fetch(&pb->block_refs[index], 1, __ATOMIC_ACQ_REL) == 0) {
+        __atomic_store_n(&packet_block(pb, index)->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    }
+}
+
+static inline void packet_skip_frame(packet_backend_t *pb, struct tpacket3_hdr *pkt) {
+    pb->next_pkt = (struct tpacket3_hdr *)((uint8_t *)pkt + pkt->tp_next_offset);
+    pb->pkts_left--;
+}
+
+// 把当前块剩余的帧分类后放入各接收队列
+// 返回 0：当前块已处理完；1：接收队列已满或过载（BLOCK策略）
+static int packet_dispatch_frames(packet_backend_t *pb) {
+    net_device_t *dev = pb->dev;
+    uint64_t stamp = net_stats_now_ns();
+    const int64_t realtime_offset = net_time_realtime_offset();
+    const bool overloaded = net_backpressure_update(dev, false);
+    size_t queued = 0;
+    size_t bytes = 0;
+    uint32_t notify_mask = 0;
+    int ret = 0;
+
+    while (pb->pkts_left > 0) {
+        struct tpacket3_hdr *pkt = pb->next_pkt;
+        uint8_t *frame = (uint8_t *)pkt + pkt->tp_mac;
+        size_t length = pkt->tp_snaplen;
+
+        // 网卡已校验并去掉FCS，这里只能校验L3/L4
+        if ((pb->csum_flags & NET_CSUM_RX_L4) && net_csum_verify_l4(frame, length) != 0) {
+            NET_LOG_RATELIMITED(NET_LOGW, "Drop frame with bad checksum (%zu bytes)", length);
+            net_stat_add(&dev->stats->rx.drop_csum, 1);
+            packet_skip_frame(pb, pkt);
+            continue;
+        }
+
+        // 丢弃或回调处理的帧不加块引用，块可以尽早归还内核
+        uint32_t hash = 0;
+        int queue = net_classify_rx(dev, frame, length, &hash);
+        if (queue < 0) {
+            packet_skip_frame(pb, pkt);
+            continue;
+        }
+
+        net_ring_t *ring = net_rx_queue(dev, queue);
+        hash = net_gro_prepare(dev, ring, frame, length, hash);
+        if ((overloaded || net_ring_free_count(ring) == 0) && net_backpressure_drop_new(dev)) {
+            packet_skip_frame(pb, pkt);
+            continue;
+        }
+        if (net_backpressure_block(dev, overloaded) || net_ring_free_count(ring) == 0) {
+            ret = 1;
+            break;
+        }
+
+        // 先加引用再入队，消费端可能立即释放
+        __atomic_add_fetch(&pb->block_refs[pb->cur_block], 1, __ATOMIC_RELAXED);
+
+        // 内核已经给出时间戳、剥离的VLAN标签与流哈希；开了RSS或GRO时用已经算好的软件哈希，两者只算一个
+        net_pkt_meta_t *meta = net_packet_meta(frame);
+        meta->rx_ns = (uint64_t)pkt->tp_sec * 1000000000ULL + pkt->tp_nsec - (uint64_t)realtime_offset;
+        meta->queue_ns = stamp;
+        meta->length = (uint32_t)length;
+        if (!hash) {
+            hash = pkt->hv1.tp_rxhash ? pkt->hv1.tp_rxhash : net_flow_hash(frame, length);
+        }
+        meta->flow_hash = hash;
+        meta->vlan_tci = (pkt->tp_status & TP_STATUS_VLAN_VALID) ? (uint16_t)pkt->hv1.tp_vlan_tci : 0;
+        meta->ingress_port = (uint16_t)pb->ifindex;
+        meta->queue = (uint8_t)queue;
+        meta->gro_segs = 1;
+        meta->gro_next = NULL;
+        meta->flags = NET_META_TS_KERNEL | (meta->flow_hash ? NET_META_HASH : 0) |
+                      ((pkt->tp_status & TP_STATUS_VLAN_VALID) ? NET_META_VLAN : 0);
+
+        NET_LOGD("Received %zu bytes from %s", length, dev->ifname);
+        net_capture_rx(dev, frame, length);
+        net_rx_enqueue(dev, ring, frame, length, stamp, hash);
+        notify_mask |= 1u << queue;
+        queued++;
+        bytes += length;
+
+        if (dev->callback) {
+            dev->callback(NET_MSG_TYPE_RX_PACKET, dev->userdata, frame, length);
+        }
+
+        // 回调看过这一帧后再按批交付，交付后缓冲区可能已被释放
+        net_dispatch_enqueued(dev, ring);
+
+        packet_skip_frame(pb, pkt);
+    }
+
+    if (queued > 0) {
+        net_gro_flush(dev);
+        net_rx_queues_notify(dev, notify_mask);
+        net_stat_add(&dev->stats->rx.packets, queued);
+        net_stat_add(&dev->stats->rx.bytes, bytes);
+        net_stats_rx_commit(dev);
+        net_dispatch_batch_end(dev);
+    }
+    if (ret > 0) {
+        return ret;
+    }
+
+    // 去掉遍历引用，转到下一块
+    packet_block_put(pb, pb->cur_block);
+    pb->cur_block = (pb->cur_block + 1) % pb->block_nr;
+    return 0;
+}
+
+static void packet_rx_resume(net_device_t *dev) {
+    packet_backend_t *pb = (packet_backend_t *)dev->backend_priv;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pb->wait_queue, __ATOMIC_SEQ_CST)) {
+        eventfd_write(pb->wake_fd, 1);
+    }
+}
+
+static void *packet_rx_thread_func(void *arg) {
+    packet_backend_t *pb = (packet_backend_t *)arg;
+    struct epoll_event events[2];
+    eventfd_t value;
+
+    while (pb->running) {
+        if (pb->pkts_left == 0) {
+            struct tpacket_block_desc *desc = packet_block(pb, pb->cur_block);
+
+            if (!(__atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+                // 上一块仍被消费端持有时fd一直是可读的，边沿触发只在内核交出新块或被唤醒时返回
+                int n = epoll_wait(pb->epoll_fd, events, 2, -1);
+                if (n < 0 && errno != EINTR) {
+                    perror("epoll_wait error");
+                    break;
+                }
+                for (int i = 0; i < n; i++) {
+                    if (events[i].data.fd == pb->wake_fd) {
+                        eventfd_read(pb->wake_fd, &value);
+                    }
+                }
+                continue;
+            }
+
+            __atomic_store_n(&pb->block_refs[pb->cur_block], 1, __ATOMIC_RELAXED);
+            pb->pkts_left = desc->hdr.bh1.num_pkts;
+            pb->next_pkt = (struct tpacket3_hdr *)((uint8_t *)desc + desc->hdr.bh1.offset_to_first_pkt);
+        }
+
+        int ret = packet_dispatch_frames(pb);
+        if (ret > 0) {
+            net_stat_add(&pb->dev->stats->rx.stall_ring_full, 1);
+        }
+
+        // 接收队列已满：停止遍历，环写满后由内核丢包
+        while (ret > 0 && pb->running) {
+            __atomic_store_n(&pb->wait_queue, true, __ATOMIC_SEQ_CST);
+            ret = packet_dispatch_frames(pb);
+            if (ret > 0) {
+                eventfd_read(pb->wake_fd, &value);
+            }
+            __atomic_store_n(&pb->wait_queue, false, __ATOMIC_SEQ_CST);
+        }
+    }
+
+    return NULL;
+}
+
+static int packet_buffer_free(net_device_t *dev, uint8_t *buffer) {
+    packet_backend_t *pb = (packet_backend_t *)dev->backend_priv;
+
+    if (buffer < pb->ring || buffer >= pb->ring + pb->ring_size) {
+        return -1;
+    }
+
+    packet_block_put(pb, (uint32_t)((size_t)(buffer - pb->ring) / pb->block_size));
+    return 0;
+}
+
+static int packet_send(net_device_t *dev, const uint8_t *data, size_t length) {
+    packet_backend_t *pb = (packet_backend_t *)dev->backend_priv;
+
+    if (length < ETH_HLEN) {
+        NET_LOGE("Frame too short: %zu", length);
+        return -1;
+    }
+
+    NET_LOGD("Sending %zu bytes to %s", length, dev->ifname);
+
+    while (send(pb->fd, data, length, 0) < 0) {
+        if (errno != EINTR) {
+            perror("packet send failed");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// 分散发送：sendmsg由内核直接从各段收集，不在用户态拼接
+static int packet_sendv(net_device_t *dev, const net_iovec_t *iov, int count, size_t length) {
+    packet_backend_t *pb = (packet_backend_t *)dev->backend_priv;
+    struct iovec vec[NET_IOV_MAX];
+    struct msghdr msg;
+
+    if (length < ETH_HLEN) {
+        NET_LOGE("Frame too short: %zu", length);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        vec[i].iov_base = (void *)iov[i].base;
+        vec[i].iov_len = iov[i].length;
+    }
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = vec;
+    msg.msg_iovlen = (size_t)count;
+
+    while (sendmsg(pb->fd, &msg, 0) < 0) {
+        if (errno != EINTR) {
+            perror("packet sendmsg failed");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// 批量发送：一次sendmmsg发出一批帧
+static int packet_send_burst(net_device_t *dev, uint8_t **data, const size_t *lengths, int count) {
+    packet_backend_t *pb = (packet_backend_t *)dev->backend_priv;
+    struct mmsghdr msgs[NET_BURST_MAX];
+    struct iovec iov[NET_BURST_MAX];
+    int sent = 0;
+
+    while (sent < count) {
+        int n = 0;
+
+        while (n < NET_BURST_MAX && sent + n < count) {
+            if (lengths[sent + n] < ETH_HLEN) {
+                NET_LOGE("Frame too short: %zu", lengths[sent + n]);
+                count = sent + n;
+                break;
+            }
+
+            iov[n].iov_base = data[sent + n];
+            iov[n].iov_len = lengths[sent + n];
+            memset(&msgs[n], 0, sizeof(msgs[n]));
+            msgs[n].msg_hdr.msg_iov = &iov[n];
+            msgs[n].msg_hdr.msg_iovlen = 1;
+            n++;
+        }
+
+        if (n == 0) {
+            break;
+        }
+
+        int ret = sendmmsg(pb->fd, msgs, (unsigned int)n, 0);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("packet sendmmsg failed");
+            return sent > 0 ? sent : -1;
+        }
+        sent += ret;
+    }
+
+    return sent;
+}
+
+static void packet_release(packet_backend_t *pb) {
+    if (pb->ring && pb->ring != MAP_FAILED) {
+        munmap(pb->ring, pb->ring_size);
+    }
+    if (pb->fd >= 0) {
+        close(pb->fd);
+    }
+    if (pb->wake_fd >= 0) {
+        close(pb->wake_fd);
+    }
+    if (pb->epoll_fd >= 0) {
+        close(pb->epoll_fd);
+    }
+    free(pb->block_refs);
+    free(pb);
+}
+
+static int packet_open(net_device_t *dev) {
+    if (!dev->ifname) {
+        NET_LOGE("NET_MODE_ETH requires ifname");
+        return -1;
+    }
+
+    packet_backend_t *pb = (packet_backend_t *)calloc(1, sizeof(packet_backend_t));
+    if (!pb) {
+        NET_LOGE("Failed to allocate packet backend");
+        return -1;
+    }
+
+    pb->dev = dev;
+    pb->csum_flags = net_csum_flags(dev);
+    pb->fd = -1;
+    pb->wake_fd = -1;
+    pb->epoll_fd = -1;
+    pb->block_size = PACKET_RING_BLOCK_SIZE;
+    pb->block_nr = PACKET_RING_BLOCK_NR;
+    pb->ring_size = (size_t)pb->block_size * pb->block_nr;
+
+    pb->ifindex = (int)if_nametoindex(dev->ifname);
+    if (pb->ifindex == 0) {
+        NET_LOGE("Unknown interface: %s", dev->ifname);
+        goto err;
+    }
+
+    pb->fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(ETH_P_ALL));
+    if (pb->fd < 0) {
+        perror("packet socket creation failed (need CAP_NET_RAW)");
+        goto err;
+    }
+
+    int version = TPACKET_V3;
+    if (setsockopt(pb->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        perror("PACKET_VERSION failed");
+        goto err;
+    }
+
+    struct tpacket_req3 req = {
+        .tp_block_size = pb->block_size,
+        .tp_block_nr = pb->block_nr,
+        .tp_frame_size = PACKET_RING_FRAME_SIZE,
+        .tp_frame_nr = (pb->block_size / PACKET_RING_FRAME_SIZE) * pb->block_nr,
+        .tp_retire_blk_tov = PACKET_RING_RETIRE_TOV,
+        .tp_feature_req_word = TP_FT_REQ_FILL_RXHASH,
+    };
+    int reserve = PACKET_RING_RESERVE;
+    if (setsockopt(pb->fd, SOL_PACKET, PACKET_RESERVE, &reserve, sizeof(reserve)) < 0) {
+        perror("PACKET_RESERVE failed");
+        goto err;
+    }
+    if (setsockopt(pb->fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        perror("PACKET_RX_RING failed");
+        goto err;
+    }
+
+    pb->ring = mmap(NULL, pb->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pb->fd, 0);
+    if (pb->ring == MAP_FAILED) {
+        perror("packet ring mmap failed");
+        goto err;
+    }
+
+#ifdef PACKET_IGNORE_OUTGOING
+    // 不接收本socket所在主机发出的帧
+    int one = 1;
+    setsockopt(pb->fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
+#endif
+
+    struct sockaddr_ll addr = {
+        .sll_family = AF_PACKET,
+        .sll_protocol = htons(ETH_P_ALL),
+        .sll_ifindex = pb->ifindex,
+    };
+    if (bind(pb->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("packet bind failed");
+        goto err;
+    }
+
+    // 模拟设备有自己的MAC，需要混杂模式才能收到发给它的帧，socket关闭时自动恢复
+    struct packet_mreq mreq = {
+        .mr_ifindex = pb->ifindex,
+        .mr_type = PACKET_MR_PROMISC,
+    };
+    if (setsockopt(pb->fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        perror("PACKET_MR_PROMISC failed");
+    }
+
+    pb->block_refs = (uint32_t *)calloc(pb->block_nr, sizeof(uint32_t));
+    pb->wake_fd = eventfd(0, EFD_CLOEXEC);
+    pb->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (!pb->block_refs || pb->wake_fd < 0 || pb->epoll_fd < 0) {
+        NET_LOGE("Failed to allocate packet ring state");
+        goto err;
+    }
+
+    struct epoll_event ev_ring = { .events = EPOLLIN | EPOLLET, .data.fd = pb->fd };
+    struct epoll_event ev_wake = { .events = EPOLLIN, .data.fd = pb->wake_fd };
+    if (epoll_ctl(pb->epoll_fd, EPOLL_CTL_ADD, pb->fd, &ev_ring) < 0 ||
+        epoll_ctl(pb->epoll_fd, EPOLL_CTL_ADD, pb->wake_fd, &ev_wake) < 0) {
+        perror("packet epoll_ctl failed");
+        goto err;
+    }
+
+    dev->backend_priv = pb;
+    pb->running = true;
+    if (pthread_create(&pb->thread_id, NULL, packet_rx_thread_func, pb) != 0) {
+        perror("Failed to create packet receive thread");
+        dev->backend_priv = NULL;
+        goto err;
+    }
+    net_thread_setup(pb->thread_id, "net-rx", dev->rx_cpu);
+
+    NET_LOGI("Opened %s with TPACKET_V3 ring %u x %u bytes", dev->ifname, pb->block_nr, pb->block_size);
+    return 0;
+
+err:
+    packet_release(pb);
+    return -1;
+}
+
+static void packet_stats(net_device_t *dev, net_device_stats_t *stats) {
+    packet_backend_t *pb = (packet_backend_t *)dev->backend_priv;
+    struct tpacket_stats_v3 st;
+    socklen_t len = sizeof(st);
+
+    if (!pb) {
+        return;
+    }
+
+    if (getsockopt(pb->fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) == 0) {
+        __atomic_fetch_add(&pb->kernel_drops, st.tp_drops, __ATOMIC_RELAXED);
+    }
+    stats->rx_drop_kernel = __atomic_load_n(&pb->kernel_drops, __ATOMIC_RELAXED);
+}
+
+static void packet_close(net_device_t *dev) {
+    packet_backend_t *pb = (packet_backend_t *)dev->backend_priv;
+    if (!pb) {
+        return;
+    }
+
+    pb->running = false;
+    eventfd_write(pb->wake_fd, 1);
+    pthread_join(pb->thread_id, NULL);
+
+    dev->backend_priv = NULL;
+    packet_release(pb);
+}
+
+const net_backend_t net_backend_packet = {
+    .name        = "packet",
+    .open        = packet_open,
+    .close       = packet_close,
+    .send        = packet_send,
+    .send_burst  = packet_send_burst,
+    .sendv       = packet_sendv,
+    .buffer_free = packet_buffer_free,
+    .rx_resume   = packet_rx_resume,
+    .stats       = packet_stats,
+};
+
+#endif
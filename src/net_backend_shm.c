@@ -0,0 +1,690 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "net_device.h"
+#include "net_backend.h"
+#include "net_ring.h"
+#include "net_capture.h"
+#include "net_stats.h"
+#include "net_csum.h"
+#include "net_classifier.h"
+#include "net_backpressure.h"
+#include "net_dispatch.h"
+#include "net_gro.h"
+#include "net_pool.h"
+
+// ======================================================================
+// 共享内存后端（同一主机上两个进程之间交换帧）
+//
+// 创建方用memfd建立共享区域，区域内每个方向有一组帧槽和两个SPSC环：
+//   tx  —— 发送方放入帧描述符（槽号+长度），接收方取出
+//   ret —— 接收方归还用完的槽号，发送方取出复用
+// 发送只拷贝一次（写入槽），接收方直接把槽地址放入接收队列，不经过内存池。
+// 每一方有一个eventfd门铃，只有对方接收线程已睡眠时才敲；另有一个槽门铃，
+// 发送方没有空闲槽而等待时，接收方归还槽后敲它。
+// 每个槽前面留一个缓存行，接收方在里面填写帧元数据。
+//
+// 加入方通过抽象unix socket "net-shm:<名称>"连接创建方，
+// 用SCM_RIGHTS拿到memfd与各门铃。一条链路只接受一个加入方。
+// ======================================================================
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+
+#define SHM_MAGIC           0x4D48534Eu     // "NSHM"
+#define SHM_VERSION         3
+#define SHM_SLOT_NR         1024            // 每个方向的帧槽数，2的幂
+#define SHM_TX_WAIT_MS      100             // 没有空闲槽时发送方最多等待
+#define SHM_DEFAULT_NAME    "net-shm"
+#define SHM_SOCK_PREFIX     "net-shm:"
+
+typedef struct {
+    uint32_t slot;
+    uint32_t length;
+} shm_desc_t;
+
+// 共享内存中的单生产者/单消费者环，下标自由增长
+typedef struct {
+    NET_CACHE_ALIGNED uint32_t head;        // 生产者写
+    NET_CACHE_ALIGNED uint32_t tail;        // 消费者写
+    NET_CACHE_ALIGNED uint32_t sleeping;    // 消费者等待门铃（ret环：发送方等空闲槽）
+    NET_CACHE_ALIGNED shm_desc_t descs[SHM_SLOT_NR];
+} shm_ring_t;
+
+// 一个发送方向
+typedef struct {
+    shm_ring_t tx;
+    shm_ring_t ret;
+} shm_lane_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_size;         // 槽内帧的最大长度，每个槽前另有NET_PKT_META_SIZE字节元数据
+    uint32_t slot_nr;
+    uint64_t slots_offset;
+    NET_CACHE_ALIGNED shm_lane_t lane[2];   // lane[i]：第i方发送
+} shm_header_t;
+
+typedef struct {
+    net_device_t *dev;
+    int side;                   // 0：创建方；1：加入方
+    uint32_t csum_flags;
+
+    uint8_t *region;
+    size_t region_size;
+    shm_header_t *hdr;
+    shm_lane_t *tx_lane;
+    shm_lane_t *rx_lane;
+    uint8_t *tx_slots;
+    uint8_t *rx_slots;
+    uint32_t slot_size;
+    size_t slot_stride;         // 元数据加槽的大小
+
+    int mem_fd;
+    int doorbell[2];            // doorbell[i]：唤醒第i方的接收线程
+    int slot_bell[2];           // slot_bell[i]：唤醒等空闲槽的第i方发送方
+    int listen_fd;              // 创建方等待加入方，交接后关闭
+    int wake_fd;                // 停止线程或接收队列有空位时唤醒
+
+    pthread_mutex_t tx_lock;    // 多个线程发送
+    pthread_spinlock_t ret_lock; // 多个线程释放接收槽
+
+    volatile bool running;
+    pthread_t thread_id;
+    bool wait_queue;            // 接收队列已满，等待消费端取走报文
+} shm_backend_t;
+
+static inline shm_backend_t *shm_backend(net_device_t *dev) {
+    return (shm_backend_t *)dev->backend_priv;
+}
+
+// ---------------------------------------------------------------- 共享环
+
+static inline uint32_t shm_ring_count(shm_ring_t *ring) {
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+}
+
+// 生产者：一批写入后发布，消费者睡眠时敲门铃
+static inline void shm_ring_publish(shm_ring_t *ring, uint32_t head, int doorbell) {
+    __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->sleeping, __ATOMIC_RELAXED)) {
+        eventfd_write(doorbell, 1);
+    }
+}
+
+// 接收方归还一个槽，对方发送方在等空闲槽时敲槽门铃
+static void shm_slot_return(shm_backend_t *sb, uint32_t slot) {
+    shm_ring_t *ret = &sb->rx_lane->ret;
+
+    pthread_spin_lock(&sb->ret_lock);
+    uint32_t head = ret->head;
+    ret->descs[head & (SHM_SLOT_NR - 1)].slot = slot;
+    shm_ring_publish(ret, head + 1, sb->slot_bell[!sb->side]);
+    pthread_spin_unlock(&sb->ret_lock);
+}
+
+// ---------------------------------------------------------------- 接收
+
+static inline uint8_t *shm_slot_frame(const shm_backend_t *sb, uint8_t *slots, uint32_t slot) {
+    return slots + (size_t)slot * sb->slot_stride + NET_PKT_META_SIZE;
+}
+
+// 把对方已发出的帧分类后放入接收队列
+// 返回 0：环已取空；1：接收队列已满或过载（BLOCK策略）
+static int shm_dispatch_frames(shm_backend_t *sb) {
+    net_device_t *dev = sb->dev;
+    shm_ring_t *ring = &sb->rx_lane->tx;
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t stamp = net_stats_now_ns();
+    const bool overloaded = net_backpressure_update(dev, false);
+    size_t queued = 0;
+    size_t bytes = 0;
+    uint32_t notify_mask = 0;
+    int ret = 0;
+
+    while (tail != head) {
+        shm_desc_t desc = ring->descs[tail & (SHM_SLOT_NR - 1)];
+        uint8_t *frame = shm_slot_frame(sb, sb->rx_slots, desc.slot);
+        size_t length = desc.length;
+
+        if (desc.slot >= SHM_SLOT_NR || length > sb->slot_size) {
+            NET_LOG_RATELIMITED(NET_LOGW, "Drop corrupt shm descriptor: slot %u length %zu", desc.slot, length);
+            net_stat_add(&dev->stats->rx.drop_desync, 1);
+            tail++;
+            continue;
+        }
+
+        if ((sb->csum_flags & NET_CSUM_RX_L4) && net_csum_verify_l4(frame, length) != 0) {
+            NET_LOG_RATELIMITED(NET_LOGW, "Drop frame with bad checksum (%zu bytes)", length);
+            net_stat_add(&dev->stats->rx.drop_csum, 1);
+            shm_slot_return(sb, desc.slot);
+            tail++;
+            continue;
+        }
+
+        uint32_t hash = 0;
+        int queue = net_classify_rx(dev, frame, length, &hash);
+        if (queue < 0) {
+            shm_slot_return(sb, desc.slot);
+            tail++;
+            continue;
+        }
+
+        net_ring_t *rx_ring = net_rx_queue(dev, queue);
+        hash = net_gro_prepare(dev, rx_ring, frame, length, hash);
+        if ((overloaded || net_ring_free_count(rx_ring) == 0) && net_backpressure_drop_new(dev)) {
+            shm_slot_return(sb, desc.slot);
+            tail++;
+            continue;
+        }
+        if (net_backpressure_block(dev, overloaded) || net_ring_free_count(rx_ring) == 0) {
+            ret = 1;
+            break;
+        }
+
+        NET_LOGD("Received %zu bytes from shm peer", length);
+        net_rx_meta_fill(net_packet_meta(frame), frame, length, queue, hash, stamp, stamp, 0);
+        net_capture_rx(dev, frame, length);
+        net_rx_enqueue(dev, rx_ring, frame, length, stamp, hash);
+        notify_mask |= 1u << queue;
+        queued++;
+        bytes += length;
+        tail++;
+
+        if (dev->callback) {
+            dev->callback(NET_MSG_TYPE_RX_PACKET, dev->userdata, frame, length);
+        }
+
+        // 回调看过这一帧后再按批交付，交付后缓冲区可能已被释放
+        net_dispatch_enqueued(dev, rx_ring);
+    }
+
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+    if (queued > 0) {
+        net_gro_flush(dev);
+        net_rx_queues_notify(dev, notify_mask);
+        net_stat_add(&dev->stats->rx.packets, queued);
+        net_stat_add(&dev->stats->rx.bytes, bytes);
+        net_stats_rx_commit(dev);
+        net_dispatch_batch_end(dev);
+    }
+
+    return ret;
+}
+
+static int shm_send_fds(int sock, shm_backend_t *sb);
+
+// 创建方：把共享区域交给加入方，之后不再接受连接
+static void shm_accept_peer(shm_backend_t *sb) {
+    int conn = accept4(sb->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (conn < 0) {
+        return;
+    }
+
+    if (shm_send_fds(conn, sb) == 0) {
+        NET_LOGI("Shared memory peer attached");
+        close(sb->listen_fd);
+        sb->listen_fd = -1;
+    }
+    close(conn);
+}
+
+static void shm_rx_resume(net_device_t *dev) {
+    shm_backend_t *sb = shm_backend(dev);
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&sb->wait_queue, __ATOMIC_SEQ_CST)) {
+        eventfd_write(sb->wake_fd, 1);
+    }
+}
+
+static void *shm_rx_thread_func(void *arg) {
+    shm_backend_t *sb = (shm_backend_t *)arg;
+    shm_ring_t *ring = &sb->rx_lane->tx;
+    eventfd_t value;
+
+    while (sb->running) {
+        if (shm_ring_count(ring) == 0) {
+            // 置睡眠标志后再查一次，防止对方在置位前发布而不敲门铃
+            __atomic_store_n(&ring->sleeping, 1, __ATOMIC_SEQ_CST);
+            if (shm_ring_count(ring) == 0) {
+                struct pollfd pfd[3] = {
+                    { .fd = sb->doorbell[sb->side], .events = POLLIN },
+                    { .fd = sb->wake_fd,            .events = POLLIN },
+                    { .fd = sb->listen_fd,          .events = POLLIN },
+                };
+                int n = poll(pfd, sb->listen_fd >= 0 ? 3 : 2, -1);
+                if (n < 0 && errno != EINTR) {
+                    perror("poll error");
+                    break;
+                }
+                if (pfd[0].revents & POLLIN) {
+                    eventfd_read(sb->doorbell[sb->side], &value);
+                }
+                if (pfd[1].revents & POLLIN) {
+                    eventfd_read(sb->wake_fd, &value);
+                }
+                if (sb->listen_fd >= 0 && (pfd[2].revents & POLLIN)) {
+                    shm_accept_peer(sb);
+                }
+            }
+            __atomic_store_n(&ring->sleeping, 0, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        int ret = shm_dispatch_frames(sb);
+        if (ret > 0) {
+            net_stat_add(&sb->dev->stats->rx.stall_ring_full, 1);
+        }
+
+        // 接收队列已满：槽不归还，发送方用完空闲槽后自然停下
+        while (ret > 0 && sb->running) {
+            __atomic_store_n(&sb->wait_queue, true, __ATOMIC_SEQ_CST);
+            ret = shm_dispatch_frames(sb);
+            if (ret > 0) {
+                eventfd_read(sb->wake_fd, &value);
+            }
+            __atomic_store_n(&sb->wait_queue, false, __ATOMIC_SEQ_CST);
+        }
+    }
+
+    return NULL;
+}
+
+static int shm_buffer_free(net_device_t *dev, uint8_t *buffer) {
+    shm_backend_t *sb = shm_backend(dev);
+    size_t area = (size_t)SHM_SLOT_NR * sb->slot_stride;
+
+    if (buffer < sb->rx_slots || buffer >= sb->rx_slots + area) {
+        return -1;
+    }
+
+    shm_slot_return(sb, (uint32_t)((size_t)(buffer - sb->rx_slots) / sb->slot_stride));
+    return 0;
+}
+
+// ---------------------------------------------------------------- 发送
+
+// 取一个空闲槽，没有时睡在槽门铃上，对方SHM_TX_WAIT_MS内不归还返回-1；需持有tx_lock
+static int shm_slot_get(shm_backend_t *sb, uint32_t *slot) {
+    shm_ring_t *ret = &sb->tx_lane->ret;
+    uint64_t deadline = 0;
+    eventfd_t value;
+
+    while (shm_ring_count(ret) == 0) {
+        uint64_t now = net_stats_now_ns();
+        if (deadline == 0) {
+            deadline = now + (uint64_t)SHM_TX_WAIT_MS * 1000000ULL;
+        } else if (now >= deadline) {
+            return -1;
+        }
+
+        // 置等待标志后再查一次，防止对方在置位前归还而不敲门铃
+        __atomic_store_n(&ret->sleeping, 1, __ATOMIC_SEQ_CST);
+        if (shm_ring_count(ret) == 0) {
+            struct pollfd pfd = { .fd = sb->slot_bell[sb->side], .events = POLLIN };
+            if (poll(&pfd, 1, (int)((deadline - now + 999999) / 1000000)) > 0) {
+                eventfd_read(sb->slot_bell[sb->side], &value);
+            }
+        }
+        __atomic_store_n(&ret->sleeping, 0, __ATOMIC_RELAXED);
+    }
+
+    uint32_t tail = ret->tail;
+    *slot = ret->descs[tail & (SHM_SLOT_NR - 1)].slot;
+    __atomic_store_n(&ret->tail, tail + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static int shm_send_burst(net_device_t *dev, uint8_t **data, const size_t *lengths, int count) {
+    shm_backend_t *sb = shm_backend(dev);
+    shm_ring_t *ring = &sb->tx_lane->tx;
+    int sent = 0;
+
+    pthread_mutex_lock(&sb->tx_lock);
+    uint32_t head = ring->head;
+
+    while (sent < count) {
+        uint32_t slot;
+
+        if (lengths[sent] == 0 || lengths[sent] > sb->slot_size) {
+            NET_LOGE("Invalid frame length: %zu", lengths[sent]);
+            break;
+        }
+
+        // tx环与帧槽数相同，拿到槽就一定有描述符空位
+        if (shm_slot_get(sb, &slot) != 0) {
+            NET_LOG_RATELIMITED(NET_LOGW, "No free shm slot, peer is not draining");
+            break;
+        }
+
+        memcpy(shm_slot_frame(sb, sb->tx_slots, slot), data[sent], lengths[sent]);
+        ring->descs[head & (SHM_SLOT_NR - 1)] = (shm_desc_t){ .slot = slot, .length = (uint32_t)lengths[sent] };
+        head++;
+        sent++;
+
+        // 每满一个批量发布一次，对方不必等整批拷贝完
+        if ((sent % NET_BURST_MAX) == 0) {
+            shm_ring_publish(ring, head, sb->doorbell[!sb->side]);
+        }
+    }
+
+    if (sent % NET_BURST_MAX) {
+        shm_ring_publish(ring, head, sb->doorbell[!sb->side]);
+    }
+    pthread_mutex_unlock(&sb->tx_lock);
+
+    return sent > 0 ? sent : -1;
+}
+
+static int shm_send(net_device_t *dev, const uint8_t *data, size_t length) {
+    uint8_t *frames[1] = { (uint8_t *)data };
+    return shm_send_burst(dev, frames, &length, 1) == 1 ? 0 : -1;
+}
+
+// 分散发送：各段直接拼进帧槽
+static int shm_sendv(net_device_t *dev, const net_iovec_t *iov, int count, size_t length) {
+    shm_backend_t *sb = shm_backend(dev);
+    shm_ring_t *ring = &sb->tx_lane->tx;
+    uint32_t slot;
+
+    if (length == 0 || length > sb->slot_size) {
+        NET_LOGE("Invalid frame length: %zu", length);
+        return -1;
+    }
+
+    pthread_mutex_lock(&sb->tx_lock);
+    if (shm_slot_get(sb, &slot) != 0) {
+        pthread_mutex_unlock(&sb->tx_lock);
+        NET_LOG_RATELIMITED(NET_LOGW, "No free shm slot, peer is not draining");
+        return -1;
+    }
+
+    net_iov_gather(shm_slot_frame(sb, sb->tx_slots, slot), iov, count);
+    uint32_t head = ring->head;
+    ring->descs[head & (SHM_SLOT_NR - 1)] = (shm_desc_t){ .slot = slot, .length = (uint32_t)length };
+    shm_ring_publish(ring, head + 1, sb->doorbell[!sb->side]);
+    pthread_mutex_unlock(&sb->tx_lock);
+
+    return 0;
+}
+
+// ---------------------------------------------------------------- 建立链路
+
+static socklen_t shm_sock_addr(const char *name, struct sockaddr_un *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    // 抽象命名空间：首字节为0，进程退出后自动消失
+    int len = snprintf(addr->sun_path + 1, sizeof(addr->sun_path) - 1, SHM_SOCK_PREFIX "%s", name);
+    if (len < 0 || (size_t)len >= sizeof(addr->sun_path) - 1) {
+        return 0;
+    }
+    return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 + (size_t)len);
+}
+
+static int shm_send_fds(int sock, shm_backend_t *sb) {
+    int fds[5] = { sb->mem_fd, sb->doorbell[0], sb->doorbell[1], sb->slot_bell[0], sb->slot_bell[1] };
+    uint64_t size = sb->region_size;
+    char control[CMSG_SPACE(sizeof(fds))];
+    struct iovec iov = { .iov_base = &size, .iov_len = sizeof(size) };
+    struct msghdr msg = {
+        .msg_iov = &iov, .msg_iovlen = 1,
+        .msg_control = control, .msg_controllen = sizeof(control),
+    };
+
+    memset(control, 0, sizeof(control));
+    struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+
+    return sendmsg(sock, &msg, MSG_NOSIGNAL) == (ssize_t)sizeof(size) ? 0 : -1;
+}
+
+static int shm_recv_fds(int sock, shm_backend_t *sb) {
+    int fds[5];
+    uint64_t size = 0;
+    char control[CMSG_SPACE(sizeof(fds))];
+    struct iovec iov = { .iov_base = &size, .iov_len = sizeof(size) };
+    struct msghdr msg = {
+        .msg_iov = &iov, .msg_iovlen = 1,
+        .msg_control = control, .msg_controllen = sizeof(control),
+    };
+
+    if (recvmsg(sock, &msg, MSG_CMSG_CLOEXEC) != (ssize_t)sizeof(size)) {
+        return -1;
+    }
+
+    struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+    if (!cm || cm->cmsg_type != SCM_RIGHTS || cm->cmsg_len != CMSG_LEN(sizeof(fds))) {
+        return -1;
+    }
+
+    memcpy(fds, CMSG_DATA(cm), sizeof(fds));
+    sb->mem_fd = fds[0];
+    sb->doorbell[0] = fds[1];
+    sb->doorbell[1] = fds[2];
+    sb->slot_bell[0] = fds[3];
+    sb->slot_bell[1] = fds[4];
+    sb->region_size = (size_t)size;
+    return 0;
+}
+
+static void shm_ring_fill_free(shm_ring_t *ret) {
+    for (uint32_t i = 0; i < SHM_SLOT_NR; i++) {
+        ret->descs[i].slot = i;
+    }
+    ret->head = SHM_SLOT_NR;
+}
+
+// 创建共享区域并开始监听
+static int shm_create(shm_backend_t *sb, const struct sockaddr_un *addr, socklen_t addr_len) {
+    size_t slot_size = (net_pool_max_size(sb->dev->pool) + NET_CACHE_LINE - 1) & ~(size_t)(NET_CACHE_LINE - 1);
+    size_t header_size = (sizeof(shm_header_t) + 4095) & ~(size_t)4095;
+
+    sb->region_size = header_size + 2 * (size_t)SHM_SLOT_NR * (NET_PKT_META_SIZE + slot_size);
+    sb->mem_fd = memfd_create(SHM_DEFAULT_NAME, MFD_CLOEXEC);
+    if (sb->mem_fd < 0 || ftruncate(sb->mem_fd, (off_t)sb->region_size) < 0) {
+        perror("shm memfd failed");
+        return -1;
+    }
+
+    sb->region = mmap(NULL, sb->region_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, sb->mem_fd, 0);
+    if (sb->region == MAP_FAILED) {
+        perror("shm mmap failed");
+        sb->region = NULL;
+        return -1;
+    }
+
+    shm_header_t *hdr = (shm_header_t *)sb->region;
+    hdr->magic = SHM_MAGIC;
+    hdr->version = SHM_VERSION;
+    hdr->slot_size = (uint32_t)slot_size;
+    hdr->slot_nr = SHM_SLOT_NR;
+    hdr->slots_offset = header_size;
+    shm_ring_fill_free(&hdr->lane[0].ret);
+    shm_ring_fill_free(&hdr->lane[1].ret);
+
+    sb->doorbell[0] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    sb->doorbell[1] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    sb->slot_bell[0] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    sb->slot_bell[1] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (sb->doorbell[0] < 0 || sb->doorbell[1] < 0 || sb->slot_bell[0] < 0 || sb->slot_bell[1] < 0) {
+        perror("shm doorbell eventfd failed");
+        return -1;
+    }
+
+    sb->listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sb->listen_fd < 0 ||
+        bind(sb->listen_fd, (const struct sockaddr *)addr, addr_len) < 0 ||
+        listen(sb->listen_fd, 1) < 0) {
+        return -1;
+    }
+
+    sb->side = 0;
+    return 0;
+}
+
+// 连接已有的链路，返回-1表示没有创建方
+static int shm_join(shm_backend_t *sb, const struct sockaddr_un *addr, socklen_t addr_len) {
+    int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        return -1;
+    }
+
+    if (connect(sock, (const struct sockaddr *)addr, addr_len) < 0 || shm_recv_fds(sock, sb) != 0) {
+        close(sock);
+        return -1;
+    }
+    close(sock);
+
+    sb->region = mmap(NULL, sb->region_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, sb->mem_fd, 0);
+    if (sb->region == MAP_FAILED) {
+        perror("shm mmap failed");
+        sb->region = NULL;
+        return -1;
+    }
+
+    sb->side = 1;
+    return 0;
+}
+
+static void shm_release(shm_backend_t *sb) {
+    if (sb->region) {
+        munmap(sb->region, sb->region_size);
+    }
+    int fds[] = { sb->mem_fd, sb->doorbell[0], sb->doorbell[1], sb->slot_bell[0], sb->slot_bell[1],
+                  sb->listen_fd, sb->wake_fd };
+    for (size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); i++) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+        }
+    }
+    pthread_mutex_destroy(&sb->tx_lock);
+    pthread_spin_destroy(&sb->ret_lock);
+    free(sb);
+}
+
+static int shm_open_link(net_device_t *dev) {
+    const char *name = dev->remote ? dev->remote : SHM_DEFAULT_NAME;
+    struct sockaddr_un addr;
+    socklen_t addr_len = shm_sock_addr(name, &addr);
+
+    if (addr_len == 0) {
+        NET_LOGE("Shared memory link name too long: %s", name);
+        return -1;
+    }
+
+    shm_backend_t *sb = (shm_backend_t *)calloc(1, sizeof(shm_backend_t));
+    if (!sb) {
+        NET_LOGE("Failed to allocate shm backend");
+        return -1;
+    }
+
+    sb->dev = dev;
+    sb->csum_flags = net_csum_flags(dev);
+    sb->mem_fd = sb->doorbell[0] = sb->doorbell[1] = sb->slot_bell[0] = sb->slot_bell[1] = -1;
+    sb->listen_fd = sb->wake_fd = -1;
+    pthread_mutex_init(&sb->tx_lock, NULL);
+    pthread_spin_init(&sb->ret_lock, PTHREAD_PROCESS_PRIVATE);
+
+    // 先尝试加入；没有创建方时自己创建，两方同时创建时后绑定的一方改为加入
+    if (shm_join(sb, &addr, addr_len) != 0) {
+        if (sb->region || sb->mem_fd >= 0) {
+            NET_LOGE("Failed to attach shared memory link %s", name);
+            goto err;
+        }
+        if (shm_create(sb, &addr, addr_len) != 0) {
+            bool in_use = (errno == EADDRINUSE);
+            shm_release(sb);
+            if (!in_use) {
+                NET_LOGE("Failed to create shared memory link %s", name);
+                return -1;
+            }
+            return shm_open_link(dev);
+        }
+    }
+
+    sb->hdr = (shm_header_t *)sb->region;
+    if (sb->hdr->magic != SHM_MAGIC || sb->hdr->version != SHM_VERSION || sb->hdr->slot_nr != SHM_SLOT_NR) {
+        NET_LOGE("Shared memory link %s has incompatible layout", name);
+        goto err;
+    }
+    if (sb->hdr->slot_size < net_pool_max_size(dev->pool)) {
+        NET_LOGE("Shared memory slot %u smaller than local MTU buffer %zu",
+                 sb->hdr->slot_size, net_pool_max_size(dev->pool));
+        goto err;
+    }
+
+    sb->slot_size = sb->hdr->slot_size;
+    sb->slot_stride = NET_PKT_META_SIZE + (size_t)sb->slot_size;
+    sb->tx_lane = &sb->hdr->lane[sb->side];
+    sb->rx_lane = &sb->hdr->lane[!sb->side];
+    sb->tx_slots = sb->region + sb->hdr->slots_offset + (size_t)sb->side * SHM_SLOT_NR * sb->slot_stride;
+    sb->rx_slots = sb->region + sb->hdr->slots_offset + (size_t)!sb->side * SHM_SLOT_NR * sb->slot_stride;
+
+    sb->wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (sb->wake_fd < 0) {
+        perror("eventfd failed");
+        goto err;
+    }
+
+    dev->backend_priv = sb;
+    sb->running = true;
+    if (pthread_create(&sb->thread_id, NULL, shm_rx_thread_func, sb) != 0) {
+        perror("Failed to create shm receive thread");
+        dev->backend_priv = NULL;
+        goto err;
+    }
+    net_thread_setup(sb->thread_id, "net-rx", dev->rx_cpu);
+
+    NET_LOGI("%s shared memory link %s (%u x %u byte slots per direction)",
+             sb->side == 0 ? "Created" : "Joined", name, SHM_SLOT_NR, sb->slot_size);
+    return 0;
+
+err:
+    shm_release(sb);
+    return -1;
+}
+
+static void shm_close(net_device_t *dev) {
+    shm_backend_t *sb = shm_backend(dev);
+    if (!sb) {
+        return;
+    }
+
+    sb->running = false;
+    eventfd_write(sb->wake_fd, 1);
+    pthread_join(sb->thread_id, NULL);
+
+    dev->backend_priv = NULL;
+    shm_release(sb);
+}
+
+const net_backend_t net_backend_shm = {
+    .name        = "shm",
+    .open        = shm_open_link,
+    .close       = shm_close,
+    .send        = shm_send,
+    .send_burst  = shm_send_burst,
+    .sendv       = shm_sendv,
+    .buffer_free = shm_buffer_free,
+    .rx_resume   = shm_rx_resume,
+};
+
+#endif
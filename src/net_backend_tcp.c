@@ -0,0 +1,1249 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "net_device.h"
+#include "net_backend.h"
+
+// ======================================================================
+// 硬件接口
+// ======================================================================
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include "net_frame.h"
+#include "net_ring.h"
+#include "net_capture.h"
+#include "net_stats.h"
+#include "net_pool.h"
+#include "net_csum.h"
+#include "net_classifier.h"
+#include "net_backpressure.h"
+#include "net_dispatch.h"
+#include "net_gro.h"
+
+#define PYTHON_SERVER_IP   "127.0.0.1"
+#define PYTHON_SERVER_PORT 1069
+
+// MSG_ZEROCOPY需要固定用户页并等待完成通知，小帧直接复制更快
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#define TCP_ZEROCOPY        1
+#else
+#define TCP_ZEROCOPY        0
+#endif
+#define TCP_ZEROCOPY_MIN    8192
+#define TCP_ZC_COMPLETE_MAX 32  // 一次出锁回调的最多帧数
+
+#define TCP_CONNECT_TIMEOUT_MS  1000
+#define TCP_RECONNECT_MIN_MS    10      // 重连退避，失败一次翻倍
+#define TCP_RECONNECT_MAX_MS    1000
+#define TCP_TX_DRAIN_MS         200     // 关闭设备时发送剩余帧每次写最多等待
+#define TCP_TX_BATCH            256     // 发送线程一次sendmsg最多写出的帧数（每帧最多3个iov，不超过IOV_MAX）
+
+// ======================================================================
+// TCP通信接口
+// ======================================================================
+
+#include <stdlib.h>
+#include <pthread.h>
+
+typedef struct {
+    net_device_t *net_device;
+    volatile bool running;
+    pthread_t thread_id;
+    net_frame_stream_t stream;  // TCP字节流重组缓冲区
+    int epoll_fd;               // 等待socket可读/唤醒事件
+    int wake_fd;                // eventfd：停止线程或缓冲区释放时唤醒；随设备存在，重连不重建
+    bool wait_buffer;           // 接收线程正在等待空闲缓冲区或接收环空位
+    bool started;
+    uint64_t rx_kernel_ns;      // 最近一次读到数据的内核时间戳（net_time_ns时钟），0为没有
+} receive_thread_t;
+
+// 发送队列项
+typedef struct {
+    uint8_t *buffer;
+    uint32_t length;
+    bool copy;                  // true：发送线程申请的副本，写出后释放；false：零拷贝发送交来的缓冲区
+} tcp_tx_item_t;
+
+typedef struct {
+    size_t seq;                 // 等于下标时可写，等于下标+1时可读
+    tcp_tx_item_t item;
+} tcp_tx_cell_t;
+
+#define TCP_TX_BUSY     0
+#define TCP_TX_IDLE     1       // 队列为空，发送线程已挂起
+#define TCP_TX_LINGER   2       // 发送线程在等刷新期限
+
+// 有界多生产者/单消费者队列：每格带序号，生产者一次CAS预留连续多格，
+// 同一次入队的帧在队列中相邻且有序
+typedef struct {
+    tcp_tx_cell_t *cells;
+    size_t mask;
+    NET_CACHE_ALIGNED size_t tail;      // 生产者
+    NET_CACHE_ALIGNED size_t head;      // 发送线程
+    NET_CACHE_ALIGNED uint32_t state;   // TCP_TX_xxx，生产者据此决定是否唤醒
+} tcp_tx_queue_t;
+
+static int tcp_txq_init(tcp_tx_queue_t *q, size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    q->cells = (tcp_tx_cell_t *)calloc(size, sizeof(tcp_tx_cell_t));
+    if (!q->cells) {
+        return -1;
+    }
+    for (size_t i = 0; i < size; i++) {
+        q->cells[i].seq = i;
+    }
+    q->mask = size - 1;
+    q->head = q->tail = 0;
+    q->state = TCP_TX_BUSY;
+    return 0;
+}
+
+static void tcp_txq_deinit(tcp_tx_queue_t *q) {
+    free(q->cells);
+    q->cells = NULL;
+}
+
+static inline size_t tcp_txq_count(const tcp_tx_queue_t *q) {
+    size_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+    return __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) - head;
+}
+
+// 放入n帧，空位不足时一帧都不放，返回-1
+static int tcp_txq_enqueue(tcp_tx_queue_t *q, const tcp_tx_item_t *items, size_t n) {
+    size_t pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+
+    // 格子按顺序被消费者释放，最后一格可写则前面的也都可写
+    for (;;) {
+        size_t last = pos + n - 1;
+        size_t seq = __atomic_load_n(&q->cells[last & q->mask].seq, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)(seq - last);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&q->tail, &pos, pos + n, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -1;
+        } else {
+            pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        tcp_tx_cell_t *cell = &q->cells[(pos + i) & q->mask];
+        cell->item = items[i];
+        __atomic_store_n(&cell->seq, pos + i + 1, __ATOMIC_RELEASE);
+    }
+    return 0;
+}
+
+// 发送线程取出最多max帧，遇到尚未写完的格子即停
+static size_t tcp_txq_dequeue(tcp_tx_queue_t *q, tcp_tx_item_t *items, size_t max) {
+    size_t head = q->head;
+    size_t n = 0;
+
+    while (n < max) {
+        tcp_tx_cell_t *cell = &q->cells[head & q->mask];
+        if (__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) != head + 1) {
+            break;
+        }
+        items[n++] = cell->item;
+        __atomic_store_n(&cell->seq, head + q->mask + 1, __ATOMIC_RELEASE);
+        head++;
+    }
+
+    __atomic_store_n(&q->head, head, __ATOMIC_RELEASE);
+    return n;
+}
+
+// 等待零拷贝完成通知的帧
+typedef struct {
+    uint8_t *buffer;
+    size_t length;
+    uint32_t last_id;                   // 该帧最后一次sendmsg的通知序号
+    uint8_t hdr[NET_FRAME_HDR_LEN];     // 内核引用的是用户页，长度头也要保留到完成
+    uint8_t fcs[NET_FCS_LEN];
+} tcp_zc_entry_t;
+
+// 每个设备一份，挂在 dev->backend_priv
+typedef struct {
+    tcp_tx_queue_t txq;         // 放在开头，保持缓存行对齐
+    int sock;                   // 只由发送线程打开与关闭
+    struct sockaddr_in server_addr;
+    receive_thread_t rx;
+    uint32_t csum_flags;        // NET_CSUM_xxx
+
+    // 零拷贝发送，tx_lock保护
+    pthread_mutex_t tx_lock;
+    bool zerocopy;              // 当前套接字已开启SO_ZEROCOPY
+    uint32_t zc_next_id;        // 下一次零拷贝sendmsg的通知序号
+    uint32_t zc_done;           // 小于此序号的sendmsg都已完成
+    tcp_zc_entry_t *zc_pending; // 按发送顺序排列，TCP的完成通知也按序到达
+    size_t zc_mask;
+    size_t zc_head;
+    size_t zc_tail;
+
+    // 发送线程
+    pthread_t tx_thread;
+    volatile bool tx_running;
+    int tx_wake_fd;             // eventfd：队列从空变为非空、连接断开或关闭设备时唤醒
+    uint64_t tx_flush_ns;       // 不足一批时最多等待的时间，0不等待
+    bool link_down;             // 接收线程发现断线，由发送线程回收并重连
+    tcp_tx_item_t batch[TCP_TX_BATCH]; // 正在发送的批次，断线时留到重连后重发
+    int batch_nr;
+    uint8_t batch_hdr[TCP_TX_BATCH][NET_FRAME_HDR_LEN];
+    uint8_t batch_fcs[TCP_TX_BATCH][NET_FCS_LEN];
+    struct iovec iov[TCP_TX_BATCH * 3];
+} tcp_backend_t;
+
+static inline tcp_backend_t *tcp_backend(net_device_t *dev) {
+    return (tcp_backend_t *)dev->backend_priv;
+}
+
+// 链路上的FCS长度
+static inline size_t tcp_tx_fcs_len(const tcp_backend_t *tb) {
+    return (tb->csum_flags & NET_CSUM_TX_FCS) ? NET_FCS_LEN : 0;
+}
+
+// 填充一帧的iov：长度头、帧数据、可选的FCS，返回iov个数
+static int tcp_frame_iov(struct iovec *iov, uint8_t *hdr, uint8_t *fcs,
+                         const uint8_t *data, size_t length, size_t fcs_len) {
+    net_frame_encode_header(hdr, length + fcs_len);
+    iov[0].iov_base = hdr;
+    iov[0].iov_len = NET_FRAME_HDR_LEN;
+    iov[1].iov_base = (void *)data;
+    iov[1].iov_len = length;
+    if (fcs_len == 0) {
+        return 2;
+    }
+
+    uint32_t crc = net_crc32(0, data, length);
+    fcs[0] = (uint8_t)crc;
+    fcs[1] = (uint8_t)(crc >> 8);
+    fcs[2] = (uint8_t)(crc >> 16);
+    fcs[3] = (uint8_t)(crc >> 24);
+    iov[2].iov_base = fcs;
+    iov[2].iov_len = NET_FCS_LEN;
+    return 3;
+}
+
+// 从流缓冲区切出所有完整帧，校验、分类后搬运到内存池并放入目标接收队列
+// 被丢弃或由规则回调处理的帧不占用缓冲区
+// 内存池耗尽、接收队列已满或过载时按策略丢弃，或把剩余帧留在流缓冲区下次继续
+// 返回 0：已切完；1：接收队列已满；2：内存池耗尽或过载；-1：流失步
+static int receive_dispatch_frames(receive_thread_t *thread) {
+    net_device_t *net_device = thread->net_device;
+    net_stats_t *stats = net_device->stats;
+    net_frame_stream_t *stream = &thread->stream;
+    const uint32_t csum_flags = tcp_backend(net_device)->csum_flags;
+    const size_t fcs_len = (csum_flags & NET_CSUM_RX_FCS) ? NET_FCS_LEN : 0;
+    const size_t buffer_size = net_pool_max_size(net_device->pool);
+    const uint8_t *frame = NULL;
+    size_t wire_len = 0;
+    size_t queued = 0;
+    size_t bytes = 0;
+    uint32_t notify_mask = 0;
+    uint64_t stamp = net_stats_now_ns();
+    // 一次读取中切出的帧共用该次读取的内核时间戳
+    const uint64_t rx_ns = thread->rx_kernel_ns ? thread->rx_kernel_ns : stamp;
+    const uint8_t ts_flags = thread->rx_kernel_ns ? NET_META_TS_KERNEL : 0;
+    const bool overloaded = net_backpressure_update(net_device, true);
+    int ret;
+
+    // 先查看再决定是否取出：缓冲区不足时帧留在流缓冲区
+    while ((ret = net_frame_stream_peek_frame(stream, &frame, &wire_len)) > 0) {
+        size_t frame_len = wire_len - fcs_len;
+
+        if (wire_len > buffer_size + fcs_len) {
+            NET_LOG_RATELIMITED(NET_LOGW, "Drop oversized frame: %zu > %zu", wire_len, buffer_size);
+            net_stat_add(&stats->rx.drop_oversize, 1);
+            net_frame_stream_next(stream, &frame, &wire_len);
+            continue;
+        }
+
+        if (fcs_len && (wire_len <= fcs_len || net_fcs_check(frame, wire_len) != 0)) {
+            NET_LOG_RATELIMITED(NET_LOGW, "Drop frame with bad FCS (%zu bytes)", wire_len);
+            net_stat_add(&stats->rx.drop_fcs, 1);
+            net_frame_stream_next(stream, &frame, &wire_len);
+            continue;
+        }
+
+        if ((csum_flags & NET_CSUM_RX_L4) && net_csum_verify_l4(frame, frame_len) != 0) {
+            NET_LOG_RATELIMITED(NET_LOGW, "Drop frame with bad checksum (%zu bytes)", frame_len);
+            net_stat_add(&stats->rx.drop_csum, 1);
+            net_frame_stream_next(stream, &frame, &wire_len);
+            continue;
+        }
+
+        uint32_t hash = 0;
+        int queue = net_classify_rx(net_device, frame, frame_len, &hash);
+        if (queue < 0) {
+            net_frame_stream_next(stream, &frame, &wire_len);
+            continue;
+        }
+
+        if (overloaded && net_backpressure_drop_new(net_device)) {
+            net_frame_stream_next(stream, &frame, &wire_len);
+            continue;
+        }
+        if (net_backpressure_block(net_device, overloaded)) {
+            ret = 2;
+            break;
+        }
+
+        net_ring_t *ring = net_rx_queue(net_device, queue);
+        hash = net_gro_prepare(net_device, ring, frame, frame_len, hash);
+        if (net_ring_free_count(ring) == 0) {
+            if (net_backpressure_drop_new(net_device)) {
+                net_frame_stream_next(stream, &frame, &wire_len);
+                continue;
+            }
+            ret = 1;
+            break;
+        }
+
+        uint8_t *buffer = net_pool_alloc(net_device->pool, frame_len);
+        if (!buffer) {
+            if (net_backpressure_drop_new(net_device)) {
+                net_frame_stream_next(stream, &frame, &wire_len);
+                continue;
+            }
+            ret = 2;
+            break;
+        }
+        net_stat_add(&stats->rx.pool_alloc, 1);
+
+        net_frame_stream_next(stream, &frame, &wire_len);
+        memcpy(buffer, frame, frame_len);
+
+        NET_LOGD("Received %zu bytes from server", frame_len);
+        NET_HEX_DUMP(buffer, frame_len);
+
+        // 入队前填元数据、抓包，入队后缓冲区可能已被消费者释放
+        net_rx_meta_fill(net_packet_meta(buffer), buffer, frame_len, queue, hash, rx_ns, stamp, ts_flags);
+        net_capture_rx(net_device, buffer, frame_len);
+        net_rx_enqueue(net_device, ring, buffer, frame_len, stamp, hash);
+        notify_mask |= 1u << queue;
+        queued++;
+        bytes += frame_len;
+
+        if (net_device->callback) {
+            net_device->callback(NET_MSG_TYPE_RX_PACKET, net_device->userdata, buffer, frame_len);
+        }
+
+        // 回调看过这一帧后再按批交付，交付后缓冲区可能已被释放
+        net_dispatch_enqueued(net_device, ring);
+    }
+
+    if (queued > 0) {
+        net_gro_flush(net_device);
+        net_rx_queues_notify(net_device, notify_mask);
+        net_stat_add(&stats->rx.packets, queued);
+        net_stat_add(&stats->rx.bytes, bytes);
+        net_stats_rx_commit(net_device);
+        net_dispatch_batch_end(net_device);
+    }
+
+    return ret;
+}
+
+// 从recvmsg的控制消息取软件接收时间戳，换算到net_time_ns时钟
+static uint64_t tcp_rx_timestamp(struct msghdr *msg) {
+    for (struct cmsghdr *cm = CMSG_FIRSTHDR(msg); cm; cm = CMSG_NXTHDR(msg, cm)) {
+        if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_TIMESTAMPING) {
+            const struct scm_timestamping *tss = (const struct scm_timestamping *)CMSG_DATA(cm);
+            uint64_t real_ns = (uint64_t)tss->ts[0].tv_sec * 1000000000ULL + (uint64_t)tss->ts[0].tv_nsec;
+            return real_ns ? real_ns - (uint64_t)net_time_realtime_offset() : 0;
+        }
+    }
+
+    return 0;
+}
+
+// 缓冲区释放后调用：只有接收线程在等缓冲区时才产生一次eventfd写
+static void tcp_rx_resume(net_device_t *dev) {
+    receive_thread_t *thread = &tcp_backend(dev)->rx;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&thread->wait_buffer, __ATOMIC_SEQ_CST)) {
+        eventfd_write(thread->wake_fd, 1);
+    }
+}
+
+// 读取错误队列里的零拷贝完成通知，需持有tx_lock
+static void tcp_zc_read_errqueue(tcp_backend_t *tb) {
+#if TCP_ZEROCOPY
+    char control[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in))];
+
+    while (tb->sock >= 0) {
+        struct msghdr msg = { .msg_control = control, .msg_controllen = sizeof(control) };
+        if (recvmsg(tb->sock, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            break;
+        }
+
+        for (struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            if (cm->cmsg_level != SOL_IP || cm->cmsg_type != IP_RECVERR) {
+                continue;
+            }
+
+            struct sock_extended_err *ee = (struct sock_extended_err *)CMSG_DATA(cm);
+            if (ee->ee_errno != 0 || ee->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+
+            // 通知是区间[ee_info, ee_data]，TCP按序完成，只记录上界
+            uint32_t done = ee->ee_data + 1;
+            if ((int32_t)(done - tb->zc_done) > 0) {
+                tb->zc_done = done;
+            }
+        }
+    }
+#endif
+}
+
+// 归还已完成的零拷贝帧；all为true时不等通知全部归还（连接已关闭）
+// 回调在出锁后执行，回调里可以再次发送
+static void tcp_zc_complete(net_device_t *dev, bool all) {
+    tcp_backend_t *tb = tcp_backend(dev);
+    tcp_zc_entry_t done[TCP_ZC_COMPLETE_MAX];
+    size_t n;
+
+    do {
+        n = 0;
+        pthread_mutex_lock(&tb->tx_lock);
+        if (!all) {
+            tcp_zc_read_errqueue(tb);
+        }
+        while (n < TCP_ZC_COMPLETE_MAX && tb->zc_head != tb->zc_tail) {
+            tcp_zc_entry_t *entry = &tb->zc_pending[tb->zc_head & tb->zc_mask];
+            if (!all && (int32_t)(entry->last_id - tb->zc_done) >= 0) {
+                break;
+            }
+            done[n++] = *entry;
+            tb->zc_head++;
+        }
+        pthread_mutex_unlock(&tb->tx_lock);
+
+        for (size_t i = 0; i < n; i++) {
+            net_tx_complete(dev, done[i].buffer, done[i].length);
+        }
+    } while (n == TCP_ZC_COMPLETE_MAX);
+}
+
+// 关闭连接，未完成的零拷贝帧全部归还
+static void tcp_disconnect(net_device_t *dev) {
+    tcp_backend_t *tb = tcp_backend(dev);
+
+    pthread_mutex_lock(&tb->tx_lock);
+    if (tb->sock >= 0) {
+        close(tb->sock);
+        tb->sock = -1;
+    }
+    tb->zerocopy = false;
+    pthread_mutex_unlock(&tb->tx_lock);
+
+    tcp_zc_complete(dev, true);
+}
+
+// 接收线程发现连接断开：交给发送线程回收并重连，自己随后退出
+static void tcp_link_lost(net_device_t *dev) {
+    tcp_backend_t *tb = tcp_backend(dev);
+
+    __atomic_store_n(&tb->link_down, true, __ATOMIC_RELAXED);
+    eventfd_write(tb->tx_wake_fd, 1);
+}
+
+static void *receive_thread_func(void *arg) {
+    receive_thread_t *thread = (receive_thread_t *)arg;
+    net_device_t *net_device = thread->net_device;
+    tcp_backend_t *tb = tcp_backend(net_device);
+    struct epoll_event events[2];
+    eventfd_t value;
+    bool readable = true; // 启动时先读一次，之后由epoll通知
+    char control[CMSG_SPACE(sizeof(struct scm_timestamping))];
+
+    if (!net_device || !net_device->pool) {
+        NET_LOGE("Invalid net_device or pool");
+        return NULL;
+    }
+
+    while (thread->running) {
+        if (!readable) {
+            int n = epoll_wait(thread->epoll_fd, events, 2, -1);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perror("epoll_wait error");
+                break;
+            }
+
+            for (int i = 0; i < n; i++) {
+                if (events[i].data.fd == thread->wake_fd) {
+                    eventfd_read(thread->wake_fd, &value);
+                } else {
+                    // 零拷贝完成通知在错误队列中，以EPOLLERR报告
+                    if ((events[i].events & EPOLLERR) && tb->zerocopy) {
+                        tcp_zc_complete(net_device, false);
+                    }
+                    readable = true;
+                }
+            }
+            continue;
+        }
+
+        size_t space = 0;
+        uint8_t *wptr = net_frame_stream_write_ptr(&thread->stream, &space);
+
+        // 一次recvmsg读取尽可能多的数据，一批切出多帧
+        // 读满说明socket里可能还有数据，不回epoll直接再读
+        struct iovec iov = { .iov_base = wptr, .iov_len = space };
+        struct msghdr msg = {
+            .msg_iov = &iov,
+            .msg_iovlen = 1,
+            .msg_control = control,
+            .msg_controllen = sizeof(control),
+        };
+        ssize_t received = recvmsg(tb->sock, &msg, MSG_DONTWAIT);
+        if (received > 0) {
+            net_frame_stream_commit(&thread->stream, (size_t)received);
+            thread->rx_kernel_ns = tcp_rx_timestamp(&msg);
+            readable = ((size_t)received == space);
+        }
+        else if (received == 0 && space > 0) {
+            NET_LOGE("Server disconnected");
+            tcp_link_lost(net_device);
+            thread->running = false;
+            break;
+        }
+        else if (received < 0) {
+            readable = (errno == EINTR);
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror("recv error");
+            }
+        }
+
+        int ret = receive_dispatch_frames(thread);
+        if (ret > 0) {
+            net_stat_add(ret == 1 ? &net_device->stats->rx.stall_ring_full
+                                  : &net_device->stats->rx.stall_nobuf, 1);
+        }
+
+        // 内存池耗尽、接收环已满或过载（BLOCK策略）：挂起等待消费端，不再读socket，让TCP窗口反压对端
+        while (ret > 0 && thread->running) {
+            __atomic_store_n(&thread->wait_buffer, true, __ATOMIC_SEQ_CST);
+            // 置位后再试一次，防止置位前刚好有缓冲区释放而丢失唤醒
+            ret = receive_dispatch_frames(thread);
+            if (ret > 0) {
+                eventfd_read(thread->wake_fd, &value);
+            }
+            __atomic_store_n(&thread->wait_buffer, false, __ATOMIC_SEQ_CST);
+        }
+
+        if (ret < 0) {
+            NET_LOGE("Frame stream out of sync, closing connection");
+            net_stat_add(&net_device->stats->rx.drop_desync, 1);
+            tcp_link_lost(net_device);
+            thread->running = false;
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static int receive_thread_start(net_device_t *net_device) {
+    tcp_backend_t *tb = tcp_backend(net_device);
+    receive_thread_t *thread = &tb->rx;
+    struct epoll_event ev = { .events = EPOLLIN };
+
+    thread->net_device = net_device;
+    thread->running = true;
+    thread->wait_buffer = false;
+    thread->rx_kernel_ns = 0;
+
+    if (net_frame_stream_init(&thread->stream, NET_FRAME_STREAM_SIZE) != 0) {
+        NET_LOGE("Failed to allocate frame stream buffer");
+        return -1;
+    }
+
+    thread->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (thread->epoll_fd < 0) {
+        perror("Failed to create epoll");
+        goto err_fd;
+    }
+
+    ev.data.fd = thread->wake_fd;
+    if (epoll_ctl(thread->epoll_fd, EPOLL_CTL_ADD, thread->wake_fd, &ev) < 0) {
+        perror("epoll_ctl wake_fd failed");
+        goto err_fd;
+    }
+
+    ev.data.fd = tb->sock;
+    if (epoll_ctl(thread->epoll_fd, EPOLL_CTL_ADD, tb->sock, &ev) < 0) {
+        perror("epoll_ctl socket failed");
+        goto err_fd;
+    }
+
+    if (pthread_create(&thread->thread_id, NULL, 
+                      receive_thread_func, thread) != 0) {
+        perror("Failed to create receive thread");
+        goto err_fd;
+    }
+
+    net_thread_setup(thread->thread_id, "net-rx", net_device->rx_cpu);
+    thread->started = true;
+    return 0;
+
+err_fd:
+    if (thread->epoll_fd >= 0) {
+        close(thread->epoll_fd);
+    }
+    net_frame_stream_deinit(&thread->stream);
+    return -1;
+}
+
+static void receive_thread_stop(receive_thread_t *thread) {
+    if (!thread->started) {
+        return;
+    }
+
+    thread->running = false;
+    eventfd_write(thread->wake_fd, 1);
+    pthread_join(thread->thread_id, NULL);
+    
+    // wake_fd不在这里关闭：释放缓冲区的线程随时可能调用tcp_rx_resume写它
+    close(thread->epoll_fd);
+    net_frame_stream_deinit(&thread->stream);
+    thread->started = false;
+}
+
+// ======================================================================
+// 发送线程
+//
+// 应用线程只把帧放入多生产者队列（net_send复制到内存池块，零拷贝发送直接交出缓冲区），
+// 连接、重连、合并与写socket都在发送线程中完成，应用线程不会阻塞在网络上。
+// 发送线程一次取出队列中已有的帧，用一个sendmsg（writev语义）写出；
+// 配置了tx_flush_us时，不足一批的帧最多再等这么久攒成一批。
+// 断线期间帧留在队列中，重连成功后按原顺序继续发送。
+// ======================================================================
+
+// 连接对端，失败返回-1；需在发送线程中调用
+static int tcp_connect(net_device_t *dev) {
+    tcp_backend_t *tb = tcp_backend(dev);
+    int sock = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+
+    if (sock < 0) {
+        perror("socket creation failed");
+        return -1;
+    }
+
+    // 非阻塞连接，等待期间关闭设备可以打断
+    if (connect(sock, (struct sockaddr *)&tb->server_addr, sizeof(tb->server_addr)) < 0) {
+        struct pollfd pfd[2] = {
+            { .fd = sock,          .events = POLLOUT },
+            { .fd = tb->tx_wake_fd, .events = POLLIN },
+        };
+        int err = 0;
+        socklen_t err_len = sizeof(err);
+
+        if (errno != EINPROGRESS ||
+            poll(pfd, 2, TCP_CONNECT_TIMEOUT_MS) <= 0 || !(pfd[0].revents & (POLLOUT | POLLERR | POLLHUP)) ||
+            getsockopt(sock, SOL_SOCKET, SO_ERROR, &err, &err_len) < 0 || err != 0) {
+            NET_LOG_RATELIMITED(NET_LOGW, "Connect to %s:%d failed: %s",
+                                inet_ntoa(tb->server_addr.sin_addr), ntohs(tb->server_addr.sin_port),
+                                strerror(err ? err : errno));
+            close(sock);
+            return -1;
+        }
+    }
+
+    // 发送线程自己合并小帧，不再让Nagle把帧攒到对端ACK之后
+    int nodelay = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+    // 接收报文的内核软件时间戳，写入帧元数据；未开启或不支持时用接收线程读到数据的时间
+    if (net_rx_kernel_ts(dev)) {
+        int tsflags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        if (setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPING, &tsflags, sizeof(tsflags)) < 0) {
+            NET_LOG_RATELIMITED(NET_LOGW, "SO_TIMESTAMPING unavailable, using receive thread time");
+        }
+    }
+
+    pthread_mutex_lock(&tb->tx_lock);
+    tb->sock = sock;
+    // 通知序号按套接字计数，新连接从0开始
+    tb->zerocopy = false;
+    tb->zc_next_id = 0;
+    tb->zc_done = 0;
+#if TCP_ZEROCOPY
+    int one = 1;
+    tb->zerocopy = (setsockopt(sock, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0);
+#endif
+    pthread_mutex_unlock(&tb->tx_lock);
+
+    if (receive_thread_start(dev) != 0) {
+        tcp_disconnect(dev);
+        return -1;
+    }
+
+    NET_LOGD("Connected to server at %s:%d",
+           inet_ntoa(tb->server_addr.sin_addr), ntohs(tb->server_addr.sin_port));
+    return 0;
+}
+
+// 连接断开：回收接收线程并关闭套接字，之后由发送线程重连
+static void tcp_link_reset(net_device_t *dev) {
+    tcp_backend_t *tb = tcp_backend(dev);
+
+    receive_thread_stop(&tb->rx);
+    tcp_disconnect(dev);
+    __atomic_store_n(&tb->link_down, false, __ATOMIC_RELAXED);
+}
+
+// 发送线程等待：有新帧（idle时）、关闭或连接断开时被唤醒，timeout_ns<0一直等待
+static void tcp_tx_sleep(tcp_backend_t *tb, int64_t timeout_ns) {
+    struct pollfd pfd = { .fd = tb->tx_wake_fd, .events = POLLIN };
+    struct timespec ts = { .tv_sec = timeout_ns / 1000000000, .tv_nsec = timeout_ns % 1000000000 };
+    eventfd_t value;
+
+    if (ppoll(&pfd, 1, timeout_ns < 0 ? NULL : &ts, NULL) > 0) {
+        eventfd_read(tb->tx_wake_fd, &value);
+    }
+}
+
+// 发送msg中的全部数据，处理部分发送；套接字写满时等待可写
+// calls非NULL时返回带flags成功调用sendmsg的次数（零拷贝通知按调用计数）
+// written返回已写出的字节数，出错时据此判断哪些帧已经完整写出
+static int tcp_sendmsg_all(tcp_backend_t *tb, struct msghdr *msg, size_t remain, int flags,
+                           uint32_t *calls, size_t *written) {
+    *written = 0;
+    while (remain > 0) {
+        ssize_t sent = sendmsg(tb->sock, msg, MSG_NOSIGNAL | MSG_DONTWAIT | flags);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // 关闭设备时最多再等TCP_TX_DRAIN_MS
+                struct pollfd pfd[2] = {
+                    { .fd = tb->sock,       .events = POLLOUT },
+                    { .fd = tb->tx_wake_fd, .events = POLLIN },
+                };
+                int n = poll(pfd, tb->tx_running ? 2 : 1, tb->tx_running ? -1 : TCP_TX_DRAIN_MS);
+                if (n == 0 || (n < 0 && errno != EINTR)) {
+                    return -1;
+                }
+                if (pfd[1].revents & POLLIN) {
+                    eventfd_t value;
+                    eventfd_read(tb->tx_wake_fd, &value);
+                }
+                if (__atomic_load_n(&tb->link_down, __ATOMIC_RELAXED)) {
+                    return -1;
+                }
+                continue;
+            }
+#if TCP_ZEROCOPY
+            // 锁定页超出optmem限制，余下部分改为复制发送
+            if (errno == ENOBUFS && (flags & MSG_ZEROCOPY)) {
+                flags &= ~MSG_ZEROCOPY;
+                continue;
+            }
+#endif
+            return -1;
+        }
+        if (calls && flags) {
+            (*calls)++;
+        }
+
+        // 部分发送：跳过已发出的iov
+        remain -= (size_t)sent;
+        *written += (size_t)sent;
+        while (msg->msg_iovlen > 0 && (size_t)sent >= msg->msg_iov->iov_len) {
+            sent -= (ssize_t)msg->msg_iov->iov_len;
+            msg->msg_iov++;
+            msg->msg_iovlen--;
+        }
+        if (msg->msg_iovlen > 0) {
+            msg->msg_iov->iov_base = (uint8_t *)msg->msg_iov->iov_base + sent;
+            msg->msg_iov->iov_len -= (size_t)sent;
+        }
+    }
+
+    return 0;
+}
+
+// 一帧写出后归还：复制帧释放回内存池，零拷贝帧交还调用者
+static void tcp_tx_item_done(net_device_t *dev, const tcp_tx_item_t *item) {
+    if (item->copy) {
+        net_packet_free(dev, item->buffer);
+    } else {
+        net_tx_complete(dev, item->buffer, item->length);
+    }
+}
+
+static inline bool tcp_tx_item_zerocopy(const tcp_backend_t *tb, const tcp_tx_item_t *item) {
+    return !item->copy && item->length >= TCP_ZEROCOPY_MIN && tb->zerocopy;
+}
+
+// 大帧用MSG_ZEROCOPY单独发送，收到完成通知后才归还
+// 返回 0：已提交；1：在途表已满，改走复制发送；-1：连接出错，帧未写出；
+//      -2：连接出错，帧只写出一部分，已放入在途表等通知（或断开时）归还，计为发送错误
+static int tcp_tx_send_zerocopy(net_device_t *dev, tcp_tx_item_t *item) {
+    tcp_backend_t *tb = tcp_backend(dev);
+    const size_t fcs_len = tcp_tx_fcs_len(tb);
+    uint32_t calls = 0;
+    size_t written;
+
+    // 顺带回收已完成的帧，接收线程等待缓冲区时通知也不会积压
+    tcp_zc_complete(dev, false);
+
+    pthread_mutex_lock(&tb->tx_lock);
+    if (tb->zc_tail - tb->zc_head > tb->zc_mask) {
+        pthread_mutex_unlock(&tb->tx_lock);
+        return 1;
+    }
+
+    tcp_zc_entry_t *entry = &tb->zc_pending[tb->zc_tail & tb->zc_mask];
+    struct iovec iov[3];
+    struct msghdr msg = { .msg_iov = iov };
+    msg.msg_iovlen = (size_t)tcp_frame_iov(iov, entry->hdr, entry->fcs, item->buffer, item->length, fcs_len);
+
+    NET_LOGD("Sending %zu bytes to server (zerocopy)", item->length);
+    int ret = tcp_sendmsg_all(tb, &msg, NET_FRAME_HDR_LEN + item->length + fcs_len, MSG_ZEROCOPY, &calls, &written);
+
+    // 只要有一次零拷贝调用成功，内核就可能还引用着缓冲区，必须等通知；
+    // 写了一半的帧在新连接上不能续写，也不能在归还前重发
+    if (calls > 0) {
+        entry->buffer = item->buffer;
+        entry->length = item->length;
+        tb->zc_next_id += calls;
+        entry->last_id = tb->zc_next_id - 1;
+        tb->zc_tail++;
+        if (ret < 0) {
+            ret = -2;
+        }
+    }
+    pthread_mutex_unlock(&tb->tx_lock);
+
+    if (ret == -2) {
+        NET_LOG_RATELIMITED(NET_LOGW, "Zerocopy frame torn by send error (%zu of %zu bytes written)",
+                            written, NET_FRAME_HDR_LEN + item->length + fcs_len);
+        net_stat_add_shared(&dev->stats->tx.errors, 1);
+    }
+    return ret;
+}
+
+// 写出当前批次；出错时已完整写出的帧归还，其余帧留在批次中等重连后重发
+// （写了一半的零拷贝帧除外，见tcp_tx_send_zerocopy），返回-1由发送线程重连
+static int tcp_tx_flush(net_device_t *dev) {
+    tcp_backend_t *tb = tcp_backend(dev);
+    const size_t fcs_len = tcp_tx_fcs_len(tb);
+    const int n = tb->batch_nr;
+    bool failed = false;
+    int i = 0;
+
+    while (i < n) {
+        if (tcp_tx_item_zerocopy(tb, &tb->batch[i])) {
+            int ret = tcp_tx_send_zerocopy(dev, &tb->batch[i]);
+            if (ret == 0) {
+                i++;
+                continue;
+            }
+            if (ret < 0) {
+                // 写了一半的帧已交给在途表，不留在批次中
+                if (ret == -2) {
+                    i++;
+                }
+                failed = true;
+                break;
+            }
+        }
+
+        // 连续的非零拷贝帧合并成一次sendmsg
+        int j = i;
+        int iovcnt = 0;
+        size_t total = 0;
+        do {
+            iovcnt += tcp_frame_iov(&tb->iov[iovcnt], tb->batch_hdr[j], tb->batch_fcs[j],
+                                    tb->batch[j].buffer, tb->batch[j].length, fcs_len);
+            total += NET_FRAME_HDR_LEN + tb->batch[j].length + fcs_len;
+            j++;
+        } while (j < n && !tcp_tx_item_zerocopy(tb, &tb->batch[j]));
+
+        NET_LOGD("Sending %d frames (%zu bytes) to server", j - i, total);
+
+        struct msghdr msg = { .msg_iov = tb->iov, .msg_iovlen = (size_t)iovcnt };
+        size_t written;
+        int ret = tcp_sendmsg_all(tb, &msg, total, 0, NULL, &written);
+
+        while (i < j && written >= NET_FRAME_HDR_LEN + tb->batch[i].length + fcs_len) {
+            written -= NET_FRAME_HDR_LEN + tb->batch[i].length + fcs_len;
+            tcp_tx_item_done(dev, &tb->batch[i]);
+            i++;
+        }
+        if (ret < 0) {
+            failed = true;
+            break;
+        }
+    }
+
+    // 未写出的帧移到批次开头
+    tb->batch_nr = n - i;
+    memmove(tb->batch, &tb->batch[i], (size_t)tb->batch_nr * sizeof(tcp_tx_item_t));
+    return failed ? -1 : 0;
+}
+
+// 从队列取帧补满批次，队列为空时挂起；返回批次中的帧数
+static int tcp_tx_collect(tcp_backend_t *tb) {
+    tcp_tx_queue_t *q = &tb->txq;
+
+    tb->batch_nr += (int)tcp_txq_dequeue(q, &tb->batch[tb->batch_nr], (size_t)(TCP_TX_BATCH - tb->batch_nr));
+    if (tb->batch_nr == 0) {
+        // 置位后再查一次，防止置位前刚好入队而丢失唤醒
+        __atomic_store_n(&q->state, TCP_TX_IDLE, __ATOMIC_SEQ_CST);
+        if (tcp_txq_count(q) == 0 && tb->tx_running && !__atomic_load_n(&tb->link_down, __ATOMIC_RELAXED)) {
+            tcp_tx_sleep(tb, -1);
+        }
+        __atomic_store_n(&q->state, TCP_TX_BUSY, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    // 不足一批时等到刷新期限，或者入队的帧够一批
+    if (tb->tx_flush_ns > 0 && tb->batch_nr < TCP_TX_BATCH && tb->tx_running) {
+        uint64_t deadline = net_stats_now_ns() + tb->tx_flush_ns;
+
+        __atomic_store_n(&q->state, TCP_TX_LINGER, __ATOMIC_SEQ_CST);
+        while (tcp_txq_count(q) < (size_t)(TCP_TX_BATCH - tb->batch_nr) && tb->tx_running) {
+            uint64_t now = net_stats_now_ns();
+            if (now >= deadline) {
+                break;
+            }
+            tcp_tx_sleep(tb, (int64_t)(deadline - now));
+        }
+        __atomic_store_n(&q->state, TCP_TX_BUSY, __ATOMIC_RELAXED);
+
+        tb->batch_nr += (int)tcp_txq_dequeue(q, &tb->batch[tb->batch_nr], (size_t)(TCP_TX_BATCH - tb->batch_nr));
+    }
+
+    return tb->batch_nr;
+}
+
+// 关闭时还没发出的帧直接归还
+static void tcp_tx_discard(net_device_t *dev) {
+    tcp_backend_t *tb = tcp_backend(dev);
+    uint64_t dropped = 0;
+
+    do {
+        for (int i = 0; i < tb->batch_nr; i++) {
+            tcp_tx_item_done(dev, &tb->batch[i]);
+        }
+        dropped += (uint64_t)tb->batch_nr;
+        tb->batch_nr = (int)tcp_txq_dequeue(&tb->txq, tb->batch, TCP_TX_BATCH);
+    } while (tb->batch_nr > 0);
+
+    if (dropped > 0) {
+        NET_LOGW("Discarded %llu unsent frames", (unsigned long long)dropped);
+        net_stat_add_shared(&dev->stats->tx.errors, dropped);
+    }
+}
+
+static void *tcp_tx_thread_func(void *arg) {
+    net_device_t *dev = (net_device_t *)arg;
+    tcp_backend_t *tb = tcp_backend(dev);
+    uint32_t backoff_ms = TCP_RECONNECT_MIN_MS;
+
+    while (tb->tx_running) {
+        if (__atomic_load_n(&tb->link_down, __ATOMIC_RELAXED)) {
+            tcp_link_reset(dev);
+        }
+
+        // 断线期间帧留在队列里，退避后重连
+        if (tb->sock < 0) {
+            if (tcp_connect(dev) != 0) {
+                tcp_tx_sleep(tb, (int64_t)backoff_ms * 1000000);
+                backoff_ms = backoff_ms * 2 < TCP_RECONNECT_MAX_MS ? backoff_ms * 2 : TCP_RECONNECT_MAX_MS;
+                continue;
+            }
+            backoff_ms = TCP_RECONNECT_MIN_MS;
+        }
+
+        if (tcp_tx_collect(tb) > 0 && tcp_tx_flush(dev) != 0) {
+            NET_LOG_RATELIMITED(NET_LOGW, "Send failed, reconnecting (%d frames kept)", tb->batch_nr);
+            __atomic_store_n(&tb->link_down, true, __ATOMIC_RELAXED);
+        }
+    }
+
+    // 关闭设备：连接正常时把队列中剩余的帧发完，每次写最多等TCP_TX_DRAIN_MS
+    while (tb->sock >= 0 && !__atomic_load_n(&tb->link_down, __ATOMIC_RELAXED) &&
+           tcp_tx_collect(tb) > 0 && tcp_tx_flush(dev) == 0) {
+    }
+    tcp_tx_discard(dev);
+    return NULL;
+}
+
+// 入队后调用：发送线程空闲，或在等刷新期限而队列已够一批时才唤醒
+static void tcp_tx_kick(tcp_backend_t *tb) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    uint32_t state = __atomic_load_n(&tb->txq.state, __ATOMIC_RELAXED);
+    if (state == TCP_TX_IDLE || (state == TCP_TX_LINGER && tcp_txq_count(&tb->txq) >= TCP_TX_BATCH)) {
+        eventfd_write(tb->tx_wake_fd, 1);
+    }
+}
+
+// 应用线程入队；copy为true时先复制到内存池块
+// 返回入队的帧数（遇到非法帧或内存池耗尽时只入队之前的部分），一帧都没有时返回-1
+static int tcp_tx_enqueue(net_device_t *dev, uint8_t **data, const size_t *lengths, int count, bool copy) {
+    tcp_backend_t *tb = tcp_backend(dev);
+    const size_t fcs_len = tcp_tx_fcs_len(tb);
+    tcp_tx_item_t items[NET_BURST_MAX];
+    int queued = 0;
+
+    while (queued < count) {
+        int n = 0;
+
+        while (n < NET_BURST_MAX && queued + n < count) {
+            uint8_t *buffer = data[queued + n];
+            size_t length = lengths[queued + n];
+
+            if (length == 0 || length + fcs_len > NET_FRAME_MAX_LEN) {
+                NET_LOGE("Invalid frame length: %zu", length);
+                count = queued + n;
+                break;
+            }
+            if (copy) {
+                buffer = net_packet_alloc(dev, length);
+                if (!buffer) {
+                    net_stat_add_shared(&dev->stats->tx.drop_nobuf, 1);
+                    count = queued + n;
+                    break;
+                }
+                memcpy(buffer, data[queued + n], length);
+            }
+
+            items[n].buffer = buffer;
+            items[n].length = (uint32_t)length;
+            items[n].copy = copy;
+            n++;
+        }
+
+        if (n == 0) {
+            break;
+        }
+
+        if (tcp_txq_enqueue(&tb->txq, items, (size_t)n) != 0) {
+            NET_LOG_RATELIMITED(NET_LOGW, "TX queue full");
+            if (copy) {
+                for (int i = 0; i < n; i++) {
+                    net_packet_free(dev, items[i].buffer);
+                }
+            }
+            break;
+        }
+        queued += n;
+        tcp_tx_kick(tb);
+    }
+
+    return queued > 0 ? queued : -1;
+}
+
+// ======================================================================
+// 修改后的硬件模拟接口
+// ======================================================================
+
+// 复制后入队，返回即可复用data
+static int hw_simulate_send(net_device_t *dev, const uint8_t *data, size_t length) {
+    uint8_t *frames[1] = { (uint8_t *)data };
+
+    NET_LOGD("Queueing %zu bytes to server", length);
+    NET_HEX_DUMP(data, length);
+
+    return tcp_tx_enqueue(dev, frames, &length, 1, true) == 1 ? 0 : -1;
+}
+
+static int hw_simulate_send_burst(net_device_t *dev, uint8_t **data, const size_t *lengths, int count) {
+    return tcp_tx_enqueue(dev, data, lengths, count, true);
+}
+
+// 分散发送：各段直接拼进内存池块，和复制发送一样由发送线程写出后释放
+static int hw_simulate_sendv(net_device_t *dev, const net_iovec_t *iov, int count, size_t length) {
+    tcp_backend_t *tb = tcp_backend(dev);
+
+    if (length == 0 || length + tcp_tx_fcs_len(tb) > NET_FRAME_MAX_LEN) {
+        NET_LOGE("Invalid frame length: %zu", length);
+        return -1;
+    }
+
+    uint8_t *buffer = net_packet_alloc(dev, length);
+    if (!buffer) {
+        net_stat_add_shared(&dev->stats->tx.drop_nobuf, 1);
+        return -1;
+    }
+    net_iov_gather(buffer, iov, count);
+
+    tcp_tx_item_t item = { .buffer = buffer, .length = (uint32_t)length, .copy = true };
+    if (tcp_txq_enqueue(&tb->txq, &item, 1) != 0) {
+        NET_LOG_RATELIMITED(NET_LOGW, "TX queue full");
+        net_packet_free(dev, buffer);
+        return -1;
+    }
+    tcp_tx_kick(tb);
+    return 0;
+}
+
+static void hw_simulate_send_isr(net_device_t *net_device, uint8_t *buffer, size_t length) {
+    net_tx_complete(net_device, buffer, length);
+}
+
+// 零拷贝发送：缓冲区直接入队，写出（大帧等到MSG_ZEROCOPY完成通知）后归还
+static int tcp_send_zerocpy(net_device_t *dev, uint8_t *buffer, size_t length) {
+    if (tcp_tx_enqueue(dev, &buffer, &length, 1, false) != 1) {
+        hw_simulate_send_isr(dev, buffer, length);
+        return -1;
+    }
+    return 0;
+}
+
+// 解析 "ip:port"，省略时使用默认对端
+static int tcp_parse_remote(const char *remote, struct sockaddr_in *addr) {
+    char ip[INET_ADDRSTRLEN] = PYTHON_SERVER_IP;
+    int port = PYTHON_SERVER_PORT;
+
+    if (remote) {
+        const char *colon = strrchr(remote, ':');
+        size_t ip_len = colon ? (size_t)(colon - remote) : strlen(remote);
+
+        if (ip_len >= sizeof(ip)) {
+            return -1;
+        }
+        if (ip_len > 0) {
+            memcpy(ip, remote, ip_len);
+            ip[ip_len] = '\0';
+        }
+        if (colon) {
+            port = atoi(colon + 1);
+        }
+    }
+
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons((uint16_t)port);
+    if (port <= 0 || port > 65535 || inet_pton(AF_INET, ip, &addr->sin_addr) != 1) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static void tcp_backend_free(tcp_backend_t *tb) {
+    if (tb->tx_wake_fd >= 0) {
+        close(tb->tx_wake_fd);
+    }
+    if (tb->rx.wake_fd >= 0) {
+        close(tb->rx.wake_fd);
+    }
+    pthread_mutex_destroy(&tb->tx_lock);
+    tcp_txq_deinit(&tb->txq);
+    free(tb->zc_pending);
+    free(tb);
+}
+
+static int tcp_open(net_device_t *dev) {
+    tcp_backend_t *tb = (tcp_backend_t *)aligned_alloc(NET_CACHE_LINE, sizeof(tcp_backend_t));
+    if (!tb) {
+        NET_LOGE("Failed to allocate tcp backend");
+        return -1;
+    }
+
+    memset(tb, 0, sizeof(tcp_backend_t));
+    tb->sock = -1;
+    tb->tx_wake_fd = -1;
+    tb->rx.wake_fd = -1;
+    tb->csum_flags = net_csum_flags(dev);
+    tb->tx_flush_ns = (uint64_t)net_tx_flush_us(dev) * 1000;
+    pthread_mutex_init(&tb->tx_lock, NULL);
+    if (tcp_parse_remote(dev->remote, &tb->server_addr) != 0) {
+        NET_LOGE("Invalid remote address: %s", dev->remote);
+        tcp_backend_free(tb);
+        return -1;
+    }
+
+    // 每个在途零拷贝帧、每个排队的帧都占一个内存池块，按池容量分配即不会溢出
+    size_t zc_size = 1;
+    while (zc_size < dev->pool->capacity) {
+        zc_size <<= 1;
+    }
+    tb->zc_pending = (tcp_zc_entry_t *)calloc(zc_size, sizeof(tcp_zc_entry_t));
+    if (!tb->zc_pending || tcp_txq_init(&tb->txq, dev->pool->capacity) != 0) {
+        NET_LOGE("Failed to allocate tx queues");
+        tcp_backend_free(tb);
+        return -1;
+    }
+    tb->zc_mask = zc_size - 1;
+
+    tb->tx_wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    tb->rx.wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (tb->tx_wake_fd < 0 || tb->rx.wake_fd < 0) {
+        perror("eventfd failed");
+        tcp_backend_free(tb);
+        return -1;
+    }
+
+    dev->backend_priv = tb;
+
+    // 连接由发送线程建立，对端未就绪不影响初始化，期间发送的帧排队等待
+    tb->tx_running = true;
+    if (pthread_create(&tb->tx_thread, NULL, tcp_tx_thread_func, dev) != 0) {
+        perror("Failed to create send thread");
+        dev->backend_priv = NULL;
+        tcp_backend_free(tb);
+        return -1;
+    }
+    net_thread_setup(tb->tx_thread, "net-tx", NET_CPU_NONE);
+    return 0;
+}
+
+static void tcp_close(net_device_t *dev) {
+    tcp_backend_t *tb = tcp_backend(dev);
+    if (!tb) {
+        return;
+    }
+
+    // 发送线程先发完队列中的帧再退出
+    tb->tx_running = false;
+    eventfd_write(tb->tx_wake_fd, 1);
+    pthread_join(tb->tx_thread, NULL);
+
+    receive_thread_stop(&tb->rx);
+    tcp_disconnect(dev);
+
+    dev->backend_priv = NULL;
+    tcp_backend_free(tb);
+}
+
+const net_backend_t net_backend_tcp = {
+    .name        = "tcp",
+    .open        = tcp_open,
+    .close       = tcp_close,
+    .send        = hw_simulate_send,
+    .send_burst  = hw_simulate_send_burst,
+    .sendv       = hw_simulate_sendv,
+    .send_zerocpy = tcp_send_zerocpy,
+    .buffer_free = NULL,
+    .rx_resume   = tcp_rx_resume,
+};
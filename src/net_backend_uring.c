@@ -0,0 +1,1032 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "net_device.h"
+#include "net_backend.h"
+#include "net_ring.h"
+#include "net_capture.h"
+#include "net_stats.h"
+#include "net_csum.h"
+#include "net_classifier.h"
+#include "net_backpressure.h"
+#include "net_dispatch.h"
+#include "net_gro.h"
+#include "net_pool.h"
+
+// ======================================================================
+// io_uring 后端（Linux 真实以太网，需要 6.0 以上内核）
+//
+// 接收：从内存池取一批块注册为提供缓冲区环（IORING_REGISTER_PBUF_RING），
+// 在AF_PACKET socket上挂一个多发recv（IORING_RECV_MULTISHOT），内核每收到
+// 一帧就自己挑一块写入并产生一个完成项，不再一帧一次系统调用；
+// 放入接收队列的就是这块内存，使用者net_packet_free直接回到内存池，
+// 接收线程再申请新块补回缓冲区环。内存池耗尽时缓冲区环见底，多发recv
+// 以ENOBUFS结束，内核丢包，有块归还后重新挂上。
+//
+// 发送：每帧一个IORING_OP_SEND提交项，一批帧只进一次内核；完成项由接收
+// 线程收割，零拷贝发送的缓冲区此时经ops.tx_callback归还。
+//
+// 接收线程是完成队列唯一的消费者；提交队列由发送者与接收线程共用，加锁。
+// io_uring不可用（内核太旧、被禁用）时open失败，设备退回AF_PACKET后端。
+// ======================================================================
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <net/if.h>
+#include <net/ethernet.h>
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+
+#if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+#define URING_SUPPORTED     1
+#else
+#define URING_SUPPORTED     0
+#endif
+
+#if URING_SUPPORTED
+
+#define URING_SQ_DEPTH          256     // 提交队列深度，也是在途发送上限
+#define URING_RX_BUFS_MAX       1024    // 提供缓冲区环最多项数
+#define URING_RX_BUFS_MIN       8
+#define URING_BGID              0       // 缓冲区组号
+#define URING_TX_DRAIN_MS       200     // 关闭时等待在途发送完成
+#define URING_SOCK_RCVBUF       (4 * 1024 * 1024) // 缓冲区暂时见底时由socket接收队列缓冲
+
+// 完成项user_data：小整数为控制项，否则为URING_TAG_MAX加发送槽号
+// 发送槽里存缓冲区地址（缓存行对齐），最低位标记设备复制的副本
+#define URING_TAG_RECV          1
+#define URING_TAG_WAKE          2
+#define URING_TAG_CANCEL        3
+#define URING_TAG_MAX           64
+#define URING_TX_COPY           1ULL
+
+typedef struct {
+    uint32_t *head;
+    uint32_t *tail;
+    uint32_t mask;
+    uint32_t entries;
+    struct io_uring_sqe *sqes;
+    uint32_t sqe_tail;          // 本地尾，写完提交项后发布到*tail
+} uring_sq_t;
+
+typedef struct {
+    uint32_t *head;
+    uint32_t *tail;
+    uint32_t mask;
+    struct io_uring_cqe *cqes;
+} uring_cq_t;
+
+// 已收到、还没放进接收队列的帧
+typedef struct {
+    uint16_t bid;
+    uint32_t length;
+    uint64_t stamp;
+} uring_rx_item_t;
+
+typedef struct {
+    net_device_t *dev;
+    int fd;                     // AF_PACKET socket
+    int ifindex;
+    uint32_t csum_flags;        // NET_CSUM_xxx，只支持NET_CSUM_RX_L4
+
+    int ring_fd;
+    void *sq_map;
+    size_t sq_map_size;
+    void *cq_map;               // 单次映射时与sq_map相同
+    size_t cq_map_size;
+    size_t sqe_map_size;
+    uring_sq_t sq;
+    uring_cq_t cq;
+    pthread_mutex_t sq_lock;    // 串行化提交队列的写入与提交
+    uint32_t tx_inflight;       // 已提交未完成的发送
+    uint64_t *tx_slots;         // 在途发送，容量sq.entries，0为空闲；关闭时据此归还没等到完成的缓冲区
+    uint32_t tx_slot_next;      // 下一次从这里找空闲槽，需持有sq_lock
+
+    // 提供缓冲区环，缓冲区号即br_bufs下标
+    struct io_uring_buf_ring *br;
+    size_t br_size;
+    uint32_t br_entries;
+    uint16_t br_tail;           // 本地尾，补回后发布
+    uint32_t br_avail;          // 内核手里的缓冲区数
+    uint32_t buf_len;
+    uint8_t **br_bufs;          // 接收线程持有的块，交给使用者后置NULL
+    uint16_t *br_empty;         // 缺块的缓冲区号
+    uint32_t br_empty_nr;
+    bool recv_armed;
+    bool wake_armed;
+
+    uring_rx_item_t *backlog;   // 环形，容量br_entries
+    uint32_t backlog_head;
+    uint32_t backlog_nr;
+
+    volatile bool running;
+    pthread_t thread_id;
+    int wake_fd;                // eventfd：停止线程、队列有空位或缓冲区归还时唤醒
+    bool wait_queue;            // 接收线程在等消费端取走报文或归还缓冲区
+
+    uint64_t kernel_drops;
+} uring_backend_t;
+
+static inline uring_backend_t *uring_backend(net_device_t *dev) {
+    return (uring_backend_t *)dev->backend_priv;
+}
+
+static int uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags, void *arg, size_t argsz) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, argsz);
+}
+
+// ---------------------------------------------------------------- 提交队列
+
+// 取一个空闲提交项，需持有sq_lock，队列满时返回NULL
+static struct io_uring_sqe *uring_get_sqe(uring_backend_t *ub) {
+    uring_sq_t *sq = &ub->sq;
+
+    if (sq->sqe_tail - __atomic_load_n(sq->head, __ATOMIC_ACQUIRE) >= sq->entries) {
+        return NULL;
+    }
+
+    struct io_uring_sqe *sqe = &sq->sqes[sq->sqe_tail & sq->mask];
+    memset(sqe, 0, sizeof(*sqe));
+    sq->sqe_tail++;
+    return sqe;
+}
+
+// 发布并提交所有未提交的项，需持有sq_lock
+static int uring_submit(uring_backend_t *ub) {
+    uring_sq_t *sq = &ub->sq;
+
+    __atomic_store_n(sq->tail, sq->sqe_tail, __ATOMIC_RELEASE);
+    uint32_t pending = sq->sqe_tail - __atomic_load_n(sq->head, __ATOMIC_ACQUIRE);
+    if (pending == 0) {
+        return 0;
+    }
+
+    int ret;
+    do {
+        ret = uring_enter(ub->ring_fd, pending, 0, 0, NULL, 0);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+static void uring_prep_recv(struct io_uring_sqe *sqe, int fd) {
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BGID;
+    sqe->user_data = URING_TAG_RECV;
+}
+
+static void uring_prep_wake(struct io_uring_sqe *sqe, int fd) {
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = URING_TAG_WAKE;
+}
+
+// 接收线程重新挂上多发recv与唤醒poll
+static void uring_arm(uring_backend_t *ub) {
+    bool recv = !ub->recv_armed && ub->br_avail > 0;
+    bool wake = !ub->wake_armed;
+
+    if (!recv && !wake) {
+        return;
+    }
+
+    pthread_mutex_lock(&ub->sq_lock);
+    if (recv) {
+        struct io_uring_sqe *sqe = uring_get_sqe(ub);
+        if (sqe) {
+            uring_prep_recv(sqe, ub->fd);
+            ub->recv_armed = true;
+        }
+    }
+    if (wake) {
+        struct io_uring_sqe *sqe = uring_get_sqe(ub);
+        if (sqe) {
+            uring_prep_wake(sqe, ub->wake_fd);
+            ub->wake_armed = true;
+        }
+    }
+    if (uring_submit(ub) < 0) {
+        perror("io_uring submit failed");
+    }
+    pthread_mutex_unlock(&ub->sq_lock);
+}
+
+// ---------------------------------------------------------------- 提供缓冲区环
+
+static void uring_buf_push(uring_backend_t *ub, uint16_t bid) {
+    struct io_uring_buf *buf = &ub->br->bufs[ub->br_tail & (ub->br_entries - 1)];
+
+    buf->addr = (uint64_t)(uintptr_t)ub->br_bufs[bid];
+    buf->len = ub->buf_len;
+    buf->bid = bid;
+    ub->br_tail++;
+    ub->br_avail++;
+}
+
+static inline void uring_buf_publish(uring_backend_t *ub) {
+    __atomic_store_n(&ub->br->tail, ub->br_tail, __ATOMIC_RELEASE);
+}
+
+// 给交出去的缓冲区号申请新块补回环中，返回是否已补齐
+static bool uring_buf_refill(uring_backend_t *ub) {
+    net_device_t *dev = ub->dev;
+    uint32_t added = 0;
+
+    while (ub->br_empty_nr > 0) {
+        uint8_t *block = net_pool_alloc(dev->pool, ub->buf_len);
+        if (!block) {
+            break;
+        }
+        uint16_t bid = ub->br_empty[--ub->br_empty_nr];
+        ub->br_bufs[bid] = block;
+        uring_buf_push(ub, bid);
+        added++;
+    }
+
+    if (added > 0) {
+        net_stat_add(&dev->stats->rx.pool_alloc, added);
+        uring_buf_publish(ub);
+    }
+    return ub->br_empty_nr == 0;
+}
+
+// ---------------------------------------------------------------- 完成队列
+
+static void uring_tx_done(uring_backend_t *ub, uint32_t slot, int res) {
+    net_device_t *dev = ub->dev;
+    uint64_t entry = ub->tx_slots[slot];
+    uint8_t *buffer = (uint8_t *)(uintptr_t)(entry & ~URING_TX_COPY);
+
+    // 先清槽再减计数：提交端看到计数小于容量时一定能找到空槽
+    __atomic_store_n(&ub->tx_slots[slot], 0, __ATOMIC_RELEASE);
+    __atomic_sub_fetch(&ub->tx_inflight, 1, __ATOMIC_RELEASE);
+    if (res < 0) {
+        NET_LOG_RATELIMITED(NET_LOGW, "io_uring send failed: %s", strerror(-res));
+        net_stat_add_shared(&dev->stats->tx.errors, 1);
+    }
+
+    if (entry & URING_TX_COPY) {
+        net_packet_free(dev, buffer);
+    } else {
+        net_tx_complete(dev, buffer, net_packet_meta(buffer)->length);
+    }
+}
+
+// 收割完成项：接收的帧移入backlog，发送完成的缓冲区归还
+static void uring_reap(uring_backend_t *ub) {
+    uring_cq_t *cq = &ub->cq;
+    uint32_t head = *cq->head;
+    uint32_t tail = __atomic_load_n(cq->tail, __ATOMIC_ACQUIRE);
+    uint64_t stamp = net_stats_now_ns();
+    eventfd_t value;
+
+    while (head != tail) {
+        const struct io_uring_cqe *cqe = &cq->cqes[head & cq->mask];
+        uint64_t user_data = cqe->user_data;
+        int res = cqe->res;
+        uint32_t flags = cqe->flags;
+
+        head++;
+
+        if (user_data >= URING_TAG_MAX) {
+            uring_tx_done(ub, (uint32_t)(user_data - URING_TAG_MAX), res);
+        } else if (user_data == URING_TAG_RECV) {
+            if (flags & IORING_CQE_F_BUFFER) {
+                uring_rx_item_t *item = &ub->backlog[(ub->backlog_head + ub->backlog_nr) & (ub->br_entries - 1)];
+                item->bid = (uint16_t)(flags >> IORING_CQE_BUFFER_SHIFT);
+                item->length = res > 0 ? (uint32_t)res : 0;
+                item->stamp = stamp;
+                ub->backlog_nr++;
+                ub->br_avail--;
+            }
+            if (!(flags & IORING_CQE_F_MORE)) {
+                // 缓冲区用完（ENOBUFS）或出错，补回缓冲区后重新挂上
+                ub->recv_armed = false;
+                if (res < 0 && res != -ENOBUFS && res != -ECANCELED) {
+                    NET_LOG_RATELIMITED(NET_LOGW, "io_uring recv failed: %s", strerror(-res));
+                }
+            }
+        } else if (user_data == URING_TAG_WAKE) {
+            eventfd_read(ub->wake_fd, &value);
+            if (!(flags & IORING_CQE_F_MORE)) {
+                ub->wake_armed = false;
+            }
+        }
+    }
+
+    __atomic_store_n(cq->head, head, __ATOMIC_RELEASE);
+}
+
+// 帧不交给使用者，块原样放回缓冲区环
+static inline void uring_rx_recycle(uring_backend_t *ub, uint16_t bid) {
+    uring_buf_push(ub, bid);
+}
+
+// 把backlog中的帧分类后放入各接收队列
+// 返回 0：已处理完；1：接收队列已满或过载（BLOCK策略）
+static int uring_dispatch_frames(uring_backend_t *ub) {
+    net_device_t *dev = ub->dev;
+    const bool overloaded = net_backpressure_update(dev, true);
+    size_t queued = 0;
+    size_t bytes = 0;
+    size_t recycled = 0;
+    uint32_t notify_mask = 0;
+    int ret = 0;
+
+    while (ub->backlog_nr > 0) {
+        const uring_rx_item_t *item = &ub->backlog[ub->backlog_head];
+        uint16_t bid = item->bid;
+        uint8_t *frame = ub->br_bufs[bid];
+        size_t length = item->length;
+        uint64_t stamp = item->stamp;
+
+        // 超过缓冲区的帧已被截断
+        if (length < ETH_HLEN || length >= ub->buf_len) {
+            NET_LOG_RATELIMITED(NET_LOGW, "Drop frame of %zu bytes", length);
+            net_stat_add(&dev->stats->rx.drop_oversize, 1);
+            uring_rx_recycle(ub, bid);
+            recycled++;
+            goto next;
+        }
+
+        if ((ub->csum_flags & NET_CSUM_RX_L4) && net_csum_verify_l4(frame, length) != 0) {
+            NET_LOG_RATELIMITED(NET_LOGW, "Drop frame with bad checksum (%zu bytes)", length);
+            net_stat_add(&dev->stats->rx.drop_csum, 1);
+            uring_rx_recycle(ub, bid);
+            recycled++;
+            goto next;
+        }
+
+        uint32_t hash = 0;
+        int queue = net_classify_rx(dev, frame, length, &hash);
+        if (queue < 0) {
+            uring_rx_recycle(ub, bid);
+            recycled++;
+            goto next;
+        }
+
+        net_ring_t *ring = net_rx_queue(dev, queue);
+        hash = net_gro_prepare(dev, ring, frame, length, hash);
+        if ((overloaded || net_ring_free_count(ring) == 0) && net_backpressure_drop_new(dev)) {
+            uring_rx_recycle(ub, bid);
+            recycled++;
+            goto next;
+        }
+        if (net_backpressure_block(dev, overloaded) || net_ring_free_count(ring) == 0) {
+            ret = 1;
+            break;
+        }
+
+        net_rx_meta_fill(net_packet_meta(frame), frame, length, queue, hash, stamp, stamp, 0);
+        net_packet_meta(frame)->ingress_port = (uint16_t)ub->ifindex;
+
+        // 块交给使用者，缓冲区号等待补新块
+        ub->br_bufs[bid] = NULL;
+        ub->br_empty[ub->br_empty_nr++] = bid;
+
+        NET_LOGD("Received %zu bytes from %s", length, dev->ifname);
+        net_capture_rx(dev, frame, length);
+        net_rx_enqueue(dev, ring, frame, length, stamp, hash);
+        notify_mask |= 1u << queue;
+        queued++;
+        bytes += length;
+
+        if (dev->callback) {
+            dev->callback(NET_MSG_TYPE_RX_PACKET, dev->userdata, frame, length);
+        }
+
+        // 回调看过这一帧后再按批交付，交付后缓冲区可能已被释放
+        net_dispatch_enqueued(dev, ring);
+
+next:
+        ub->backlog_head = (ub->backlog_head + 1) & (ub->br_entries - 1);
+        ub->backlog_nr--;
+    }
+
+    if (recycled > 0) {
+        uring_buf_publish(ub);
+    }
+    if (queued > 0) {
+        net_gro_flush(dev);
+        net_rx_queues_notify(dev, notify_mask);
+        net_stat_add(&dev->stats->rx.packets, queued);
+        net_stat_add(&dev->stats->rx.bytes, bytes);
+        net_stats_rx_commit(dev);
+        net_dispatch_batch_end(dev);
+    }
+
+    return ret;
+}
+
+static void uring_rx_resume(net_device_t *dev) {
+    uring_backend_t *ub = uring_backend(dev);
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ub->wait_queue, __ATOMIC_SEQ_CST)) {
+        eventfd_write(ub->wake_fd, 1);
+    }
+}
+
+// 处理一轮完成项，返回 0：无事可等；1：接收队列满；2：内存池耗尽
+static int uring_poll_once(uring_backend_t *ub) {
+    uring_reap(ub);
+    int ret = uring_dispatch_frames(ub);
+    // 补不上块且内核手里已没有缓冲区时才算暂停
+    if (!uring_buf_refill(ub) && ub->br_avail == 0 && ret == 0) {
+        ret = 2;
+    }
+    uring_arm(ub);
+    return ret;
+}
+
+// 等待在途发送完成，最多timeout_ms
+static void uring_tx_wait(uring_backend_t *ub, uint32_t timeout_ms) {
+    struct __kernel_timespec ts = { .tv_sec = 0, .tv_nsec = 10 * 1000000L };
+    struct io_uring_getevents_arg arg = { .ts = (uint64_t)(uintptr_t)&ts };
+    uint32_t waited = 0;
+
+    while (__atomic_load_n(&ub->tx_inflight, __ATOMIC_ACQUIRE) > 0 && waited < timeout_ms) {
+        uring_enter(ub->ring_fd, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+        uring_reap(ub);
+        waited += 10;
+    }
+}
+
+// 关闭时收尾发送：等在途发送最多URING_TX_DRAIN_MS，超时则取消socket上的全部请求，
+// 仍没有完成项的发送按失败归还，零拷贝缓冲区一样经net_tx_complete交还调用者
+static void uring_tx_drain(uring_backend_t *ub) {
+    uring_tx_wait(ub, URING_TX_DRAIN_MS);
+    if (__atomic_load_n(&ub->tx_inflight, __ATOMIC_ACQUIRE) == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&ub->sq_lock);
+    struct io_uring_sqe *sqe = uring_get_sqe(ub);
+    if (sqe) {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = ub->fd;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data = URING_TAG_CANCEL;
+        uring_submit(ub);
+    }
+    pthread_mutex_unlock(&ub->sq_lock);
+    uring_tx_wait(ub, URING_TX_DRAIN_MS);
+
+    uint32_t aborted = 0;
+    for (uint32_t i = 0; i < ub->sq.entries; i++) {
+        if (__atomic_load_n(&ub->tx_slots[i], __ATOMIC_ACQUIRE)) {
+            uring_tx_done(ub, i, -ECANCELED);
+            aborted++;
+        }
+    }
+    if (aborted > 0) {
+        NET_LOGW("io_uring close: %u sends did not complete", aborted);
+    }
+}
+
+static void *uring_rx_thread_func(void *arg) {
+    uring_backend_t *ub = (uring_backend_t *)arg;
+    net_device_t *dev = ub->dev;
+
+    while (ub->running) {
+        int ret = uring_poll_once(ub);
+
+        if (ret > 0) {
+            net_stat_add(ret == 1 ? &dev->stats->rx.stall_ring_full : &dev->stats->rx.stall_nobuf, 1);
+
+            // 接收队列满或缓冲区全在使用者手里：等消费端唤醒，期间照常收割发送完成
+            while (ret > 0 && ub->running) {
+                __atomic_store_n(&ub->wait_queue, true, __ATOMIC_SEQ_CST);
+                // 置位后再试一次，防止置位前刚好有缓冲区释放而丢失唤醒
+                ret = uring_poll_once(ub);
+                if (ret > 0 && uring_enter(ub->ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+                    errno != EINTR) {
+                    perror("io_uring wait failed");
+                    ub->running = false;
+                }
+                __atomic_store_n(&ub->wait_queue, false, __ATOMIC_SEQ_CST);
+            }
+            continue;
+        }
+
+        if (uring_enter(ub->ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR) {
+            perror("io_uring wait failed");
+            break;
+        }
+    }
+
+    uring_tx_drain(ub);
+    return NULL;
+}
+
+// ---------------------------------------------------------------- 发送
+
+// 一批帧各占一个SEND提交项，一次io_uring_enter提交，返回提交的帧数
+static int uring_tx_submit(net_device_t *dev, uint8_t **buffers, const size_t *lengths, int count, bool copy) {
+    uring_backend_t *ub = uring_backend(dev);
+    int n = 0;
+
+    pthread_mutex_lock(&ub->sq_lock);
+    while (n < count && __atomic_load_n(&ub->tx_inflight, __ATOMIC_RELAXED) < ub->sq.entries) {
+        struct io_uring_sqe *sqe = uring_get_sqe(ub);
+        if (!sqe) {
+            break;
+        }
+
+        // 在途数小于容量，必有空槽；完成基本按序，通常第一个就是
+        uint32_t slot = ub->tx_slot_next;
+        while (__atomic_load_n(&ub->tx_slots[slot], __ATOMIC_ACQUIRE)) {
+            slot = (slot + 1) & ub->sq.mask;
+        }
+        ub->tx_slot_next = (slot + 1) & ub->sq.mask;
+        ub->tx_slots[slot] = (uint64_t)(uintptr_t)buffers[n] | (copy ? URING_TX_COPY : 0);
+
+        net_packet_meta(buffers[n])->length = (uint32_t)lengths[n];
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = ub->fd;
+        sqe->addr = (uint64_t)(uintptr_t)buffers[n];
+        sqe->len = (uint32_t)lengths[n];
+        sqe->user_data = URING_TAG_MAX + slot;
+        __atomic_add_fetch(&ub->tx_inflight, 1, __ATOMIC_RELAXED);
+        n++;
+    }
+    if (n > 0 && uring_submit(ub) < 0) {
+        // 提交项留在队列里，下一次提交时一并进入内核
+        NET_LOG_RATELIMITED(NET_LOGW, "io_uring submit failed: %s", strerror(errno));
+    }
+    pthread_mutex_unlock(&ub->sq_lock);
+
+    return n;
+}
+
+// 复制到内存池块后提交，返回提交的帧数，一帧都未提交返回-1
+static int uring_send_copy(net_device_t *dev, uint8_t **data, const size_t *lengths, int count) {
+    uint8_t *buffers[NET_BURST_MAX];
+    size_t lens[NET_BURST_MAX];
+    int sent = 0;
+
+    while (sent < count) {
+        int n = 0;
+
+        while (n < NET_BURST_MAX && sent + n < count) {
+            size_t length = lengths[sent + n];
+
+            if (length < ETH_HLEN || length > net_pool_max_size(dev->pool)) {
+                NET_LOGE("Invalid frame length: %zu", length);
+                count = sent + n;
+                break;
+            }
+            buffers[n] = net_packet_alloc(dev, length);
+            if (!buffers[n]) {
+                net_stat_add_shared(&dev->stats->tx.drop_nobuf, 1);
+                count = sent + n;
+                break;
+            }
+            memcpy(buffers[n], data[sent + n], length);
+            lens[n] = length;
+            n++;
+        }
+
+        if (n == 0) {
+            break;
+        }
+
+        int submitted = uring_tx_submit(dev, buffers, lens, n, true);
+        for (int i = submitted; i < n; i++) {
+            net_packet_free(dev, buffers[i]);
+        }
+        sent += submitted;
+        if (submitted < n) {
+            NET_LOG_RATELIMITED(NET_LOGW, "io_uring send queue full");
+            break;
+        }
+    }
+
+    return sent > 0 ? sent : -1;
+}
+
+static int uring_send(net_device_t *dev, const uint8_t *data, size_t length) {
+    uint8_t *frames[1] = { (uint8_t *)data };
+
+    NET_LOGD("Sending %zu bytes to %s", length, dev->ifname);
+    return uring_send_copy(dev, frames, &length, 1) == 1 ? 0 : -1;
+}
+
+static int uring_send_burst(net_device_t *dev, uint8_t **data, const size_t *lengths, int count) {
+    return uring_send_copy(dev, data, lengths, count);
+}
+
+// 分散发送：各段直接拼进内存池块，按复制发送提交
+static int uring_sendv(net_device_t *dev, const net_iovec_t *iov, int count, size_t length) {
+    if (length < ETH_HLEN || length > net_pool_max_size(dev->pool)) {
+        NET_LOGE("Invalid frame length: %zu", length);
+        return -1;
+    }
+
+    uint8_t *buffer = net_packet_alloc(dev, length);
+    if (!buffer) {
+        net_stat_add_shared(&dev->stats->tx.drop_nobuf, 1);
+        return -1;
+    }
+    net_iov_gather(buffer, iov, count);
+
+    if (uring_tx_submit(dev, &buffer, &length, 1, true) != 1) {
+        NET_LOG_RATELIMITED(NET_LOGW, "io_uring send queue full");
+        net_packet_free(dev, buffer);
+        return -1;
+    }
+    return 0;
+}
+
+// 零拷贝发送：缓冲区直接提交，完成项收割时归还
+static int uring_send_zerocpy(net_device_t *dev, uint8_t *buffer, size_t length) {
+    if (length < ETH_HLEN || uring_tx_submit(dev, &buffer, &length, 1, false) != 1) {
+        net_tx_complete(dev, buffer, length);
+        return -1;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------- 建立/关闭
+
+// 内核需要支持多发recv（与IORING_OP_SEND_ZC同在6.0加入）
+static bool uring_probe(int ring_fd) {
+    size_t size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = (struct io_uring_probe *)calloc(1, size);
+    bool ok = false;
+
+    if (!probe) {
+        return false;
+    }
+    if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+        ok = probe->last_op >= IORING_OP_SEND_ZC &&
+             (probe->ops[IORING_OP_RECV].flags & IO_URING_OP_SUPPORTED) &&
+             (probe->ops[IORING_OP_SEND].flags & IO_URING_OP_SUPPORTED) &&
+             (probe->ops[IORING_OP_POLL_ADD].flags & IO_URING_OP_SUPPORTED);
+    }
+    free(probe);
+    return ok;
+}
+
+static int uring_setup_ring(uring_backend_t *ub) {
+    struct io_uring_params p;
+
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_CQSIZE;
+    // 完成队列容纳所有缓冲区的接收完成与满队列的发送完成，不会溢出
+    p.cq_entries = 2 * (ub->br_entries + URING_SQ_DEPTH);
+
+    ub->ring_fd = (int)syscall(__NR_io_uring_setup, URING_SQ_DEPTH, &p);
+    if (ub->ring_fd < 0) {
+        NET_LOGW("io_uring_setup failed: %s", strerror(errno));
+        return -1;
+    }
+    if (!(p.features & IORING_FEAT_EXT_ARG) || !uring_probe(ub->ring_fd)) {
+        NET_LOGW("io_uring lacks multishot recv support");
+        return -1;
+    }
+
+    ub->sq_map_size = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+    ub->cq_map_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ub->cq_map_size > ub->sq_map_size) {
+            ub->sq_map_size = ub->cq_map_size;
+        }
+        ub->cq_map_size = ub->sq_map_size;
+    }
+
+    ub->sq_map = mmap(NULL, ub->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ub->ring_fd, IORING_OFF_SQ_RING);
+    if (ub->sq_map == MAP_FAILED) {
+        perror("io_uring sq mmap failed");
+        return -1;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        ub->cq_map = ub->sq_map;
+    } else {
+        ub->cq_map = mmap(NULL, ub->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ub->ring_fd, IORING_OFF_CQ_RING);
+        if (ub->cq_map == MAP_FAILED) {
+            perror("io_uring cq mmap failed");
+            return -1;
+        }
+    }
+
+    ub->sqe_map_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    ub->sq.sqes = mmap(NULL, ub->sqe_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ub->ring_fd, IORING_OFF_SQES);
+    if (ub->sq.sqes == MAP_FAILED) {
+        perror("io_uring sqe mmap failed");
+        ub->sq.sqes = NULL;
+        return -1;
+    }
+
+    uint8_t *sq_base = (uint8_t *)ub->sq_map;
+    uint8_t *cq_base = (uint8_t *)ub->cq_map;
+    ub->sq.head = (uint32_t *)(sq_base + p.sq_off.head);
+    ub->sq.tail = (uint32_t *)(sq_base + p.sq_off.tail);
+    ub->sq.mask = *(uint32_t *)(sq_base + p.sq_off.ring_mask);
+    ub->sq.entries = p.sq_entries;
+    ub->sq.sqe_tail = *ub->sq.tail;
+    ub->cq.head = (uint32_t *)(cq_base + p.cq_off.head);
+    ub->cq.tail = (uint32_t *)(cq_base + p.cq_off.tail);
+    ub->cq.mask = *(uint32_t *)(cq_base + p.cq_off.ring_mask);
+    ub->cq.cqes = (struct io_uring_cqe *)(cq_base + p.cq_off.cqes);
+
+    // 提交项下标与环位置一一对应
+    uint32_t *array = (uint32_t *)(sq_base + p.sq_off.array);
+    for (uint32_t i = 0; i < p.sq_entries; i++) {
+        array[i] = i;
+    }
+
+    return 0;
+}
+
+// 从内存池取块填满提供缓冲区环并注册
+static int uring_setup_buffers(uring_backend_t *ub) {
+    ub->br_size = ub->br_entries * sizeof(struct io_uring_buf);
+    ub->br = mmap(NULL, ub->br_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ub->br == MAP_FAILED) {
+        perror("io_uring buffer ring mmap failed");
+        ub->br = NULL;
+        return -1;
+    }
+
+    ub->br_bufs = (uint8_t **)calloc(ub->br_entries, sizeof(uint8_t *));
+    ub->br_empty = (uint16_t *)calloc(ub->br_entries, sizeof(uint16_t));
+    ub->backlog = (uring_rx_item_t *)calloc(ub->br_entries, sizeof(uring_rx_item_t));
+    if (!ub->br_bufs || !ub->br_empty || !ub->backlog) {
+        NET_LOGE("Failed to allocate io_uring buffer state");
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < ub->br_entries; i++) {
+        ub->br_empty[ub->br_empty_nr++] = (uint16_t)(ub->br_entries - 1 - i);
+    }
+    if (!uring_buf_refill(ub)) {
+        NET_LOGE("Memory pool too small for %u io_uring buffers", ub->br_entries);
+        return -1;
+    }
+
+    struct io_uring_buf_reg reg = {
+        .ring_addr = (uint64_t)(uintptr_t)ub->br,
+        .ring_entries = ub->br_entries,
+        .bgid = URING_BGID,
+    };
+    if (syscall(__NR_io_uring_register, ub->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        NET_LOGW("IORING_REGISTER_PBUF_RING failed: %s", strerror(errno));
+        return -1;
+    }
+
+    return 0;
+}
+
+// 缓冲区环项数：最大等级一半的块，取2的幂
+static uint32_t uring_rx_bufs(const net_pool_t *pool) {
+    uint32_t count = pool->classes[pool->class_nr - 1].count / 2;
+    uint32_t entries = URING_RX_BUFS_MAX;
+
+    while (entries > count) {
+        entries >>= 1;
+    }
+    return entries;
+}
+
+static void uring_release(uring_backend_t *ub) {
+    net_device_t *dev = ub->dev;
+
+    if (ub->br && ub->ring_fd >= 0) {
+        // 注销后内核不再从环中取缓冲区，块可以安全归还
+        struct io_uring_buf_reg reg = { .bgid = URING_BGID };
+        syscall(__NR_io_uring_register, ub->ring_fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    }
+    if (ub->ring_fd >= 0) {
+        close(ub->ring_fd);
+    }
+    if (ub->br_bufs) {
+        uint32_t freed = 0;
+        for (uint32_t i = 0; i < ub->br_entries; i++) {
+            if (ub->br_bufs[i]) {
+                net_pool_free(dev->pool, ub->br_bufs[i]);
+                freed++;
+            }
+        }
+        net_stat_add_shared(&dev->stats->app.pool_free, freed);
+    }
+    if (ub->sq.sqes) {
+        munmap(ub->sq.sqes, ub->sqe_map_size);
+    }
+    if (ub->cq_map && ub->cq_map != MAP_FAILED && ub->cq_map != ub->sq_map) {
+        munmap(ub->cq_map, ub->cq_map_size);
+    }
+    if (ub->sq_map && ub->sq_map != MAP_FAILED) {
+        munmap(ub->sq_map, ub->sq_map_size);
+    }
+    if (ub->br) {
+        munmap(ub->br, ub->br_size);
+    }
+    if (ub->fd >= 0) {
+        close(ub->fd);
+    }
+    if (ub->wake_fd >= 0) {
+        close(ub->wake_fd);
+    }
+    pthread_mutex_destroy(&ub->sq_lock);
+    free(ub->tx_slots);
+    free(ub->br_bufs);
+    free(ub->br_empty);
+    free(ub->backlog);
+    free(ub);
+}
+
+static int uring_open(net_device_t *dev) {
+    if (!dev->ifname) {
+        NET_LOGE("NET_MODE_ETH requires ifname");
+        return -1;
+    }
+
+    uring_backend_t *ub = (uring_backend_t *)calloc(1, sizeof(uring_backend_t));
+    if (!ub) {
+        NET_LOGE("Failed to allocate io_uring backend");
+        return -1;
+    }
+
+    ub->dev = dev;
+    ub->csum_flags = net_csum_flags(dev);
+    ub->fd = -1;
+    ub->ring_fd = -1;
+    ub->wake_fd = -1;
+    ub->buf_len = (uint32_t)net_pool_max_size(dev->pool);
+    ub->br_entries = uring_rx_bufs(dev->pool);
+    pthread_mutex_init(&ub->sq_lock, NULL);
+
+    if (ub->br_entries < URING_RX_BUFS_MIN) {
+        NET_LOGW("Largest pool class too small for io_uring buffers");
+        goto err;
+    }
+
+    ub->ifindex = (int)if_nametoindex(dev->ifname);
+    if (ub->ifindex == 0) {
+        NET_LOGE("Unknown interface: %s", dev->ifname);
+        goto err;
+    }
+
+    if (uring_setup_ring(ub) != 0) {
+        goto err;
+    }
+
+    ub->tx_slots = (uint64_t *)calloc(ub->sq.entries, sizeof(uint64_t));
+    if (!ub->tx_slots) {
+        NET_LOGE("Failed to allocate io_uring send slots");
+        goto err;
+    }
+
+    ub->fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(ETH_P_ALL));
+    if (ub->fd < 0) {
+        perror("packet socket creation failed (need CAP_NET_RAW)");
+        goto err;
+    }
+
+#ifdef PACKET_IGNORE_OUTGOING
+    // 不接收本socket所在主机发出的帧
+    int one = 1;
+    setsockopt(ub->fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
+#endif
+
+    // 提供缓冲区远少于TPACKET环的帧数，突发期间帧先排在socket接收队列里
+    int rcvbuf = URING_SOCK_RCVBUF;
+    if (setsockopt(ub->fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) < 0) {
+        setsockopt(ub->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+
+    struct sockaddr_ll addr = {
+        .sll_family = AF_PACKET,
+        .sll_protocol = htons(ETH_P_ALL),
+        .sll_ifindex = ub->ifindex,
+    };
+    if (bind(ub->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("packet bind failed");
+        goto err;
+    }
+
+    // 模拟设备有自己的MAC，需要混杂模式才能收到发给它的帧，socket关闭时自动恢复
+    struct packet_mreq mreq = {
+        .mr_ifindex = ub->ifindex,
+        .mr_type = PACKET_MR_PROMISC,
+    };
+    if (setsockopt(ub->fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        perror("PACKET_MR_PROMISC failed");
+    }
+
+    ub->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (ub->wake_fd < 0) {
+        perror("Failed to create eventfd");
+        goto err;
+    }
+
+    if (uring_setup_buffers(ub) != 0) {
+        goto err;
+    }
+
+    dev->backend_priv = ub;
+    uring_arm(ub);
+    if (!ub->recv_armed || !ub->wake_armed) {
+        NET_LOGE("Failed to arm io_uring receive");
+        dev->backend_priv = NULL;
+        goto err;
+    }
+
+    ub->running = true;
+    if (pthread_create(&ub->thread_id, NULL, uring_rx_thread_func, ub) != 0) {
+        perror("Failed to create io_uring receive thread");
+        dev->backend_priv = NULL;
+        goto err;
+    }
+    net_thread_setup(ub->thread_id, "net-rx", dev->rx_cpu);
+
+    NET_LOGI("Opened %s with io_uring, %u rx buffers x %u bytes", dev->ifname, ub->br_entries, ub->buf_len);
+    return 0;
+
+err:
+    uring_release(ub);
+    return -1;
+}
+
+static void uring_stats(net_device_t *dev, net_device_stats_t *stats) {
+    uring_backend_t *ub = uring_backend(dev);
+    struct tpacket_stats st;
+    socklen_t len = sizeof(st);
+
+    if (!ub) {
+        return;
+    }
+
+    if (getsockopt(ub->fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) == 0) {
+        __atomic_fetch_add(&ub->kernel_drops, st.tp_drops, __ATOMIC_RELAXED);
+    }
+    stats->rx_drop_kernel = __atomic_load_n(&ub->kernel_drops, __ATOMIC_RELAXED);
+}
+
+static void uring_close(net_device_t *dev) {
+    uring_backend_t *ub = uring_backend(dev);
+    if (!ub) {
+        return;
+    }
+
+    ub->running = false;
+    eventfd_write(ub->wake_fd, 1);
+    pthread_join(ub->thread_id, NULL);
+
+    dev->backend_priv = NULL;
+    uring_release(ub);
+}
+
+#else
+
+static int uring_open(net_device_t *dev) {
+    (void)dev;
+    NET_LOGW("Built without io_uring multishot recv support");
+    return -1;
+}
+
+static void uring_close(net_device_t *dev) {
+    (void)dev;
+}
+
+#define uring_send          NULL
+#define uring_send_burst    NULL
+#define uring_sendv         NULL
+#define uring_send_zerocpy  NULL
+#define uring_rx_resume     NULL
+#define uring_stats         NULL
+
+#endif
+
+const net_backend_t net_backend_uring = {
+    .name         = "io_uring",
+    .open         = uring_open,
+    .close        = uring_close,
+    .send         = uring_send,
+    .send_burst   = uring_send_burst,
+    .sendv        = uring_sendv,
+    .send_zerocpy = uring_send_zerocpy,
+    .rx_resume    = uring_rx_resume,
+    .stats        = uring_stats,
+    .fallback     = &net_backend_packet,
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "net_device.h"
+#include "net_backpressure.h"
+#include "net_classifier.h"
+#include "net_stats.h"
+
+net_backpressure_t *net_backpressure_create(uint8_t policy, uint8_t high_pct, uint8_t low_pct) {
+    if (policy > NET_RX_POLICY_DROP_OLD) {
+        NET_LOGE("Invalid rx policy: %u", policy);
+        return NULL;
+    }
+    if (high_pct == 0 || high_pct > 100 || low_pct >= high_pct) {
+        NET_LOGE("Invalid rx watermarks: high %u%% low %u%%", high_pct, low_pct);
+        return NULL;
+    }
+
+    net_backpressure_t *bp = (net_backpressure_t *)calloc(1, sizeof(net_backpressure_t));
+    if (!bp) {
+        return NULL;
+    }
+
+    bp->policy = policy;
+    bp->high_pct = high_pct;
+    bp->low_pct = low_pct;
+    return bp;
+}
+
+void net_backpressure_destroy(net_backpressure_t *bp) {
+    free(bp);
+}
+
+// 内存池与各接收队列占用百分比的最大值
+static uint32_t net_backpressure_level(net_device_t *dev, bool rx_pool) {
+    net_classifier_t *cls = dev->classifier;
+    uint32_t level = 0;
+
+    if (rx_pool && dev->stats->pool_capacity) {
+        level = (uint32_t)((uint64_t)net_stats_pool_in_use(dev->stats) * 100 / dev->stats->pool_capacity);
+    }
+
+    for (uint32_t i = 0; i < cls->queue_nr; i++) {
+        net_ring_t *ring = cls->queues[i];
+        uint32_t pct = (uint32_t)(net_ring_count(ring) * 100 / ring->capacity);
+        if (pct > level) {
+            level = pct;
+        }
+    }
+
+    return level;
+}
+
+bool net_backpressure_update(net_device_t *dev, bool rx_pool) {
+    net_backpressure_t *bp = dev->backpressure;
+    uint32_t level = net_backpressure_level(dev, rx_pool);
+
+    if (!bp->overloaded && level >= bp->high_pct) {
+        __atomic_store_n(&bp->overloaded, true, __ATOMIC_RELAXED);
+        net_stat_add(&dev->stats->rx.overload, 1);
+        NET_LOGD("Receive overloaded: %u%% in use", level);
+        if (dev->callback) {
+            dev->callback(NET_MSG_TYPE_RX_OVERLOAD, dev->userdata, NULL, level);
+        }
+    } else if (bp->overloaded && level <= bp->low_pct) {
+        __atomic_store_n(&bp->overloaded, false, __ATOMIC_RELAXED);
+        if (dev->callback) {
+            dev->callback(NET_MSG_TYPE_RX_RECOVER, dev->userdata, NULL, level);
+        }
+    }
+
+    return bp->overloaded;
+}
@@ -0,0 +1,64 @@
+#ifndef NET_BACKPRESSURE_H
+#define NET_BACKPRESSURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "net_device.h"
+#include "net_stats.h"
+
+// ======================================================================
+// 接收过载控制（内部使用）
+//
+// 接收线程每批开始时计算一次占用（不在每帧上读使用者的缓存行），
+// 按高/低水位带滞回地切换过载状态，切换时通过dev->callback通知使用者。
+// 过载期间：
+//   BLOCK    —— 后端停止接收，直到使用者释放缓冲区使占用回落
+//   DROP_NEW —— 后端丢弃新帧，继续读取，队列中的帧排队时间有上界
+//   DROP_OLD —— 后端照常入队（满时暂停），接收接口把队列修剪到低水位，
+//               丢掉最旧的帧（接收环是单生产者/单消费者，只能在消费端丢）
+// ======================================================================
+
+typedef struct net_backpressure {
+    uint8_t policy;             // NET_RX_POLICY_xxx
+    uint8_t high_pct;
+    uint8_t low_pct;
+    bool overloaded;            // 接收线程写，使用者线程读
+} net_backpressure_t;
+
+net_backpressure_t *net_backpressure_create(uint8_t policy, uint8_t high_pct, uint8_t low_pct);
+void net_backpressure_destroy(net_backpressure_t *bp);
+
+// 接收线程每批开始时调用，返回当前是否过载
+// rx_pool为true表示后端接收使用内存池，占用才计入内存池
+bool net_backpressure_update(net_device_t *dev, bool rx_pool);
+
+// 过载或缓冲区不足时由后端调用：DROP_NEW计数后返回true（丢弃该帧），
+// 其他策略返回false（暂停接收）
+static inline bool net_backpressure_drop_new(net_device_t *dev) {
+    if (dev->backpressure->policy != NET_RX_POLICY_DROP_NEW) {
+        return false;
+    }
+
+    net_stat_add(&dev->stats->rx.drop_overload, 1);
+    return true;
+}
+
+// 过载时后端是否应暂停接收
+static inline bool net_backpressure_block(const net_device_t *dev, bool overloaded) {
+    return overloaded && dev->backpressure->policy == NET_RX_POLICY_BLOCK;
+}
+
+// 使用者取帧前调用，DROP_OLD过载时返回需要修剪的帧数
+static inline size_t net_backpressure_trim_count(const net_device_t *dev, const net_ring_t *ring) {
+    const net_backpressure_t *bp = dev->backpressure;
+
+    if (bp->policy != NET_RX_POLICY_DROP_OLD || !__atomic_load_n(&bp->overloaded, __ATOMIC_RELAXED)) {
+        return 0;
+    }
+
+    size_t count = net_ring_count(ring);
+    size_t keep = ring->capacity * bp->low_pct / 100;
+    return count > keep ? count - keep : 0;
+}
+
+#endif
@@ -0,0 +1,360 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "net_device.h"
+#include "net_backend.h"
+#include "net_capture.h"
+
+// ======================================================================
+// pcapng 抓包
+//
+// 双缓冲写入：收发线程在自旋锁内把 EPB 块拷贝进当前缓冲区，
+// 缓冲区写满后交换，由后台刷写线程一次 write 整块落盘；
+// 刷写跟不上时丢弃新帧并计数，收发线程从不等待磁盘。
+// ======================================================================
+
+#define NET_CAPTURE_BUF_SIZE    (4 * 1024 * 1024)  // 单个缓冲区大小
+#define NET_CAPTURE_SNAPLEN     65535
+#define NET_CAPTURE_FLUSH_MS    100                // 未写满的缓冲区最长滞留时间
+
+#define PCAPNG_BLOCK_SHB        0x0A0D0D0A
+#define PCAPNG_BLOCK_IDB        0x00000001
+#define PCAPNG_BLOCK_EPB        0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define PCAPNG_LINKTYPE_ETHERNET 1
+#define PCAPNG_OPT_ENDOFOPT     0
+#define PCAPNG_OPT_IF_NAME      2
+#define PCAPNG_OPT_IF_TSRESOL   9
+#define PCAPNG_OPT_EPB_FLAGS    2
+
+// EPB固定部分 + epb_flags选项 + 结束选项 + 尾部长度
+#define PCAPNG_EPB_OVERHEAD     (28 + 8 + 4 + 4)
+
+struct net_capture {
+    bool active;                    // 必须是第一个字段，见 net_capture_active
+    int fd;
+    pthread_spinlock_t lock;
+
+    uint8_t *buf[2];
+    size_t used;                    // 当前缓冲区已写字节
+    size_t pending;                 // 待刷写缓冲区的字节数，0表示空闲
+    int cur;                        // 当前写入的缓冲区
+
+    pthread_t thread_id;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool running;
+
+    uint64_t packets;
+    uint64_t dropped;
+};
+
+static inline uint32_t pcapng_pad4(size_t length) {
+    return (uint32_t)((4 - (length & 3)) & 3);
+}
+
+static void net_capture_flush_fd(int fd, const uint8_t *buf, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, buf, length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            NET_LOGE("Capture write failed: %d", errno);
+            return;
+        }
+        buf += n;
+        length -= (size_t)n;
+    }
+}
+
+// 交换缓冲区，需持有自旋锁；另一个缓冲区还在刷写时返回-1
+static int net_capture_swap_locked(net_capture_t *capture) {
+    if (capture->pending != 0 || capture->used == 0) {
+        return -1;
+    }
+
+    capture->pending = capture->used;
+    capture->cur ^= 1;
+    capture->used = 0;
+    return 0;
+}
+
+// 是否不用等就该刷写：写者已交换出待写缓冲区，或上次刷写期间当前缓冲区已写过半
+static bool net_capture_ready(net_capture_t *capture) {
+    pthread_spin_lock(&capture->lock);
+    bool ready = capture->pending != 0 || capture->used >= NET_CAPTURE_BUF_SIZE / 2;
+    pthread_spin_unlock(&capture->lock);
+    return ready;
+}
+
+static void *net_capture_thread_func(void *arg) {
+    net_capture_t *capture = (net_capture_t *)arg;
+
+    pthread_mutex_lock(&capture->mutex);
+    while (capture->running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += NET_CAPTURE_FLUSH_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        // 写者交换缓冲区后持互斥锁通知，这里持锁复查后再等，通知不会丢；
+        // 没有待刷数据时等到期限，再交换未写满的缓冲区
+        int rc = 0;
+        while (capture->running && rc != ETIMEDOUT && !net_capture_ready(capture)) {
+            rc = pthread_cond_timedwait(&capture->cond, &capture->mutex, &deadline);
+        }
+
+        // 超时时主动交换未写满的缓冲区
+        pthread_spin_lock(&capture->lock);
+        net_capture_swap_locked(capture);
+        size_t pending = capture->pending;
+        int index = capture->cur ^ 1;
+        pthread_spin_unlock(&capture->lock);
+
+        if (pending) {
+            pthread_mutex_unlock(&capture->mutex);
+            net_capture_flush_fd(capture->fd, capture->buf[index], pending);
+            pthread_mutex_lock(&capture->mutex);
+
+            pthread_spin_lock(&capture->lock);
+            capture->pending = 0;
+            pthread_spin_unlock(&capture->lock);
+        }
+    }
+    pthread_mutex_unlock(&capture->mutex);
+
+    return NULL;
+}
+
+void net_capture_write(net_capture_t *capture, int dir, const uint8_t *data, size_t length) {
+    struct timespec ts;
+    uint32_t cap_len = length > NET_CAPTURE_SNAPLEN ? NET_CAPTURE_SNAPLEN : (uint32_t)length;
+    uint32_t pad = pcapng_pad4(cap_len);
+    uint32_t total = PCAPNG_EPB_OVERHEAD + cap_len + pad;
+    bool kick = false;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+
+    pthread_spin_lock(&capture->lock);
+    if (!capture->active) {
+        pthread_spin_unlock(&capture->lock);
+        return;
+    }
+
+    if (capture->used + total > NET_CAPTURE_BUF_SIZE) {
+        if (net_capture_swap_locked(capture) != 0) {
+            capture->dropped++;
+            pthread_spin_unlock(&capture->lock);
+            return;
+        }
+        kick = true;
+    }
+
+    uint8_t *p = capture->buf[capture->cur] + capture->used;
+    uint32_t hdr[7] = {
+        PCAPNG_BLOCK_EPB, total, 0,
+        (uint32_t)(ns >> 32), (uint32_t)ns,
+        cap_len, (uint32_t)length,
+    };
+    memcpy(p, hdr, sizeof(hdr));
+    p += sizeof(hdr);
+    memcpy(p, data, cap_len);
+    memset(p + cap_len, 0, pad);
+    p += cap_len + pad;
+
+    uint32_t tail[4] = {
+        PCAPNG_OPT_EPB_FLAGS | (4u << 16), (uint32_t)dir,
+        PCAPNG_OPT_ENDOFOPT, total,
+    };
+    memcpy(p, tail, sizeof(tail));
+
+    capture->used += total;
+    capture->packets++;
+    pthread_spin_unlock(&capture->lock);
+
+    if (kick) {
+        pthread_mutex_lock(&capture->mutex);
+        pthread_cond_signal(&capture->cond);
+        pthread_mutex_unlock(&capture->mutex);
+    }
+}
+
+// 写SHB与IDB
+static int net_capture_write_header(int fd, const char *ifname) {
+    uint8_t buf[256];
+    size_t off = 0;
+    uint32_t u32;
+    uint16_t u16;
+
+    // Section Header Block
+    uint32_t shb[7] = { PCAPNG_BLOCK_SHB, 28, PCAPNG_BYTE_ORDER_MAGIC, 0x00000001, 0xFFFFFFFF, 0xFFFFFFFF, 28 };
+    memcpy(buf, shb, sizeof(shb));
+    off = sizeof(shb);
+
+    // Interface Description Block
+    size_t idb_start = off;
+    size_t name_len = ifname ? strlen(ifname) : 0;
+    if (name_len > 64) {
+        name_len = 64;
+    }
+
+    u32 = PCAPNG_BLOCK_IDB;
+    memcpy(buf + off, &u32, 4);
+    off += 8; // 总长度稍后回填
+    u16 = PCAPNG_LINKTYPE_ETHERNET;
+    memcpy(buf + off, &u16, 2);
+    u16 = 0;
+    memcpy(buf + off + 2, &u16, 2);
+    u32 = NET_CAPTURE_SNAPLEN;
+    memcpy(buf + off + 4, &u32, 4);
+    off += 8;
+
+    if (name_len) {
+        u32 = PCAPNG_OPT_IF_NAME | ((uint32_t)name_len << 16);
+        memcpy(buf + off, &u32, 4);
+        memcpy(buf + off + 4, ifname, name_len);
+        memset(buf + off + 4 + name_len, 0, pcapng_pad4(name_len));
+        off += 4 + name_len + pcapng_pad4(name_len);
+    }
+
+    // 时间戳精度：纳秒
+    u32 = PCAPNG_OPT_IF_TSRESOL | (1u << 16);
+    memcpy(buf + off, &u32, 4);
+    memset(buf + off + 4, 0, 4);
+    buf[off + 4] = 9;
+    off += 8;
+
+    u32 = PCAPNG_OPT_ENDOFOPT;
+    memcpy(buf + off, &u32, 4);
+    off += 4;
+
+    u32 = (uint32_t)(off + 4 - idb_start);
+    memcpy(buf + idb_start + 4, &u32, 4);
+    memcpy(buf + off, &u32, 4);
+    off += 4;
+
+    net_capture_flush_fd(fd, buf, off);
+    return 0;
+}
+
+int net_capture_start(net_device_t *dev, const char *path) {
+    net_capture_t *capture = dev->capture;
+
+    if (capture && capture->active) {
+        NET_LOGE("Capture already running");
+        return -1;
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        NET_LOGE("Failed to open capture file %s: %d", path, errno);
+        return -1;
+    }
+
+    // 抓包状态在设备上只分配一次，停止后复用，避免与收发线程竞争释放
+    if (!capture) {
+        capture = (net_capture_t *)calloc(1, sizeof(net_capture_t));
+        if (!capture) {
+            close(fd);
+            return -1;
+        }
+
+        capture->buf[0] = (uint8_t *)malloc(NET_CAPTURE_BUF_SIZE);
+        capture->buf[1] = (uint8_t *)malloc(NET_CAPTURE_BUF_SIZE);
+        if (!capture->buf[0] || !capture->buf[1]) {
+            free(capture->buf[0]);
+            free(capture->buf[1]);
+            free(capture);
+            close(fd);
+            NET_LOGE("Failed to allocate capture buffers");
+            return -1;
+        }
+
+        pthread_spin_init(&capture->lock, PTHREAD_PROCESS_PRIVATE);
+        pthread_mutex_init(&capture->mutex, NULL);
+        pthread_cond_init(&capture->cond, NULL);
+        dev->capture = capture;
+    }
+
+    net_capture_write_header(fd, dev->ifname ? dev->ifname : dev->remote);
+
+    capture->fd = fd;
+    capture->used = 0;
+    capture->pending = 0;
+    capture->cur = 0;
+    capture->packets = 0;
+    capture->dropped = 0;
+    capture->running = true;
+
+    if (pthread_create(&capture->thread_id, NULL, net_capture_thread_func, capture) != 0) {
+        NET_LOGE("Failed to create capture thread");
+        capture->running = false;
+        capture->fd = -1;
+        close(fd);
+        return -1;
+    }
+    net_thread_setup(capture->thread_id, "net-cap", NET_CPU_NONE);
+
+    __atomic_store_n(&capture->active, true, __ATOMIC_RELEASE);
+    NET_LOGI("Capture started: %s", path);
+    return 0;
+}
+
+void net_capture_stop(net_device_t *dev) {
+    net_capture_t *capture = dev->capture;
+
+    if (!capture || !capture->active) {
+        return;
+    }
+
+    // 收发线程在锁内复查active，置位后不会再有写入
+    pthread_spin_lock(&capture->lock);
+    capture->active = false;
+    pthread_spin_unlock(&capture->lock);
+
+    pthread_mutex_lock(&capture->mutex);
+    capture->running = false;
+    pthread_cond_signal(&capture->cond);
+    pthread_mutex_unlock(&capture->mutex);
+    pthread_join(capture->thread_id, NULL);
+
+    // 刷出剩余数据：先刷待写缓冲区，再刷当前缓冲区
+    if (capture->pending) {
+        net_capture_flush_fd(capture->fd, capture->buf[capture->cur ^ 1], capture->pending);
+        capture->pending = 0;
+    }
+    if (capture->used) {
+        net_capture_flush_fd(capture->fd, capture->buf[capture->cur], capture->used);
+        capture->used = 0;
+    }
+    close(capture->fd);
+    capture->fd = -1;
+
+    NET_LOGI("Capture stopped: %llu packets, %llu dropped",
+             (unsigned long long)capture->packets, (unsigned long long)capture->dropped);
+}
+
+void net_capture_destroy(net_capture_t *capture) {
+    if (!capture) {
+        return;
+    }
+
+    pthread_spin_destroy(&capture->lock);
+    pthread_mutex_destroy(&capture->mutex);
+    pthread_cond_destroy(&capture->cond);
+    free(capture->buf[0]);
+    free(capture->buf[1]);
+    free(capture);
+}
@@ -0,0 +1,39 @@
+#ifndef NET_CAPTURE_H
+#define NET_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "net_device.h"
+
+// ======================================================================
+// pcapng 抓包（内部使用）
+// 未开启抓包时收发路径上只有一次指针判断
+// ======================================================================
+
+#define NET_CAPTURE_DIR_IN      1
+#define NET_CAPTURE_DIR_OUT     2
+
+typedef struct net_capture net_capture_t;
+
+void net_capture_write(net_capture_t *capture, int dir, const uint8_t *data, size_t length);
+void net_capture_destroy(net_capture_t *capture);
+
+// net_capture_t 的第一个字段，热路径只读这一个字节
+static inline bool net_capture_active(const net_capture_t *capture) {
+    return __atomic_load_n((const bool *)capture, __ATOMIC_RELAXED);
+}
+
+static inline void net_capture_rx(net_device_t *dev, const uint8_t *data, size_t length) {
+    if (__builtin_expect(dev->capture != NULL, 0) && net_capture_active(dev->capture)) {
+        net_capture_write(dev->capture, NET_CAPTURE_DIR_IN, data, length);
+    }
+}
+
+static inline void net_capture_tx(net_device_t *dev, const uint8_t *data, size_t length) {
+    if (__builtin_expect(dev->capture != NULL, 0) && net_capture_active(dev->capture)) {
+        net_capture_write(dev->capture, NET_CAPTURE_DIR_OUT, data, length);
+    }
+}
+
+#endif
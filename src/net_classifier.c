@@ -0,0 +1,232 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "net_device.h"
+#include "net_packet.h"
+#include "net_classifier.h"
+#include "net_stats.h"
+
+static inline uint64_t net_mac_key(const uint8_t *mac) {
+    return (uint64_t)mac[0] | ((uint64_t)mac[1] << 8) | ((uint64_t)mac[2] << 16) |
+           ((uint64_t)mac[3] << 24) | ((uint64_t)mac[4] << 32) | ((uint64_t)mac[5] << 40);
+}
+
+net_classifier_t *net_classifier_create(net_device_t *dev, uint32_t queue_nr, uint32_t depth, uint32_t rss_nr) {
+    if (queue_nr == 0 || queue_nr > NET_RX_QUEUE_MAX) {
+        NET_LOGE("Invalid rx queue number: %u (max %d)", queue_nr, NET_RX_QUEUE_MAX);
+        return NULL;
+    }
+    if (rss_nr > queue_nr) {
+        NET_LOGE("RSS queues %u exceed rx queue number %u", rss_nr, queue_nr);
+        return NULL;
+    }
+
+    net_classifier_t *cls = (net_classifier_t *)calloc(1, sizeof(net_classifier_t));
+    if (!cls) {
+        return NULL;
+    }
+
+    pthread_mutex_init(&cls->lock, NULL);
+    cls->queues[0] = dev->rx_ring;
+    cls->queue_nr = queue_nr;
+    cls->rss_nr = rss_nr > 1 ? rss_nr : 0;
+    for (uint32_t i = 1; i < queue_nr; i++) {
+        cls->queues[i] = net_ring_create(depth);
+        if (!cls->queues[i]) {
+            net_classifier_destroy(cls);
+            return NULL;
+        }
+    }
+
+    return cls;
+}
+
+void net_classifier_destroy(net_classifier_t *cls) {
+    if (!cls) {
+        return;
+    }
+
+    for (uint32_t i = 1; i < cls->queue_nr; i++) {
+        if (cls->queues[i]) {
+            net_ring_destroy(cls->queues[i]);
+        }
+    }
+
+    free(cls->table);
+    while (cls->retired) {
+        net_classify_table_t *next = cls->retired->retired;
+        free(cls->retired);
+        cls->retired = next;
+    }
+
+    pthread_mutex_destroy(&cls->lock);
+    free(cls);
+}
+
+static int net_rule_compile(const net_classifier_t *cls, const net_rule_t *rule, net_rule_compiled_t *out) {
+    memset(out, 0, sizeof(*out));
+
+    if ((rule->match & NET_MATCH_VLAN) && (rule->match & NET_MATCH_UNTAGGED)) {
+        NET_LOGE("Rule cannot match both VLAN and untagged frames");
+        return -1;
+    }
+
+    switch (rule->action) {
+    case NET_ACTION_QUEUE:
+        if (rule->queue >= cls->queue_nr) {
+            NET_LOGE("Rule queue %u out of range (%u queues)", rule->queue, cls->queue_nr);
+            return -1;
+        }
+        break;
+    case NET_ACTION_DROP:
+        break;
+    case NET_ACTION_CALLBACK:
+        if (!rule->callback) {
+            NET_LOGE("Callback rule without callback");
+            return -1;
+        }
+        break;
+    default:
+        NET_LOGE("Invalid rule action: %u", rule->action);
+        return -1;
+    }
+
+    if (rule->match & NET_MATCH_DST_MAC) {
+        static const uint8_t exact[NET_ETH_ALEN] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+        static const uint8_t none[NET_ETH_ALEN] = { 0 };
+        uint64_t mask = net_mac_key(memcmp(rule->dst_mask, none, NET_ETH_ALEN) ? rule->dst_mask : exact);
+
+        out->mask0 |= mask;
+        out->value0 |= net_mac_key(rule->dst_mac) & mask;
+    }
+    if (rule->match & NET_MATCH_ETHERTYPE) {
+        out->mask0 |= (uint64_t)0xFFFF << 48;
+        out->value0 |= (uint64_t)rule->ethertype << 48;
+    }
+    if (rule->match & NET_MATCH_VLAN) {
+        out->mask1 = NET_CLASSIFY_TAGGED | 0x0FFF;
+        out->value1 = NET_CLASSIFY_TAGGED | (rule->vlan_id & 0x0FFF);
+    }
+    if (rule->match & NET_MATCH_UNTAGGED) {
+        out->mask1 = NET_CLASSIFY_TAGGED;
+        out->value1 = 0;
+    }
+
+    out->action = rule->action;
+    out->queue = rule->queue;
+    out->callback = rule->callback;
+    out->userdata = rule->userdata;
+    return 0;
+}
+
+// 释放接收线程已用完的旧表：退役时不在匹配中，或之后已完成那一次匹配
+static void net_classify_reclaim(net_classifier_t *cls, uint64_t seq) {
+    net_classify_table_t **link = &cls->retired;
+
+    while (*link) {
+        net_classify_table_t *table = *link;
+        if ((table->retire_seq & 1) == 0 || table->retire_seq != seq) {
+            *link = table->retired;
+            free(table);
+        } else {
+            link = &table->retired;
+        }
+    }
+}
+
+int net_classify_set(net_device_t *dev, const net_rule_t *rules, int count) {
+    net_classifier_t *cls = dev->classifier;
+    net_classify_table_t *table = NULL;
+
+    if (!cls) {
+        NET_LOGE("Device not initialized");
+        return -1;
+    }
+    if (count < 0 || count > NET_RULE_MAX || (count > 0 && !rules)) {
+        NET_LOGE("Invalid rule count: %d (max %d)", count, NET_RULE_MAX);
+        return -1;
+    }
+
+    if (count > 0) {
+        table = (net_classify_table_t *)calloc(1, sizeof(net_classify_table_t) +
+                                                  (size_t)count * sizeof(net_rule_compiled_t));
+        if (!table) {
+            return -1;
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (net_rule_compile(cls, &rules[i], &table->rules[i]) != 0) {
+                NET_LOGE("Invalid rule #%d", i);
+                free(table);
+                return -1;
+            }
+        }
+        table->count = (uint32_t)count;
+    }
+
+    // 发布新表后读rx_seq：与接收线程的先加rx_seq再读表配对，
+    // 读到偶数时接收线程之后的匹配一定看到新表
+    pthread_mutex_lock(&cls->lock);
+    net_classify_table_t *old = cls->table;
+    __atomic_store_n(&cls->table, table, __ATOMIC_SEQ_CST);
+    uint64_t seq = __atomic_load_n(&cls->rx_seq, __ATOMIC_SEQ_CST);
+    if (old) {
+        old->retire_seq = seq;
+        old->retired = cls->retired;
+        cls->retired = old;
+    }
+    net_classify_reclaim(cls, seq);
+    pthread_mutex_unlock(&cls->lock);
+
+    return 0;
+}
+
+static int net_classify_match_table(net_device_t *dev, const net_classify_table_t *table,
+                                    const uint8_t *frame, size_t length) {
+    if (!table || length < NET_ETH_HLEN) {
+        return 0;
+    }
+
+    uint16_t type = (uint16_t)((frame[12] << 8) | frame[13]);
+    uint32_t key1 = 0;
+    if ((type == NET_ETHERTYPE_VLAN || type == NET_ETHERTYPE_QINQ) && length >= NET_ETH_HLEN + NET_VLAN_HLEN) {
+        key1 = NET_CLASSIFY_TAGGED | (((uint32_t)frame[14] << 8 | frame[15]) & 0x0FFF);
+        type = net_eth_get_type(frame, length);
+    }
+    uint64_t key0 = net_mac_key(frame) | ((uint64_t)type << 48);
+
+    for (uint32_t i = 0; i < table->count; i++) {
+        const net_rule_compiled_t *rule = &table->rules[i];
+        if ((key0 & rule->mask0) != rule->value0 || (key1 & rule->mask1) != rule->value1) {
+            continue;
+        }
+
+        switch (rule->action) {
+        case NET_ACTION_QUEUE:
+            return rule->queue;
+        case NET_ACTION_CALLBACK:
+            net_stat_add(&dev->stats->rx.diverted, 1);
+            rule->callback(NET_MSG_TYPE_RX_PACKET, rule->userdata, (uint8_t *)frame, length);
+            return -1;
+        default:
+            net_stat_add(&dev->stats->rx.drop_filter, 1);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int net_classify_match(net_device_t *dev, const uint8_t *frame, size_t length) {
+    net_classifier_t *cls = dev->classifier;
+
+    // 只有接收线程写rx_seq；先置奇数再读表，见net_classify_set
+    __atomic_store_n(&cls->rx_seq, cls->rx_seq + 1, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    const net_classify_table_t *table = __atomic_load_n(&cls->table, __ATOMIC_ACQUIRE);
+
+    int queue = net_classify_match_table(dev, table, frame, length);
+
+    __atomic_store_n(&cls->rx_seq, cls->rx_seq + 1, __ATOMIC_RELEASE);
+    return queue;
+}
@@ -0,0 +1,95 @@
+#ifndef NET_CLASSIFIER_H
+#define NET_CLASSIFIER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "net_device.h"
+#include "net_classify.h"
+#include "net_ring.h"
+
+// ======================================================================
+// 接收分类（内部使用）
+//
+// 每帧提取一次匹配键：
+//   key0 = 目的MAC(低48位) | EtherType(高16位)
+//   key1 = 带标签标志(bit12) | 外层VLAN ID
+// 规则编译为 (key & mask) == value 的两次比较，不再逐字段判断。
+// 规则表整表替换，接收线程无需加锁：接收线程匹配期间rx_seq为奇数，
+// 发布新表后rx_seq为偶数（或已变化）说明旧表不再被使用，立即释放；
+// 否则挂到retired链上，下一次替换规则时再回收。
+// RSS：规则匹配后仍落在队列0的帧按对称流哈希分到队列0..rss_nr-1，
+// 同一条流（含两个方向）总在同一个队列，队列内保持顺序；非IP帧哈希为0，留在队列0。
+// ======================================================================
+
+#define NET_CLASSIFY_TAGGED     0x1000
+
+typedef struct {
+    uint64_t mask0;
+    uint64_t value0;
+    uint32_t mask1;
+    uint32_t value1;
+    uint8_t action;
+    uint8_t queue;
+    net_dev_callback_t callback;
+    void *userdata;
+} net_rule_compiled_t;
+
+typedef struct net_classify_table {
+    struct net_classify_table *retired;
+    uint64_t retire_seq;                // 退役时读到的rx_seq
+    uint32_t count;
+    net_rule_compiled_t rules[];
+} net_classify_table_t;
+
+typedef struct net_classifier {
+    net_classify_table_t *table;        // 接收线程原子读取，NULL表示无规则
+    net_classify_table_t *retired;      // 被替换下来、接收线程可能还在用的旧表
+    uint64_t rx_seq;                    // 接收线程每次匹配前后各加1，匹配期间为奇数
+    pthread_mutex_t lock;               // 串行化net_classify_set
+    net_ring_t *queues[NET_RX_QUEUE_MAX]; // queues[0]即dev->rx_ring，不归这里管理
+    uint32_t queue_nr;
+    uint32_t rss_nr;                    // RSS分散的队列数，0为不分散
+} net_classifier_t;
+
+net_classifier_t *net_classifier_create(net_device_t *dev, uint32_t queue_nr, uint32_t depth, uint32_t rss_nr);
+void net_classifier_destroy(net_classifier_t *cls);
+
+// 按规则表匹配，返回目标队列号；返回-1表示已丢弃或已由回调处理
+int net_classify_match(net_device_t *dev, const uint8_t *frame, size_t length);
+
+// 流哈希映射到0..n-1：乘法取高位，不用除法
+static inline int net_rss_queue(uint32_t hash, uint32_t n) {
+    return (int)(((uint64_t)hash * n) >> 32);
+}
+
+// 接收线程调用，无规则且未开RSS时只有两次判断
+// 开启RSS时*hash带回计算出的流哈希（元数据直接使用，不再算第二次），否则不修改
+static inline int net_classify_rx(net_device_t *dev, const uint8_t *frame, size_t length, uint32_t *hash) {
+    net_classifier_t *cls = dev->classifier;
+    int queue = 0;
+
+    if (__atomic_load_n(&cls->table, __ATOMIC_ACQUIRE) != NULL) {
+        queue = net_classify_match(dev, frame, length);
+    }
+    if (queue == 0 && cls->rss_nr) {
+        *hash = net_flow_hash(frame, length);
+        queue = net_rss_queue(*hash, cls->rss_nr);
+    }
+    return queue;
+}
+
+static inline net_ring_t *net_rx_queue(net_device_t *dev, int queue) {
+    return dev->classifier->queues[queue];
+}
+
+// 一批入队后唤醒mask中各队列的消费者
+static inline void net_rx_queues_notify(net_device_t *dev, uint32_t mask) {
+    while (mask) {
+        int queue = __builtin_ctz(mask);
+        net_ring_notify(dev->classifier->queues[queue]);
+        mask &= mask - 1;
+    }
+}
+
+#endif
@@ -0,0 +1,395 @@
+#include <stdint.h>
+#include <string.h>
+#include "net_packet.h"
+#include "net_csum.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NET_CSUM_X86    1
+#else
+#define NET_CSUM_X86    0
+#endif
+
+#define CRC32_POLY_REFLECTED    0xEDB88320u
+#define CRC32_PCLMUL_MIN        64      // 折叠至少需要4个16字节块
+#define CSUM_SIMD_MIN           256     // 更短时向量水平求和的开销超过收益
+
+static uint32_t crc32_table[8][256];
+
+static uint32_t (*crc32_fold_fn)(const uint8_t *data, size_t length, uint32_t crc);
+static uint32_t (*csum_fn)(const uint8_t *data, size_t length, uint32_t sum);
+static const char *csum_impl_name;
+
+// ---------------------------------------------------------------- CRC32
+
+static void crc32_init_tables(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (c >> 1) ^ CRC32_POLY_REFLECTED : c >> 1;
+        }
+        crc32_table[0][i] = c;
+    }
+
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int k = 1; k < 8; k++) {
+            crc32_table[k][i] = (crc32_table[k - 1][i] >> 8) ^ crc32_table[0][crc32_table[k - 1][i] & 0xFF];
+        }
+    }
+}
+
+// crc为取反后的中间状态
+static uint32_t crc32_slice8(const uint8_t *p, size_t length, uint32_t crc) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (length >= 8) {
+        uint32_t lo, hi;
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = crc32_table[7][lo & 0xFF] ^ crc32_table[6][(lo >> 8) & 0xFF] ^
+              crc32_table[5][(lo >> 16) & 0xFF] ^ crc32_table[4][lo >> 24] ^
+              crc32_table[3][hi & 0xFF] ^ crc32_table[2][(hi >> 8) & 0xFF] ^
+              crc32_table[1][(hi >> 16) & 0xFF] ^ crc32_table[0][hi >> 24];
+        p += 8;
+        length -= 8;
+    }
+#endif
+
+    while (length--) {
+        crc = crc32_table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if NET_CSUM_X86
+// PCLMULQDQ折叠（Intel "Fast CRC Computation Using PCLMULQDQ"，反射域常数）
+// length >= 64 且为16的倍数，crc为取反后的中间状态
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_pclmul(const uint8_t *p, size_t length, uint32_t crc) {
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    p += 64;
+    length -= 64;
+
+    // 4路并行折叠，每次64字节
+    while (length >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(p + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(p + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(p + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(p + 0x30)));
+
+        p += 64;
+        length -= 64;
+    }
+
+    // 合并为128位
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // 剩余的16字节块
+    while (length >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)p)), x5);
+        p += 16;
+        length -= 16;
+    }
+
+    // 128位折叠到64位
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett约简到32位
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+#endif
+
+uint32_t net_crc32(uint32_t crc, const void *data, size_t length) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    if (crc32_fold_fn && length >= CRC32_PCLMUL_MIN) {
+        size_t chunk = length & ~(size_t)15;
+        crc = crc32_fold_fn(p, chunk, crc);
+        p += chunk;
+        length -= chunk;
+    }
+
+    return ~crc32_slice8(p, length, crc);
+}
+
+size_t net_fcs_append(uint8_t *frame, size_t length) {
+    uint32_t fcs = net_crc32(0, frame, length);
+
+    frame[length + 0] = (uint8_t)fcs;
+    frame[length + 1] = (uint8_t)(fcs >> 8);
+    frame[length + 2] = (uint8_t)(fcs >> 16);
+    frame[length + 3] = (uint8_t)(fcs >> 24);
+    return length + NET_FCS_LEN;
+}
+
+int net_fcs_check(const uint8_t *frame, size_t length) {
+    if (length < NET_FCS_LEN) {
+        return -1;
+    }
+
+    const uint8_t *tail = frame + length - NET_FCS_LEN;
+    uint32_t fcs = (uint32_t)tail[0] | ((uint32_t)tail[1] << 8) |
+                   ((uint32_t)tail[2] << 16) | ((uint32_t)tail[3] << 24);
+    return net_crc32(0, frame, length - NET_FCS_LEN) == fcs ? 0 : -1;
+}
+
+// ---------------------------------------------------------------- 互联网校验和
+
+static uint32_t csum_fold64(uint64_t sum) {
+    sum = (sum & 0xFFFFFFFFu) + (sum >> 32);
+    sum = (sum & 0xFFFFFFFFu) + (sum >> 32);
+    return (uint32_t)sum;
+}
+
+// 32位字累加到64位，反码和与按16位累加等价
+static uint32_t csum_generic(const uint8_t *p, size_t length, uint32_t sum32) {
+    uint64_t sum = sum32;
+    uint32_t w32;
+    uint16_t w16;
+
+    while (length >= 16) {
+        uint32_t a, b, c, d;
+        memcpy(&a, p, 4);
+        memcpy(&b, p + 4, 4);
+        memcpy(&c, p + 8, 4);
+        memcpy(&d, p + 12, 4);
+        sum += (uint64_t)a + b + c + d;
+        p += 16;
+        length -= 16;
+    }
+
+    while (length >= 4) {
+        memcpy(&w32, p, 4);
+        sum += w32;
+        p += 4;
+        length -= 4;
+    }
+
+    if (length >= 2) {
+        memcpy(&w16, p, 2);
+        sum += w16;
+        p += 2;
+        length -= 2;
+    }
+
+    // 奇数尾字节按内存顺序补0
+    if (length) {
+        uint8_t tail[2] = { *p, 0 };
+        memcpy(&w16, tail, 2);
+        sum += w16;
+    }
+
+    return csum_fold64(sum);
+}
+
+#if NET_CSUM_X86
+// 每个32位通道分别累加高低16位，最多16384块后再并入64位和，不会溢出
+__attribute__((target("avx2")))
+static uint32_t csum_avx2(const uint8_t *p, size_t length, uint32_t sum32) {
+    const __m256i mask = _mm256_set1_epi32(0xFFFF);
+    uint64_t sum = sum32;
+
+    while (length >= 64) {
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        size_t blocks = length / 64;
+        if (blocks > 16384) {
+            blocks = 16384;
+        }
+
+        for (size_t i = 0; i < blocks; i++) {
+            __m256i v0 = _mm256_loadu_si256((const __m256i *)p);
+            __m256i v1 = _mm256_loadu_si256((const __m256i *)(p + 32));
+            acc0 = _mm256_add_epi32(acc0, _mm256_and_si256(v0, mask));
+            acc1 = _mm256_add_epi32(acc1, _mm256_srli_epi32(v0, 16));
+            acc0 = _mm256_add_epi32(acc0, _mm256_and_si256(v1, mask));
+            acc1 = _mm256_add_epi32(acc1, _mm256_srli_epi32(v1, 16));
+            p += 64;
+        }
+        length -= blocks * 64;
+
+        uint32_t lanes[16];
+        _mm256_storeu_si256((__m256i *)lanes, acc0);
+        _mm256_storeu_si256((__m256i *)(lanes + 8), acc1);
+        for (int k = 0; k < 16; k++) {
+            sum += lanes[k];
+        }
+    }
+
+    return csum_generic(p, length, csum_fold64(sum));
+}
+#endif
+
+// 短数据在这里分流：在AVX2函数里跳转到标量代码会带着脏的ymm高位，产生SSE/AVX切换开销
+uint32_t net_csum_partial(const void *data, size_t length, uint32_t sum) {
+    if (length < CSUM_SIMD_MIN) {
+        return csum_generic((const uint8_t *)data, length, sum);
+    }
+    return csum_fn((const uint8_t *)data, length, sum);
+}
+
+uint16_t net_csum_fold(uint32_t sum) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+// ---------------------------------------------------------------- 接收校验
+
+static inline uint16_t net_get_be16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+int net_csum_verify_l4(const uint8_t *frame, size_t length) {
+    size_t off = NET_ETH_ALEN * 2;
+    uint16_t type;
+
+    // 跳过VLAN标签
+    for (;;) {
+        if (off + 2 > length) {
+            return 0;
+        }
+        type = net_get_be16(frame + off);
+        if (type != NET_ETHERTYPE_VLAN && type != NET_ETHERTYPE_QINQ) {
+            break;
+        }
+        off += NET_VLAN_HLEN;
+    }
+    off += 2;
+
+    if (type != NET_ETHERTYPE_IPV4) {
+        return 0;
+    }
+
+    const uint8_t *ip = frame + off;
+    size_t avail = length - off;
+    if (avail < 20 || (ip[0] >> 4) != 4) {
+        return -1;
+    }
+
+    size_t ihl = (size_t)(ip[0] & 0x0F) * 4;
+    size_t total = net_get_be16(ip + 2);
+    if (ihl < 20 || ihl > avail || total < ihl || total > avail) {
+        return -1;
+    }
+
+    if (net_inet_csum(ip, ihl) != 0) {
+        return -1;
+    }
+
+    // 分片只校验IP头
+    if (net_get_be16(ip + 6) & 0x3FFF) {
+        return 0;
+    }
+
+    uint8_t proto = ip[9];
+    const uint8_t *l4 = ip + ihl;
+    size_t l4_len = total - ihl;
+
+    if (proto == 17) {
+        if (l4_len < 8) {
+            return -1;
+        }
+        if (l4[6] == 0 && l4[7] == 0) {
+            return 0; // 发送方未计算UDP校验和
+        }
+    } else if (proto == 6) {
+        if (l4_len < 20) {
+            return -1;
+        }
+    } else {
+        return 0;
+    }
+
+    // 伪首部：源/目的地址、协议、L4长度
+    uint8_t pseudo[4] = { 0, proto, (uint8_t)(l4_len >> 8), (uint8_t)l4_len };
+    uint32_t sum = net_csum_partial(ip + 12, 8, 0);
+    sum = net_csum_partial(pseudo, sizeof(pseudo), sum);
+    sum = net_csum_partial(l4, l4_len, sum);
+
+    return net_csum_fold(sum) == 0 ? 0 : -1;
+}
+
+// ---------------------------------------------------------------- 实现选择
+
+const char *net_csum_select(int impl) {
+    crc32_fold_fn = NULL;
+    csum_fn = csum_generic;
+    csum_impl_name = "slice8+scalar";
+
+#if NET_CSUM_X86
+    if (impl == NET_CSUM_IMPL_BEST) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) {
+            crc32_fold_fn = crc32_pclmul;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            csum_fn = csum_avx2;
+        }
+
+        if (crc32_fold_fn && csum_fn == csum_avx2) {
+            csum_impl_name = "pclmul+avx2";
+        } else if (crc32_fold_fn) {
+            csum_impl_name = "pclmul+scalar";
+        } else if (csum_fn == csum_avx2) {
+            csum_impl_name = "slice8+avx2";
+        }
+    }
+#else
+    (void)impl;
+#endif
+
+    return csum_impl_name;
+}
+
+__attribute__((constructor))
+static void net_csum_init(void) {
+    crc32_init_tables();
+    net_csum_select(NET_CSUM_IMPL_BEST);
+}
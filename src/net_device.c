@@ -1,224 +1,173 @@
+#define _GNU_SOURCE
 #include <stdint.h>
 #include <string.h>
+#include <pthread.h>
+#include <sched.h>
 #include <mempool.h>
 #include <mempool_log.h>
 #include "net_device.h"
+#include "net_backend.h"
+#include "net_ring.h"
+#include "net_capture.h"
+#include "net_stats.h"
+#include "net_pool.h"
+#include "net_classifier.h"
+#include "net_backpressure.h"
+#include "net_dispatch.h"
+#include "net_gro.h"
 
 #define NET_DEVICE_USE_RX_ISR     0
 
-static net_device_t *g_net_device_ptr = NULL;
+void net_thread_setup(pthread_t thread, const char *name, int cpu) {
+#ifdef __linux__
+    pthread_setname_np(thread, name);
 
-// ======================================================================
-// 硬件接口
-// ======================================================================
-#include <stdint.h>
-#include <string.h>
-#include <mempool.h>
-#include "net_device.h"
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#include <unistd.h>
-#include <errno.h>
-
-#define PYTHON_SERVER_IP   "127.0.0.1"
-#define PYTHON_SERVER_PORT 1069
+    if (cpu != NET_CPU_NONE) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(cpu - 1, &cpuset);
+        if (pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset) != 0) {
+            NET_LOGW("Failed to pin %s thread to CPU %d", name, cpu - 1);
+        }
+    }
+#endif
+}
 
-static int g_tcp_socket = -1;
+uint32_t net_get_time_ms(void) {
+    return MEMPOOL_CURRENT_TIME_MS();
+}
 
 // ======================================================================
-// TCP通信接口
+// 网络中间适配层
 // ======================================================================
-
-#include <pthread.h>
-
-typedef struct {
-    net_device_t *net_device;
-    volatile bool running;
-    pthread_t thread_id;
-    pthread_mutex_t mutex;
-    pthread_cond_t cond;
-} receive_thread_t;
-
-static receive_thread_t g_receive_thread;
-static void *receive_thread_func(void *arg) {
-    receive_thread_t *thread = (receive_thread_t *)arg;
-    uint8_t *buffer = NULL;
-    net_device_t *net_device = thread->net_device;
-
-    if (!net_device || !net_device->mempool) {
-        NET_LOGE("Invalid net_device or mempool");
-        return NULL;
+static void net_tx_account(net_device_t *dev, int ret, size_t length, uint64_t start) {
+    net_stats_t *stats = dev->stats;
+
+    net_hist_record_shared(&stats->tx_latency, net_stats_now_ns() - start);
+    if (ret == 0) {
+        net_stat_add_shared(&stats->tx.packets, 1);
+        net_stat_add_shared(&stats->tx.bytes, length);
+    } else {
+        net_stat_add_shared(&stats->tx.errors, 1);
     }
+}
 
-    const size_t buffer_size = net_device->mempool->block_size; // 根据需要调整
-
-    while (thread->running) {
-        buffer = mempool_alloc(net_device->mempool, true);
-        if (!buffer) {
-            usleep(1000); // 10ms延迟
-            continue;
-        }
-
-        ssize_t received = recv(g_tcp_socket, buffer, buffer_size, MSG_DONTWAIT);
-        if (received > 0) {
-            pthread_mutex_lock(&thread->mutex);
-            NET_LOGD("Received %zd bytes from server", received);
-            NET_HEX_DUMP(buffer, received);
-
-            if (net_device->mempool_queue) {
-                mempool_queue_enqueue_with_length(net_device->mempool_queue, buffer, received);
-            }
-
-            if (net_device->callback) {
-                net_device->callback(NET_MSG_TYPE_RX_PACKET, net_device->userdata, buffer, received);
-            }
-
-            pthread_mutex_unlock(&thread->mutex);
-        } 
-        else if (received == 0) {
-            NET_LOGE("Server disconnected");
-            close(g_tcp_socket);
-            g_tcp_socket = -1;
-            mempool_free(net_device->mempool, buffer);
-            break;
-        }
-        else {
-            if (errno != EAGAIN && errno != EWOULDBLOCK) {
-                perror("recv error");
-            }
-            mempool_free(net_device->mempool, buffer);
-            usleep(1000); // 1ms延迟避免忙等待
-        }
-    }
+// 发送数据：后端复制数据后返回（TCP链路复制到内存池块后由发送线程写出）
+int net_send(net_device_t *dev, uint8_t *data, size_t length)
+{
+    net_capture_tx(dev, data, length);
 
-    return NULL;
+    uint64_t start = net_stats_now_ns();
+    int ret = dev->backend->send(dev, data, length);
+    net_tx_account(dev, ret, length, start);
+    return ret;
 }
 
-int receive_thread_start(net_device_t *net_device) {
-    g_receive_thread.net_device = net_device;
-    g_receive_thread.running = true;
+int net_sendv(net_device_t *dev, const net_iovec_t *iov, int count) {
+    size_t length = 0;
 
-    pthread_mutex_init(&g_receive_thread.mutex, NULL);
-    pthread_cond_init(&g_receive_thread.cond, NULL);
-
-    if (pthread_create(&g_receive_thread.thread_id, NULL, 
-                      receive_thread_func, &g_receive_thread) != 0) {
-        perror("Failed to create receive thread");
+    if (count <= 0 || count > NET_IOV_MAX) {
+        NET_LOGE("Invalid iovec count: %d", count);
         return -1;
     }
+    for (int i = 0; i < count; i++) {
+        length += iov[i].length;
+    }
 
-    return 0;
-}
-
-void receive_thread_stop() {
-    g_receive_thread.running = false;
-    pthread_join(g_receive_thread.thread_id, NULL);
-    
-    pthread_mutex_destroy(&g_receive_thread.mutex);
-    pthread_cond_destroy(&g_receive_thread.cond);
+    uint64_t start = net_stats_now_ns();
+    int ret;
+    if (dev->backend->sendv && !(dev->capture && net_capture_active(dev->capture))) {
+        ret = dev->backend->sendv(dev, iov, count, length);
+    } else {
+        // 后端不支持或正在抓包：拼进内存池块再发送
+        uint8_t *buffer = net_pool_alloc(dev->pool, length);
+        if (!buffer) {
+            net_stat_add_shared(&dev->stats->tx.drop_nobuf, 1);
+            return -1;
+        }
+        net_iov_gather(buffer, iov, count);
+        net_capture_tx(dev, buffer, length);
+        ret = dev->backend->send(dev, buffer, length);
+        net_pool_free(dev->pool, buffer);
+    }
+    net_tx_account(dev, ret, length, start);
+    return ret;
 }
 
-static int tcp_connect() {
-    if (g_tcp_socket >= 0) {
-        return 0; // 已连接
+// 发送完成：通知使用者并归还缓冲区
+void net_tx_complete(net_device_t *dev, uint8_t *buffer, size_t length) {
+    if (dev->callback) {
+        dev->callback(NET_MSG_TYPE_TX_PACKET, dev->userdata, buffer, length);
     }
 
-    g_tcp_socket = socket(AF_INET, SOCK_STREAM, 0);
-    if (g_tcp_socket < 0) {
-        perror("socket creation failed");
-        return -1;
+    if (dev->ops.tx_callback) {
+        dev->ops.tx_callback(buffer, length);
+    } else {
+        net_packet_free(dev, buffer);
     }
+}
 
-    struct sockaddr_in server_addr = {
-        .sin_family = AF_INET,
-        .sin_port = htons(PYTHON_SERVER_PORT),
-        .sin_addr.s_addr = inet_addr(PYTHON_SERVER_IP)
-    };
+int net_send_zerocpy(net_device_t *dev, uint8_t *buffer, size_t length) {
+    int ret;
 
-    if (connect(g_tcp_socket, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-        perror("connect failed");
-        close(g_tcp_socket);
-        g_tcp_socket = -1;
-        return -1;
-    }
+    net_capture_tx(dev, buffer, length);
 
-    // 现在只需要启动接收线程
-    static bool thread_started = false;
-    
-    if (!thread_started) {
-        if (receive_thread_start(g_net_device_ptr) == 0) {
-            thread_started = true;
-        }
+    uint64_t start = net_stats_now_ns();
+    if (dev->backend->send_zerocpy) {
+        // 后端在完成时（可能在其他线程）调用net_tx_complete
+        ret = dev->backend->send_zerocpy(dev, buffer, length);
+    } else {
+        ret = dev->backend->send(dev, buffer, length);
+        net_tx_complete(dev, buffer, length);
     }
-
-    NET_LOGD("Connected to Python server at %s:%d", 
-           PYTHON_SERVER_IP, PYTHON_SERVER_PORT);
-    return 0;
+    net_tx_account(dev, ret, length, start);
+    return ret;
 }
-// ======================================================================
-// 修改后的硬件模拟接口
-// ======================================================================
 
-int hw_simulate_send(uint8_t *data, size_t length) {
-    if (tcp_connect() < 0) {
-        return -1;
-    }
+static int net_packet_release(net_device_t *dev, uint8_t *buffer);
+static size_t net_packet_release_chain(net_device_t *dev, uint8_t *buffer);
 
-    // 打印调试信息
-    NET_LOGD("Sending %zu bytes to server", length);
-    NET_HEX_DUMP(data, length);
+// DROP_OLD过载时丢掉队列中最旧的帧，只留到低水位（GRO链整条丢弃）
+static void net_rx_trim(net_device_t *dev, net_ring_t *ring) {
+    size_t excess = net_backpressure_trim_count(dev, ring);
+    net_desc_t descs[NET_BURST_MAX];
+    size_t trimmed = 0;
 
-    // 通过TCP发送数据
-    ssize_t sent = send(g_tcp_socket, data, length, 0);
-    if (sent < 0) {
-        perror("send failed");
-        return -1;
+    while (excess > 0) {
+        size_t n = net_ring_dequeue_burst(ring, descs, excess < NET_BURST_MAX ? excess : NET_BURST_MAX);
+        if (n == 0) {
+            break;
+        }
+        for (size_t i = 0; i < n; i++) {
+            trimmed += net_packet_release_chain(dev, descs[i].buffer);
+        }
+        excess -= n;
     }
 
-    // 模拟发送完成中断
-    // hw_simulate_send_isr(&g_net_device, data, length);
-    return 0;
-}
-
-static void hw_simulate_send_isr(net_device_t *net_device, uint8_t *buffer, size_t length) {
-    if (net_device->callback) {
-        net_device->callback(NET_MSG_TYPE_TX_PACKET, net_device->userdata, buffer, length);
+    if (trimmed > 0) {
+        net_stat_add_shared(&dev->stats->app.drop_stale, trimmed);
+        dev->backend->rx_resume(dev);
     }
-    mempool_free(net_device->mempool, buffer);
 }
 
-static void hw_simulate_receive_isr(net_device_t *net_device) {
-    // 现在只需要启动接收线程
-    static bool thread_started = false;
-    
-    if (!thread_started) {
-        if (receive_thread_start(net_device) == 0) {
-            thread_started = true;
+// 取走一批描述符后记录排队延迟
+// 多个接收队列时各队列可能在不同线程中接收，改用原子加
+static void net_rx_account(net_device_t *dev, const net_desc_t *descs, size_t n) {
+    net_stats_t *stats = dev->stats;
+    uint64_t now = net_stats_now_ns();
+
+    if (dev->classifier->queue_nr > 1) {
+        for (size_t i = 0; i < n; i++) {
+            net_hist_record_shared(&stats->rx_latency, now > descs[i].stamp ? now - descs[i].stamp : 0);
         }
+        net_stat_add_shared(&stats->app.delivered, n);
+        return;
     }
-}
-
-uint32_t net_get_time_ms(void) {
-    return MEMPOOL_CURRENT_TIME_MS();
-}
 
-// ======================================================================
-// 网络中间适配层
-// ======================================================================
-// 发送数据，发送完成后，需要释放网络内存池的buffer
-int net_send(net_device_t *dev, uint8_t *data, size_t length)
-{
-    uint8_t *buffer = mempool_alloc(dev->mempool, true);
-    if(!buffer) {
-        NET_LOGE("Failed to allocate buffer for sending");
-        return -1;
+    for (size_t i = 0; i < n; i++) {
+        net_hist_record(&stats->rx_latency, now > descs[i].stamp ? now - descs[i].stamp : 0);
     }
-    
-    memcpy(buffer, data, length); 
-
-    hw_simulate_send(data, length);
-    return 0;
+    net_stat_add(&stats->app.delivered, n);
 }
 
 // 接收到数据后，搬运到网络的内存池内，然后发送给网络（里面会校验是否是有效的以太报文，可能发送多次）
@@ -226,17 +175,31 @@ int net_send(net_device_t *dev, uint8_t *data, size_t length)
 // 接收数据
 int net_receive_pool(net_device_t *dev, uint8_t *data, size_t length) {
     // 模拟接收数据
+    net_desc_t desc;
     uint8_t *buffer = NULL;
     size_t data_length = 0;
 
-    if (dev->mempool_queue) {
-        buffer = mempool_queue_dequeue_with_length(dev->mempool_queue, &data_length);
-        if(buffer == NULL) {
-            return -1;
+    if (dev->rx_ring) {
+        // GRO链每次复制一帧，先交付上次取出的链上剩下的帧
+        if (dev->gro && dev->gro->pool_next) {
+            buffer = dev->gro->pool_next;
+            data_length = net_packet_meta(buffer)->length;
+        } else {
+            net_rx_trim(dev, dev->rx_ring);
+            if (net_ring_dequeue_burst(dev->rx_ring, &desc, 1) == 0) {
+                return -1;
+            }
+            buffer = desc.buffer;
+            data_length = desc.length;
+            net_rx_account(dev, &desc, 1);
+            dev->backend->rx_resume(dev);
+        }
+        if (dev->gro) {
+            dev->gro->pool_next = net_packet_next(buffer);
         }
         NET_LOGD("Received %zu bytes from pool", data_length);
         memcpy(data, buffer, length < data_length ? length : data_length);
-        mempool_free(dev->mempool, buffer);
+        net_packet_free(dev, buffer);
         return length < data_length ? length : data_length;
     }
 
@@ -245,28 +208,110 @@ int net_receive_pool(net_device_t *dev, uint8_t *data, size_t length) {
 
 // 直接获取内存地址，零拷贝
 uint8_t *net_receive_zerocpy(net_device_t *dev) {
-    // 直接从内存池中获取数据
-    if (dev->mempool_queue) {
-        return mempool_queue_dequeue(dev->mempool_queue);
+    size_t length = 0;
+    return net_receive_zerocpy_with_length(dev, &length);
+}
+
+uint8_t *net_receive_zerocpy_with_length(net_device_t *dev, size_t *length) {
+    // 直接从内存池中获取数据（ETH模式下指向内核接收环）
+    net_desc_t desc;
+
+    if (!dev->rx_ring) {
+        return NULL;
+    }
+
+    net_rx_trim(dev, dev->rx_ring);
+    if (net_ring_dequeue_burst(dev->rx_ring, &desc, 1) == 1) {
+        if (length) {
+            *length = desc.length;
+        }
+        net_rx_account(dev, &desc, 1);
+        dev->backend->rx_resume(dev);
+        return desc.buffer;
     }
 
     return NULL;
 }
 
-uint8_t *net_receive_zerocpy_with_length(net_device_t *dev, size_t *length) {
-    // 直接从内存池中获取数据
-    if (dev->mempool_queue) {
-        return mempool_queue_dequeue_with_length(dev->mempool_queue, length);
+int net_send_burst(net_device_t *dev, uint8_t **data, const size_t *lengths, int count) {
+    if (count <= 0) {
+        return 0;
     }
 
-    return NULL;
+    net_stats_t *stats = dev->stats;
+    uint64_t start = net_stats_now_ns();
+    int sent = dev->backend->send_burst(dev, data, lengths, count);
+    net_hist_record_shared(&stats->tx_latency, net_stats_now_ns() - start);
+
+    size_t bytes = 0;
+    for (int i = 0; i < sent; i++) {
+        net_capture_tx(dev, data[i], lengths[i]);
+        bytes += lengths[i];
+    }
+
+    if (sent > 0) {
+        net_stat_add_shared(&stats->tx.packets, (uint64_t)sent);
+        net_stat_add_shared(&stats->tx.bytes, bytes);
+    }
+    if (sent < count) {
+        net_stat_add_shared(&stats->tx.errors, (uint64_t)(count - (sent > 0 ? sent : 0)));
+    }
+    return sent;
+}
+
+// 一次取出多帧，只在最后唤醒一次接收线程
+static int net_receive_ring_burst(net_device_t *dev, net_ring_t *ring, uint8_t **buffers, size_t *lengths, int max) {
+    net_desc_t descs[NET_BURST_MAX];
+    int count = 0;
+
+    net_rx_trim(dev, ring);
+    while (count < max) {
+        size_t want = (size_t)(max - count) < NET_BURST_MAX ? (size_t)(max - count) : NET_BURST_MAX;
+        size_t n = net_ring_dequeue_burst(ring, descs, want);
+        net_rx_account(dev, descs, n);
+
+        for (size_t i = 0; i < n; i++) {
+            buffers[count] = descs[i].buffer;
+            lengths[count] = descs[i].length;
+            count++;
+        }
+
+        if (n < want) {
+            break;
+        }
+    }
+
+    if (count > 0) {
+        dev->backend->rx_resume(dev);
+    }
+
+    return count;
+}
+
+int net_receive_burst(net_device_t *dev, uint8_t **buffers, size_t *lengths, int max) {
+    if (!dev->rx_ring) {
+        return 0;
+    }
+
+    return net_receive_ring_burst(dev, dev->rx_ring, buffers, lengths, max);
+}
+
+int net_receive_queue_burst(net_device_t *dev, int queue, uint8_t **buffers, size_t *lengths, int max) {
+    if (!dev->classifier || queue < 0 || (uint32_t)queue >= dev->classifier->queue_nr) {
+        return -1;
+    }
+
+    return net_receive_ring_burst(dev, net_rx_queue(dev, queue), buffers, lengths, max);
 }
 
 // 检查是否有数据到达
 // 这里的检查是为了避免在没有数据到达的情况下，调用net_receive_pool函数
 int net_check_packet_input(net_device_t *dev) {
-    if (dev->mempool_queue) {
-        if(mempool_queue_count(dev->mempool_queue) > 0) {
+    if (dev->gro && dev->gro->pool_next) {
+        return 1;
+    }
+    if (dev->rx_ring) {
+        if(net_ring_count(dev->rx_ring) > 0) {
             return 1;
         }
     }
@@ -274,46 +319,309 @@ int net_check_packet_input(net_device_t *dev) {
     return 0;
 }
 
+// 等待报文到达：先自旋，再挂起到接收线程唤醒
+int net_receive_wait(net_device_t *dev, int timeout_ms) {
+    if (!dev->rx_ring) {
+        return -1;
+    }
+    if (dev->gro && dev->gro->pool_next) {
+        return 1;
+    }
+
+    return net_ring_wait(dev->rx_ring, timeout_ms);
+}
+
+int net_receive_queue_wait(net_device_t *dev, int queue, int timeout_ms) {
+    if (!dev->classifier || queue < 0 || (uint32_t)queue >= dev->classifier->queue_nr) {
+        return -1;
+    }
+
+    return net_ring_wait(net_rx_queue(dev, queue), timeout_ms);
+}
+
 uint8_t *net_packet_alloc(net_device_t *dev, size_t length)
 {
-    if(length > mempool_block_size(dev->mempool)) {
+    if(length > net_pool_max_size(dev->pool)) {
         NET_LOGE("Requested length exceeds block size");
         return NULL;
     }
 
-    return mempool_alloc(dev->mempool, false);
+    uint8_t *buffer = net_pool_alloc(dev->pool, length);
+    if (buffer) {
+        net_stat_add_shared(&dev->stats->tx.pool_alloc, 1);
+    }
+    return buffer;
+}
+
+// 归还缓冲区但不唤醒接收线程，返回0成功
+static int net_packet_release(net_device_t *dev, uint8_t *buffer) {
+    if (dev->backend && dev->backend->buffer_free && dev->backend->buffer_free(dev, buffer) == 0) {
+        return 0;
+    }
+
+    if (!dev->pool) {
+        return -1;
+    }
+    if (net_pool_free(dev->pool, buffer) != 0) {
+        NET_LOGE("Freeing buffer %p not owned by device", (void *)buffer);
+        return -1;
+    }
+    if (dev->stats) {
+        net_stat_add_shared(&dev->stats->app.pool_free, 1);
+    }
+    return 0;
 }
 
 void net_packet_free(net_device_t *dev, uint8_t *buffer) {
-    if (dev->mempool) {
-        mempool_free(dev->mempool, buffer);
+    if (net_packet_release(dev, buffer) == 0 && dev->backend) {
+        dev->backend->rx_resume(dev);
+    }
+}
+
+// 归还GRO链上的各帧，返回帧数；先取下一段再释放，释放后元数据失效
+static size_t net_packet_release_chain(net_device_t *dev, uint8_t *buffer) {
+    size_t n = 0;
+
+    while (buffer) {
+        uint8_t *next = net_packet_next(buffer);
+        net_packet_release(dev, buffer);
+        buffer = next;
+        n++;
+    }
+    return n;
+}
+
+void net_packet_free_chain(net_device_t *dev, uint8_t *buffer) {
+    if (net_packet_release_chain(dev, buffer) > 0 && dev->backend) {
+        dev->backend->rx_resume(dev);
+    }
+}
+
+static const net_device_config_t net_default_config = {
+    .pool = {
+        { NET_POOL_SMALL_SIZE, NET_POOL_SMALL_NUM },
+        { NET_POOL_LARGE_SIZE, NET_POOL_LARGE_NUM },
+    },
+    .rx_queue_depth = NET_RX_QUEUE_DEPTH,
+    .mtu = NET_MTU_MAX,
+    .rx_queue_nr = 1,
+    .rx_policy = NET_RX_POLICY_BLOCK,
+    .rx_high_pct = 90,
+    .rx_low_pct = 70,
+};
+
+// 合并用户配置与默认值
+static void net_resolve_config(const net_device_config_t *user, net_device_config_t *cfg) {
+    *cfg = net_default_config;
+    if (!user) {
+        return;
+    }
+
+    for (int i = 0; i < NET_POOL_CLASS_MAX; i++) {
+        if (user->pool[i].size && user->pool[i].count) {
+            memcpy(cfg->pool, user->pool, sizeof(cfg->pool));
+            break;
+        }
+    }
+
+    if (user->rx_queue_depth) {
+        cfg->rx_queue_depth = user->rx_queue_depth;
+    }
+    if (user->mtu) {
+        cfg->mtu = user->mtu;
+    }
+    cfg->hugepages = user->hugepages;
+    cfg->csum_flags = user->csum_flags;
+    if (user->rx_queue_nr) {
+        cfg->rx_queue_nr = user->rx_queue_nr;
     }
+    cfg->rx_rss_queues = user->rx_rss_queues;
+    cfg->rx_policy = user->rx_policy;
+    if (user->rx_high_pct) {
+        cfg->rx_high_pct = user->rx_high_pct;
+        // 只改了高水位时低水位跟着下调
+        if (!user->rx_low_pct && cfg->rx_low_pct >= cfg->rx_high_pct) {
+            cfg->rx_low_pct = (uint8_t)(cfg->rx_high_pct * 3 / 4);
+        }
+    }
+    if (user->rx_low_pct) {
+        cfg->rx_low_pct = user->rx_low_pct;
+    }
+    cfg->rx_deliver = user->rx_deliver;
+    cfg->rx_deliver_cpu = user->rx_deliver_cpu;
+    cfg->io_uring = user->io_uring;
+    cfg->rx_gro_segs = user->rx_gro_segs;
 }
 
 int net_init(net_device_t *dev) {
+    net_device_config_t cfg;
+
     DEBUG_PRINT("Initializing network device");
 
-    g_net_device_ptr = dev;
+    // 接收时间戳与延迟统计都用这个时钟，先校准
+    net_time_init();
+
+    net_resolve_config(dev->config, &cfg);
 
     // 初始化内存池
-    dev->mempool = mempool_create(1600, 10);
-    if (!dev->mempool) {
+    dev->pool = net_pool_create(cfg.pool, NET_POOL_CLASS_MAX, cfg.hugepages);
+    if (!dev->pool) {
         NET_LOGE("Failed to create memory pool");
         return -1;
     }
 
-    // 创建队列
-    dev->mempool_queue = mempool_queue_create(dev->mempool, 10);
-    if (!dev->mempool_queue) {
-        NET_LOGE("Failed to create memory pool queue");
-        mempool_destroy(dev->mempool);
-        return -1;
+    if (net_pool_max_size(dev->pool) < cfg.mtu + NET_ETH_HLEN_MAX) {
+        NET_LOGE("Largest pool class %zu cannot hold MTU %u", net_pool_max_size(dev->pool), cfg.mtu);
+        goto err_ring;
+    }
+
+    // 创建接收环
+    dev->rx_ring = net_ring_create(cfg.rx_queue_depth);
+    if (!dev->rx_ring) {
+        NET_LOGE("Failed to create rx ring");
+        goto err_ring;
+    }
+
+    // 分类规则使用的附加接收队列
+    dev->classifier = net_classifier_create(dev, cfg.rx_queue_nr, cfg.rx_queue_depth, cfg.rx_rss_queues);
+    if (!dev->classifier) {
+        NET_LOGE("Failed to create rx classifier");
+        goto err_classifier;
+    }
+
+    dev->stats = net_stats_create(dev->pool->capacity);
+    if (!dev->stats) {
+        NET_LOGE("Failed to create device stats");
+        goto err_stats;
+    }
+
+    dev->backpressure = net_backpressure_create(cfg.rx_policy, cfg.rx_high_pct, cfg.rx_low_pct);
+    if (!dev->backpressure) {
+        NET_LOGE("Failed to create rx backpressure state");
+        goto err_backpressure;
+    }
+
+    dev->dispatch = net_dispatch_create(dev, cfg.rx_deliver, cfg.rx_deliver_cpu);
+    if (!dev->dispatch) {
+        NET_LOGE("Failed to create rx dispatch state");
+        goto err_dispatch;
+    }
+
+    if (cfg.rx_gro_segs > 1) {
+        dev->gro = net_gro_create(cfg.rx_gro_segs);
+        if (!dev->gro) {
+            NET_LOGE("Failed to create rx GRO state");
+            goto err_gro;
+        }
+    }
+
+    // 选择传输后端
+    switch (dev->mode) {
+#ifdef __linux__
+    case NET_MODE_ETH:
+        dev->backend = cfg.io_uring ? &net_backend_uring : &net_backend_packet;
+        break;
+    case NET_MODE_SHM:
+        dev->backend = &net_backend_shm;
+        break;
+#endif
+    case NET_MODE_NONE:
+    case NET_MODE_TCPIP:
+        dev->backend = &net_backend_tcp;
+        break;
+    default:
+        NET_LOGE("Unsupported device mode: %d", dev->mode);
+        goto err_backend;
     }
 
-    // 驱动初始化
-    tcp_connect();
+    // 驱动初始化，失败时依次尝试后备后端
+    while (dev->backend->open(dev) != 0) {
+        if (!dev->backend->fallback) {
+            NET_LOGE("Failed to open %s backend", dev->backend->name);
+            goto err_backend;
+        }
+        NET_LOGW("%s backend unavailable, falling back to %s", dev->backend->name, dev->backend->fallback->name);
+        dev->backend = dev->backend->fallback;
+    }
+
+    if (net_dispatch_start(dev) != 0) {
+        NET_LOGE("Failed to start rx dispatch");
+        dev->backend->close(dev);
+        goto err_backend;
+    }
 
     return 0;
+
+err_backend:
+    dev->backend = NULL;
+    net_gro_destroy(dev->gro);
+    dev->gro = NULL;
+err_gro:
+    net_dispatch_destroy(dev->dispatch);
+    dev->dispatch = NULL;
+err_dispatch:
+    net_backpressure_destroy(dev->backpressure);
+    dev->backpressure = NULL;
+err_backpressure:
+    net_stats_destroy(dev->stats);
+    dev->stats = NULL;
+err_stats:
+    net_classifier_destroy(dev->classifier);
+    dev->classifier = NULL;
+err_classifier:
+    net_ring_destroy(dev->rx_ring);
+    dev->rx_ring = NULL;
+err_ring:
+    net_pool_destroy(dev->pool);
+    dev->pool = NULL;
+    return -1;
+}
+
+void net_deinit(net_device_t *dev) {
+    net_capture_stop(dev);
+
+    // 先停投递线程，它会调用后端的rx_resume
+    net_dispatch_stop(dev);
+
+    // net_receive_pool还没交付的GRO帧，缓冲区可能属于后端，关闭前归还
+    if (dev->gro && dev->gro->pool_next) {
+        net_packet_release_chain(dev, dev->gro->pool_next);
+        dev->gro->pool_next = NULL;
+    }
+
+    if (dev->backend) {
+        dev->backend->close(dev);
+        dev->backend = NULL;
+    }
+
+    // 接收线程已退出，可以释放抓包状态
+    net_capture_destroy(dev->capture);
+    dev->capture = NULL;
+
+    net_classifier_destroy(dev->classifier);
+    dev->classifier = NULL;
+
+    if (dev->rx_ring) {
+        net_ring_destroy(dev->rx_ring);
+        dev->rx_ring = NULL;
+    }
+
+    net_backpressure_destroy(dev->backpressure);
+    dev->backpressure = NULL;
+
+    net_dispatch_destroy(dev->dispatch);
+    dev->dispatch = NULL;
+
+    net_gro_destroy(dev->gro);
+    dev->gro = NULL;
+
+    net_stats_destroy(dev->stats);
+    dev->stats = NULL;
+
+    if (dev->pool) {
+        net_pool_destroy(dev->pool);
+        dev->pool = NULL;
+    }
 }
 
 
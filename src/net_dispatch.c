@@ -0,0 +1,97 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "net_device.h"
+#include "net_backend.h"
+#include "net_dispatch.h"
+
+net_dispatch_t *net_dispatch_create(net_device_t *dev, uint8_t mode, int cpu) {
+    if (mode > NET_RX_DELIVER_DEFERRED) {
+        NET_LOGE("Invalid rx deliver mode: %u", mode);
+        return NULL;
+    }
+    if (mode != NET_RX_DELIVER_POLL && !dev->ops.rx_burst) {
+        NET_LOGE("Batched rx delivery requires ops.rx_burst");
+        return NULL;
+    }
+
+    net_dispatch_t *dispatch = (net_dispatch_t *)calloc(1, sizeof(net_dispatch_t));
+    if (!dispatch) {
+        return NULL;
+    }
+
+    dispatch->mode = mode;
+    dispatch->cpu = cpu;
+    dispatch->batch = NET_RX_CALLBACK_BATCH;
+    // 接收环比一批还浅时按环深度凑批，INLINE下环不会被自己写满
+    if (dispatch->batch > dev->rx_ring->capacity) {
+        dispatch->batch = (uint32_t)dev->rx_ring->capacity;
+    }
+    return dispatch;
+}
+
+void net_dispatch_destroy(net_dispatch_t *dispatch) {
+    free(dispatch);
+}
+
+int net_dispatch_deliver(net_device_t *dev) {
+    uint8_t *buffers[NET_RX_CALLBACK_BATCH];
+    size_t lengths[NET_RX_CALLBACK_BATCH];
+
+    int count = net_receive_burst(dev, buffers, lengths, (int)dev->dispatch->batch);
+    if (count > 0) {
+        dev->ops.rx_burst(dev->userdata, buffers, lengths, count);
+    }
+    return count;
+}
+
+static void *net_dispatch_thread_func(void *arg) {
+    net_device_t *dev = (net_device_t *)arg;
+    net_dispatch_t *dispatch = dev->dispatch;
+
+    while (dispatch->running) {
+        if (net_ring_wait(dev->rx_ring, -1) <= 0) {
+            continue;
+        }
+        while (net_dispatch_deliver(dev) > 0) {
+        }
+    }
+
+    // 停止前交付剩下的帧，回调负责释放
+    while (net_dispatch_deliver(dev) > 0) {
+    }
+    return NULL;
+}
+
+int net_dispatch_start(net_device_t *dev) {
+    net_dispatch_t *dispatch = dev->dispatch;
+
+    if (dispatch->mode != NET_RX_DELIVER_DEFERRED) {
+        return 0;
+    }
+
+    dispatch->running = true;
+    if (pthread_create(&dispatch->thread_id, NULL, net_dispatch_thread_func, dev) != 0) {
+        perror("Failed to create dispatch thread");
+        dispatch->running = false;
+        return -1;
+    }
+    net_thread_setup(dispatch->thread_id, "net-disp", dispatch->cpu);
+    dispatch->started = true;
+    return 0;
+}
+
+void net_dispatch_stop(net_device_t *dev) {
+    net_dispatch_t *dispatch = dev->dispatch;
+
+    if (!dispatch || !dispatch->started) {
+        return;
+    }
+
+    // 投递线程挂起在队列0上，取消等待后立即醒来看到停止标志
+    dispatch->running = false;
+    net_ring_cancel_wait(dev->rx_ring);
+    pthread_join(dispatch->thread_id, NULL);
+    dispatch->started = false;
+}
@@ -0,0 +1,58 @@
+#ifndef NET_DISPATCH_H
+#define NET_DISPATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "net_device.h"
+#include "net_ring.h"
+
+// ======================================================================
+// 批量接收回调（内部使用）
+//
+// 默认队列0的帧按批交给ops.rx_burst，每次最多NET_RX_CALLBACK_BATCH帧：
+//   INLINE   —— 接收线程入队后自己当消费者：队列攒满一批或一批接收结束时
+//               取出交付，回调在接收线程中执行，不持有任何锁
+//   DEFERRED —— 独立的投递线程等在队列0上，接收线程只管入队，
+//               回调慢时由过载策略处理，不会拖住读socket/环
+// 两种方式都经过接收环取帧，修剪、延迟统计、唤醒接收线程与轮询接口一致。
+// ======================================================================
+
+typedef struct net_dispatch {
+    uint8_t mode;               // NET_RX_DELIVER_xxx
+    uint32_t batch;             // 单次回调帧数上限，不超过接收环深度
+    int cpu;                    // 投递线程绑定的CPU
+    volatile bool running;
+    bool started;
+    pthread_t thread_id;
+} net_dispatch_t;
+
+net_dispatch_t *net_dispatch_create(net_device_t *dev, uint8_t mode, int cpu);
+void net_dispatch_destroy(net_dispatch_t *dispatch);
+
+// 后端打开后启动投递线程（DEFERRED），关闭后端前停止
+int net_dispatch_start(net_device_t *dev);
+void net_dispatch_stop(net_device_t *dev);
+
+// 从队列0取一批交给ops.rx_burst，返回交付帧数
+int net_dispatch_deliver(net_device_t *dev);
+
+// 接收线程每入队一帧后调用：INLINE时队列0攒满一批就先交付
+static inline void net_dispatch_enqueued(net_device_t *dev, const net_ring_t *ring) {
+    const net_dispatch_t *dispatch = dev->dispatch;
+
+    if (dispatch->mode == NET_RX_DELIVER_INLINE && ring == dev->rx_ring &&
+        net_ring_count(ring) >= dispatch->batch) {
+        net_dispatch_deliver(dev);
+    }
+}
+
+// 接收线程一批结束（已唤醒各队列）后调用：INLINE时交付队列0剩余的帧
+static inline void net_dispatch_batch_end(net_device_t *dev) {
+    if (dev->dispatch->mode == NET_RX_DELIVER_INLINE) {
+        while (net_dispatch_deliver(dev) > 0) {
+        }
+    }
+}
+
+#endif
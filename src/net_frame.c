@@ -0,0 +1,92 @@
+#include <stdlib.h>
+#include <string.h>
+#include "net_frame.h"
+
+int net_frame_stream_init(net_frame_stream_t *stream, size_t size) {
+    // 至少能容纳一个最大帧，否则大帧永远无法拼完整
+    if (size < NET_FRAME_HDR_LEN + NET_FRAME_MAX_LEN) {
+        size = NET_FRAME_HDR_LEN + NET_FRAME_MAX_LEN;
+    }
+
+    stream->buf = (uint8_t *)malloc(size);
+    if (!stream->buf) {
+        return -1;
+    }
+
+    stream->size = size;
+    stream->head = 0;
+    stream->tail = 0;
+    return 0;
+}
+
+void net_frame_stream_deinit(net_frame_stream_t *stream) {
+    free(stream->buf);
+    stream->buf = NULL;
+    stream->size = 0;
+    stream->head = 0;
+    stream->tail = 0;
+}
+
+void net_frame_stream_reset(net_frame_stream_t *stream) {
+    stream->head = 0;
+    stream->tail = 0;
+}
+
+uint8_t *net_frame_stream_write_ptr(net_frame_stream_t *stream, size_t *space) {
+    // 只在尾部空间不足一个最大帧时才搬移残留数据，避免每次recv都memmove
+    if (stream->head == stream->tail) {
+        stream->head = 0;
+        stream->tail = 0;
+    } else if (stream->size - stream->tail < NET_FRAME_HDR_LEN + NET_FRAME_MAX_LEN && stream->head > 0) {
+        memmove(stream->buf, stream->buf + stream->head, stream->tail - stream->head);
+        stream->tail -= stream->head;
+        stream->head = 0;
+    }
+
+    *space = stream->size - stream->tail;
+    return stream->buf + stream->tail;
+}
+
+void net_frame_stream_commit(net_frame_stream_t *stream, size_t length) {
+    stream->tail += length;
+}
+
+int net_frame_stream_peek(net_frame_stream_t *stream, size_t *length) {
+    size_t avail = stream->tail - stream->head;
+    if (avail < NET_FRAME_HDR_LEN) {
+        return 0;
+    }
+
+    const uint8_t *hdr = stream->buf + stream->head;
+    size_t frame_len = ((size_t)hdr[0] << 8) | hdr[1];
+    if (frame_len == 0) {
+        return -1;
+    }
+
+    if (avail < NET_FRAME_HDR_LEN + frame_len) {
+        return 0;
+    }
+
+    *length = frame_len;
+    return 1;
+}
+
+int net_frame_stream_peek_frame(net_frame_stream_t *stream, const uint8_t **frame, size_t *length) {
+    int ret = net_frame_stream_peek(stream, length);
+    if (ret <= 0) {
+        return ret;
+    }
+
+    *frame = stream->buf + stream->head + NET_FRAME_HDR_LEN;
+    return 1;
+}
+
+int net_frame_stream_next(net_frame_stream_t *stream, const uint8_t **frame, size_t *length) {
+    int ret = net_frame_stream_peek_frame(stream, frame, length);
+    if (ret <= 0) {
+        return ret;
+    }
+
+    stream->head += NET_FRAME_HDR_LEN + *length;
+    return 1;
+}
@@ -0,0 +1,50 @@
+#ifndef NET_FRAME_H
+#define NET_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ======================================================================
+// 模拟链路帧格式：每帧前加 2 字节大端长度头
+//
+//  +--------+--------+----------------------+
+//  | len_hi | len_lo |  以太帧 (len 字节)    |
+//  +--------+--------+----------------------+
+//
+// TCP 是字节流，会合并/拆分报文，接收端必须按长度头重新切帧
+// ======================================================================
+
+#define NET_FRAME_HDR_LEN       2
+#define NET_FRAME_MAX_LEN       0xFFFF
+#define NET_FRAME_STREAM_SIZE   (256 * 1024) // 流缓冲区大小，决定单次recv最多读取的字节数
+
+typedef struct {
+    uint8_t *buf;   // 流缓冲区
+    size_t size;    // 缓冲区大小
+    size_t head;    // 下一个未解析字节
+    size_t tail;    // 已接收数据末尾
+} net_frame_stream_t;
+
+static inline void net_frame_encode_header(uint8_t hdr[NET_FRAME_HDR_LEN], size_t length) {
+    hdr[0] = (uint8_t)(length >> 8);
+    hdr[1] = (uint8_t)(length);
+}
+
+int net_frame_stream_init(net_frame_stream_t *stream, size_t size);
+void net_frame_stream_deinit(net_frame_stream_t *stream);
+void net_frame_stream_reset(net_frame_stream_t *stream);
+
+// 获取可写入区域（会先把残留的半帧搬到缓冲区头部）
+uint8_t *net_frame_stream_write_ptr(net_frame_stream_t *stream, size_t *space);
+void net_frame_stream_commit(net_frame_stream_t *stream, size_t length);
+
+// 取出下一个完整帧，帧数据直接指向流缓冲区，下次写入前有效
+// 返回 1：取到一帧；0：数据不完整；-1：长度头非法（流已失步）
+int net_frame_stream_next(net_frame_stream_t *stream, const uint8_t **frame, size_t *length);
+
+// 查看下一帧长度但不取出，用于先申请缓冲区再消费
+int net_frame_stream_peek(net_frame_stream_t *stream, size_t *length);
+// 查看下一帧（数据与长度）但不取出，用于先校验/分类再决定是否消费
+int net_frame_stream_peek_frame(net_frame_stream_t *stream, const uint8_t **frame, size_t *length);
+
+#endif
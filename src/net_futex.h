@@ -0,0 +1,40 @@
+#ifndef NET_FUTEX_H
+#define NET_FUTEX_H
+
+#include <stdint.h>
+#include <time.h>
+
+// ======================================================================
+// futex 封装（内部使用）：无futex的平台退化为短睡眠轮询
+// ======================================================================
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// *addr仍等于expected时挂起，timeout为相对时间，NULL一直等待
+static inline int net_futex_wait(uint32_t *addr, uint32_t expected, const struct timespec *timeout) {
+    return (int)syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, timeout, NULL, 0);
+}
+
+static inline void net_futex_wake(uint32_t *addr, int count) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+#else
+static inline int net_futex_wait(uint32_t *addr, uint32_t expected, const struct timespec *timeout) {
+    struct timespec ts = { .tv_sec = 0, .tv_nsec = 100000 };
+    (void)addr;
+    (void)expected;
+    (void)timeout;
+    nanosleep(&ts, NULL);
+    return 0;
+}
+
+static inline void net_futex_wake(uint32_t *addr, int count) {
+    (void)addr;
+    (void)count;
+}
+#endif
+
+#endif
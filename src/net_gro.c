@@ -0,0 +1,18 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "net_device.h"
+#include "net_gro.h"
+
+net_gro_t *net_gro_create(uint32_t max_segs) {
+    net_gro_t *gro = (net_gro_t *)calloc(1, sizeof(net_gro_t));
+    if (!gro) {
+        return NULL;
+    }
+
+    gro->max_segs = max_segs;
+    return gro;
+}
+
+void net_gro_destroy(net_gro_t *gro) {
+    free(gro);
+}
@@ -0,0 +1,97 @@
+#ifndef NET_GRO_H
+#define NET_GRO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "net_device.h"
+#include "net_packet.h"
+#include "net_ring.h"
+#include "net_stats.h"
+
+// ======================================================================
+// 软件GRO（内部使用）
+//
+// 接收线程一批之内，同一接收队列、同一条流（对称流哈希相同）的连续帧
+// 不各占一个接收环位置，而是用元数据的gro_next串成一条链，整条链只入队一次：
+// 使用者一次取到链头，按链处理同一条流的多帧。帧内容不改写，每一段保留
+// 自己的元数据（长度、时间戳），哈希冲突时只是把两条流的帧放在同一条链上，
+// 不影响各帧本身。
+//
+// 每批最多挂起一条链：新帧接不上时，先把挂起的链入队再检查接收环空位，
+// 挂起的链在接上第一帧时已经检查过空位，入队不会失败。一批结束时入队。
+// ======================================================================
+
+typedef struct net_gro {
+    uint32_t max_segs;          // 每条链最多的帧数
+    net_ring_t *ring;           // 挂起链所属的接收队列
+    uint8_t *head;              // 挂起的链，NULL表示没有
+    uint8_t *tail;
+    size_t head_len;
+    uint64_t stamp;             // 链头的入队时间
+    uint32_t hash;
+    uint32_t segs;
+
+    uint8_t *pool_next;         // net_receive_pool取出的链上还没交付的帧（使用者线程）
+} net_gro_t;
+
+net_gro_t *net_gro_create(uint32_t max_segs);
+void net_gro_destroy(net_gro_t *gro);
+
+// 把挂起的链放入接收队列
+static inline void net_gro_flush(net_device_t *dev) {
+    net_gro_t *gro = dev->gro;
+
+    if (gro && gro->head) {
+        net_packet_meta(gro->head)->gro_segs = (uint16_t)gro->segs;
+        net_ring_enqueue(gro->ring, gro->head, gro->head_len, gro->stamp);
+        gro->head = NULL;
+    }
+}
+
+// 接收线程分类后、检查接收队列空位前调用：新帧接不到挂起的链上时先把链入队
+// 返回帧的流哈希（hash为0时计算）；GRO关闭时原样返回hash
+static inline uint32_t net_gro_prepare(net_device_t *dev, const net_ring_t *ring,
+                                       const uint8_t *frame, size_t length, uint32_t hash) {
+    const net_gro_t *gro = dev->gro;
+
+    if (!gro) {
+        return hash;
+    }
+    if (!hash) {
+        hash = net_flow_hash(frame, length);
+    }
+    if (gro->head && (gro->ring != ring || !hash || gro->hash != hash || gro->segs >= gro->max_segs)) {
+        net_gro_flush(dev);
+    }
+    return hash;
+}
+
+// 代替net_ring_enqueue：元数据已填好的帧接到挂起的链尾，或开始一条新链
+static inline void net_rx_enqueue(net_device_t *dev, net_ring_t *ring, uint8_t *buffer, size_t length,
+                                  uint64_t stamp, uint32_t hash) {
+    net_gro_t *gro = dev->gro;
+
+    if (!gro) {
+        net_ring_enqueue(ring, buffer, length, stamp);
+        return;
+    }
+
+    // net_gro_prepare已把接不上的链入队，还挂着的就是同一条流
+    if (gro->head) {
+        net_packet_meta(gro->tail)->gro_next = buffer;
+        gro->tail = buffer;
+        gro->segs++;
+        net_stat_add(&dev->stats->rx.gro_merged, 1);
+        return;
+    }
+
+    gro->ring = ring;
+    gro->head = buffer;
+    gro->tail = buffer;
+    gro->head_len = length;
+    gro->stamp = stamp;
+    gro->hash = hash;
+    gro->segs = 1;
+}
+
+#endif
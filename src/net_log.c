@@ -1,16 +1,19 @@
+#define _GNU_SOURCE
 #include <stddef.h>
 #include <time.h>
 #include <stdint.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
 #include <net_device.h>
 #include <ctype.h> // ??
 #include <pthread.h>
-#include <semaphore.h>
-
-#define NET_MALLOC(size)    malloc(size)
-#define NET_FREE(ptr)       free(ptr)
+#include "net_ring.h"
+#include "net_futex.h"
 
 // ANSI颜色定义（整行着色）
 #define COLOR_DEBUG   "\033[0;36m"  // 青色
@@ -19,20 +22,6 @@
 #define COLOR_ERROR   "\033[1;31m"  // 红色（加粗）
 #define COLOR_RESET   "\033[0m"     // 重置
 
-typedef struct net_task
-{
-    pthread_t thread_id;
-    void (*start_routine)(void *);
-    void *arg;
-    int is_running;
-    int is_joined;
-}net_task_t;
-
-typedef struct net_sem {
-    void *userdata; // 用户数据
-    sem_t semaphore; // POSIX信号量
-}net_sem_t;
-
 // 获取当前时间字符串（线程安全版本）
 static inline const char* get_timestamp() {
     static __thread char buffer[32];
@@ -41,179 +30,441 @@ static inline const char* get_timestamp() {
     return buffer;
 }
 
-void net_base_hex(const unsigned char *data, size_t length) {
-    const int BYTES_PER_LINE = 16;
-    
-    for (size_t offset = 0; offset < length; offset += BYTES_PER_LINE) {
-        // 打印偏移量
-        printf("%08zx  ", offset);
-        
-        // 打印十六进制数据
-        for (int i = 0; i < BYTES_PER_LINE; i++) {
-            if (offset + i < length) {
-                printf("%02x ", data[offset + i]);
-            } else {
-                printf("   "); // 对齐填充
-            }
-            
-            // 在8字节后添加额外空格
-            if (i == 7) {
-                printf(" ");
+// ======================================================================
+// 日志
+//
+// NET_LOG_ASYNC=1 时，每个线程有一个无锁日志环（单生产者），
+// 调用线程只做 vsnprintf/拷贝原始数据 到环中的记录，从不阻塞在stderr上；
+// 后台日志线程取出记录，加颜色前缀、格式化HEX，攒成大块后一次write输出。
+// 环满时丢弃新日志并计数，由后台线程报告丢弃条数。
+// ======================================================================
+
+uint8_t net_log_level = NET_LOG_RUNTIME_LEVEL > NET_LOG_LEVEL ? NET_LOG_RUNTIME_LEVEL : NET_LOG_LEVEL;
+
+void net_log_set_level(uint8_t level) {
+    __atomic_store_n(&net_log_level, level, __ATOMIC_RELAXED);
+}
+
+uint8_t net_log_get_level(void) {
+    return __atomic_load_n(&net_log_level, __ATOMIC_RELAXED);
+}
+
+static const char *net_log_color(uint8_t level, const char **prefix) {
+    switch(level) {
+        case NET_LOG_LEVEL_DEBUG:   *prefix = "[DEBUG]  "; return COLOR_DEBUG;
+        case NET_LOG_LEVEL_INFO:    *prefix = "[INFO]   "; return COLOR_INFO;
+        case NET_LOG_LEVEL_WARNING: *prefix = "[WARNING]"; return COLOR_WARNING;
+        case NET_LOG_LEVEL_ERROR:   *prefix = "[ERROR]  "; return COLOR_ERROR;
+    }
+    *prefix = "";
+    return COLOR_RESET;
+}
+
+#define NET_HEX_BYTES_PER_LINE  16
+#define NET_HEX_LINE_MAX        80
+
+// 格式化一行HEX（不含换行），返回写入字节数
+static int net_hex_format_line(char *out, const unsigned char *data, size_t length, size_t offset) {
+    static const char hex[] = "0123456789abcdef";
+    char *p = out;
+
+    // 打印偏移量
+    p += sprintf(p, "%08zx  ", offset);
+
+    // 打印十六进制数据
+    for (size_t i = 0; i < NET_HEX_BYTES_PER_LINE; i++) {
+        if (i < length) {
+            *p++ = hex[data[i] >> 4];
+            *p++ = hex[data[i] & 0x0f];
+            *p++ = ' ';
+        } else {
+            // 对齐填充
+            *p++ = ' ';
+            *p++ = ' ';
+            *p++ = ' ';
+        }
+
+        // 在8字节后添加额外空格
+        if (i == 7) {
+            *p++ = ' ';
+        }
+    }
+
+    *p++ = ' ';
+
+    // 打印ASCII字符
+    for (size_t i = 0; i < NET_HEX_BYTES_PER_LINE; i++) {
+        *p++ = i < length ? (isprint(data[i]) ? (char)data[i] : '.') : ' ';
+    }
+
+    return (int)(p - out);
+}
+
+static void net_write_all(int fd, const char *buf, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, buf, length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
             }
+            return;
         }
-        
-        printf(" ");
-        
-        // 打印ASCII字符
-        for (int i = 0; i < BYTES_PER_LINE; i++) {
-            if (offset + i < length) {
-                unsigned char c = data[offset + i];
-                printf("%c", isprint(c) ? c : '.');
+        buf += n;
+        length -= (size_t)n;
+    }
+}
+
+#if NET_LOG_ASYNC
+
+#define NET_LOG_RECORD_SIZE     256     // 单条记录大小，超长日志截断
+#define NET_LOG_RING_SLOTS      512     // 每线程日志环记录数，2的幂
+#define NET_LOG_OUT_BUF_SIZE    (64 * 1024)
+#define NET_LOG_IDLE_WAIT_MS    100
+
+#define NET_LOG_TYPE_TEXT       0
+#define NET_LOG_TYPE_HEX        1
+
+typedef struct {
+    uint8_t type;
+    uint8_t level;
+    uint16_t length;    // data中的有效字节数
+    uint32_t offset;    // HEX：本段在整个dump中的偏移
+    char data[NET_LOG_RECORD_SIZE - 8];
+} net_log_record_t;
+
+#define NET_LOG_HEX_CHUNK   ((sizeof(((net_log_record_t *)0)->data) / NET_HEX_BYTES_PER_LINE) * NET_HEX_BYTES_PER_LINE)
+
+typedef struct net_log_ring {
+    NET_CACHE_ALIGNED uint32_t head;        // 生产者（所属线程）
+    uint32_t tail_cache;
+    uint32_t dropped;                       // 环满丢弃条数
+    NET_CACHE_ALIGNED uint32_t tail;        // 消费者（日志线程）
+    uint32_t dropped_reported;
+    int orphaned;                           // 所属线程已退出，排空后释放
+    struct net_log_ring *next;
+    net_log_record_t slots[NET_LOG_RING_SLOTS];
+} net_log_ring_t;
+
+static pthread_once_t g_log_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_log_key;
+static pthread_mutex_t g_log_rings_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t g_log_drain_lock = PTHREAD_MUTEX_INITIALIZER;
+static net_log_ring_t *g_log_rings = NULL;
+static uint32_t g_log_wake_seq = 0;
+static uint32_t g_log_waiting = 0;
+static __thread net_log_ring_t *t_log_ring = NULL;
+
+typedef struct {
+    char buf[NET_LOG_OUT_BUF_SIZE];
+    size_t length;
+    int fd;
+} net_log_out_t;
+
+static void net_log_out_flush(net_log_out_t *out) {
+    net_write_all(out->fd, out->buf, out->length);
+    out->length = 0;
+}
+
+static char *net_log_out_reserve(net_log_out_t *out, size_t length) {
+    if (out->length + length > sizeof(out->buf)) {
+        net_log_out_flush(out);
+    }
+    return out->buf + out->length;
+}
+
+static void net_log_out_text(net_log_out_t *out, uint8_t level, const char *text, size_t length) {
+    const char *prefix;
+    const char *color = net_log_color(level, &prefix);
+    char *p = net_log_out_reserve(out, length + 64);
+
+    out->length += (size_t)sprintf(p, "%s%s  %.*s%s\n", color, prefix, (int)length, text, COLOR_RESET);
+}
+
+static void net_log_out_hex(net_log_out_t *out, const unsigned char *data, size_t length, size_t base) {
+    for (size_t offset = 0; offset < length; offset += NET_HEX_BYTES_PER_LINE) {
+        size_t n = length - offset < NET_HEX_BYTES_PER_LINE ? length - offset : NET_HEX_BYTES_PER_LINE;
+        char *p = net_log_out_reserve(out, NET_HEX_LINE_MAX);
+
+        p += net_hex_format_line(p, data + offset, n, base + offset);
+        *p++ = '\n';
+        out->length = (size_t)(p - out->buf);
+    }
+}
+
+// 排空所有线程的日志环，返回处理的记录数
+static size_t net_log_drain(void) {
+    static net_log_out_t err_out = { .fd = STDERR_FILENO };
+    static net_log_out_t hex_out = { .fd = STDOUT_FILENO };
+    size_t total = 0;
+
+    pthread_mutex_lock(&g_log_drain_lock);
+    pthread_mutex_lock(&g_log_rings_lock);
+    net_log_ring_t **link = &g_log_rings;
+    while (*link) {
+        net_log_ring_t *ring = *link;
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint32_t tail = ring->tail;
+
+        for (; tail != head; tail++) {
+            net_log_record_t *rec = &ring->slots[tail & (NET_LOG_RING_SLOTS - 1)];
+            if (rec->type == NET_LOG_TYPE_HEX) {
+                net_log_out_hex(&hex_out, (const unsigned char *)rec->data, rec->length, rec->offset);
             } else {
-                printf(" "); // 对齐填充
+                net_log_out_text(&err_out, rec->level, rec->data, rec->length);
             }
+            total++;
+        }
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+        uint32_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+        if (dropped != ring->dropped_reported) {
+            char msg[64];
+            int n = snprintf(msg, sizeof(msg), "%u log messages dropped", dropped - ring->dropped_reported);
+            net_log_out_text(&err_out, NET_LOG_LEVEL_WARNING, msg, (size_t)n);
+            ring->dropped_reported = dropped;
         }
-        
-        printf("\n");
+
+        // 线程已退出且已排空，释放日志环
+        if (__atomic_load_n(&ring->orphaned, __ATOMIC_ACQUIRE) &&
+            __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail) {
+            *link = ring->next;
+            free(ring);
+            continue;
+        }
+        link = &ring->next;
     }
-}
+    pthread_mutex_unlock(&g_log_rings_lock);
 
-// 基础日志函数（整行着色）
-void net_base_log(uint8_t level, const char* file, int line, const char* fmt, ...) {
-    const char* color = COLOR_RESET;
-    const char* prefix = "";
-    
-    switch(level) {
-        case NET_LOG_LEVEL_DEBUG:   color = COLOR_DEBUG;   prefix = "[DEBUG]  "; break;
-        case NET_LOG_LEVEL_INFO:    color = COLOR_INFO;    prefix = "[INFO]   "; break;
-        case NET_LOG_LEVEL_WARNING: color = COLOR_WARNING; prefix = "[WARNING]"; break;
-        case NET_LOG_LEVEL_ERROR:   color = COLOR_ERROR;   prefix = "[ERROR]  "; break;
-    }
-    
-    // 打印带颜色的日志头
-    // fprintf(stderr, "%s%s %s:%d ", color, prefix, file, line);
-    fprintf(stderr, "%s%s  ", color, prefix);
-    
-    // 打印带颜色的日志内容
-    va_list args;
-    va_start(args, fmt);
-    vfprintf(stderr, fmt, args);
-    va_end(args);
-    
-    // 重置颜色并换行
-    fprintf(stderr, "%s\n", COLOR_RESET);
+    // 先输出HEX（stdout）再输出文本（stderr）时两者可能交错，按原有通道各自刷出
+    if (hex_out.length) {
+        net_log_out_flush(&hex_out);
+    }
+    if (err_out.length) {
+        net_log_out_flush(&err_out);
+    }
+    pthread_mutex_unlock(&g_log_drain_lock);
+
+    return total;
 }
 
-static void *net_task_adapter(void *arg) {
-    net_task_t *task = (net_task_t *)arg;
-    task->start_routine(task->arg);
+static void *net_log_thread_func(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        if (net_log_drain() > 0) {
+            continue;
+        }
+
+        // 没有日志时挂起，生产者只在日志线程挂起时才唤醒
+        uint32_t seq = __atomic_load_n(&g_log_wake_seq, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&g_log_waiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (net_log_drain() == 0) {
+            struct timespec timeout = { .tv_sec = 0, .tv_nsec = NET_LOG_IDLE_WAIT_MS * 1000000L };
+            net_futex_wait(&g_log_wake_seq, seq, &timeout);
+        }
+        __atomic_store_n(&g_log_waiting, 0, __ATOMIC_RELAXED);
+    }
+
     return NULL;
 }
 
-void *net_create_task(void (*start_routine)(void *), void *arg)
-{
-    net_task_t *task = (net_task_t *)NET_MALLOC(sizeof(net_task_t));
-    if (task == NULL) {
-        NET_LOGE("Failed to allocate memory for task");
-        return NULL;
+// 线程退出时标记日志环，由日志线程排空后释放
+static void net_log_thread_exit(void *arg) {
+    net_log_ring_t *ring = (net_log_ring_t *)arg;
+    __atomic_store_n(&ring->orphaned, 1, __ATOMIC_RELEASE);
+}
+
+static void net_log_exit(void) {
+    net_log_drain();
+}
+
+static void net_log_start(void) {
+    pthread_t thread;
+
+    pthread_key_create(&g_log_key, net_log_thread_exit);
+    if (pthread_create(&thread, NULL, net_log_thread_func, NULL) == 0) {
+        pthread_detach(thread);
+#ifdef __linux__
+        pthread_setname_np(thread, "net-log");
+#endif
     }
-    task->start_routine = start_routine;
-    task->arg = arg;
-    task->is_running = 0;
-    task->is_joined = 0;
-    task->thread_id = 0;
-    return (void *)task;
+    atexit(net_log_exit);
 }
 
-int net_task_start(void *task)
-{
-    if (task == NULL) {
-        NET_LOGE("Task is NULL");
-        return -1;
+static net_log_ring_t *net_log_thread_ring(void) {
+    if (t_log_ring) {
+        return t_log_ring;
     }
 
-    if (pthread_create(&((net_task_t *)task)->thread_id, NULL, net_task_adapter, (net_task_t *)task) != 0) {
-        NET_LOGE("Failed to create task");
-        NET_FREE(task);
-        return -1;
+    pthread_once(&g_log_once, net_log_start);
+
+    net_log_ring_t *ring = (net_log_ring_t *)aligned_alloc(NET_CACHE_LINE, sizeof(net_log_ring_t));
+    if (!ring) {
+        return NULL;
     }
-    
-    ((net_task_t *)task)->is_running = 1;
-    ((net_task_t *)task)->is_joined = 0;
+    memset(ring, 0, offsetof(net_log_ring_t, slots));
 
-    return 0;
+    pthread_mutex_lock(&g_log_rings_lock);
+    ring->next = g_log_rings;
+    g_log_rings = ring;
+    pthread_mutex_unlock(&g_log_rings_lock);
+
+    pthread_setspecific(g_log_key, ring);
+    t_log_ring = ring;
+    return ring;
 }
 
-int net_task_delete(void *task)
-{
-    if (task == NULL) {
-        NET_LOGE("Task is NULL");
-        return -1;
+static net_log_record_t *net_log_reserve(net_log_ring_t *ring) {
+    uint32_t head = ring->head;
+
+    if (head - ring->tail_cache >= NET_LOG_RING_SLOTS) {
+        ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head - ring->tail_cache >= NET_LOG_RING_SLOTS) {
+            __atomic_add_fetch(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
     }
 
-    if (((net_task_t *)task)->is_running) {
-        pthread_cancel(((net_task_t *)task)->thread_id);
-        ((net_task_t *)task)->is_running = 0;
+    return &ring->slots[head & (NET_LOG_RING_SLOTS - 1)];
+}
+
+static void net_log_commit(net_log_ring_t *ring) {
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&g_log_waiting, __ATOMIC_RELAXED)) {
+        __atomic_add_fetch(&g_log_wake_seq, 1, __ATOMIC_RELEASE);
+        net_futex_wake(&g_log_wake_seq, 1);
     }
+}
 
-    if (!((net_task_t *)task)->is_joined) {
-        pthread_join(((net_task_t *)task)->thread_id, NULL);
-        ((net_task_t *)task)->is_joined = 1;
+void net_base_hex(const unsigned char *data, size_t length) {
+    net_log_ring_t *ring = net_log_thread_ring();
+    if (!ring) {
+        return;
     }
 
-    NET_FREE(task);
-    return 0;
+    // 只拷贝原始字节，格式化在日志线程中完成
+    for (size_t offset = 0; offset < length; offset += NET_LOG_HEX_CHUNK) {
+        net_log_record_t *rec = net_log_reserve(ring);
+        if (!rec) {
+            return;
+        }
+
+        size_t n = length - offset < NET_LOG_HEX_CHUNK ? length - offset : NET_LOG_HEX_CHUNK;
+        rec->type = NET_LOG_TYPE_HEX;
+        rec->level = NET_LOG_LEVEL_DEBUG;
+        rec->length = (uint16_t)n;
+        rec->offset = (uint32_t)offset;
+        memcpy(rec->data, data + offset, n);
+        net_log_commit(ring);
+    }
 }
 
+// 基础日志函数（整行着色）
+void net_base_log(uint8_t level, const char* file, int line, const char* fmt, ...) {
+    (void)file;
+    (void)line;
 
-void *net_create_sem(void)
-{
-    net_sem_t *sem = (net_sem_t *)NET_MALLOC(sizeof(net_sem_t));
-    if (sem == NULL) {
-        NET_LOGE("Failed to allocate memory for semaphore");
-        return NULL;
+    net_log_ring_t *ring = net_log_thread_ring();
+    if (!ring) {
+        return;
     }
 
-    if (sem_init(&sem->semaphore, 0, 1) != 0) {
-        NET_LOGE("Failed to initialize semaphore");
-        NET_FREE(sem);
-        return NULL;
+    net_log_record_t *rec = net_log_reserve(ring);
+    if (!rec) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(rec->data, sizeof(rec->data), fmt, args);
+    va_end(args);
+
+    if (n < 0) {
+        n = 0;
+    } else if ((size_t)n >= sizeof(rec->data)) {
+        n = sizeof(rec->data) - 1; // 超长截断
     }
 
-    sem->userdata = NULL;
+    rec->type = NET_LOG_TYPE_TEXT;
+    rec->level = level;
+    rec->length = (uint16_t)n;
+    net_log_commit(ring);
+}
 
-    return sem;
+void net_log_flush(void) {
+    net_log_drain();
 }
 
-int net_sem_wait(void *sem)
-{
-    if (sem == NULL) {
-        NET_LOGE("Semaphore is NULL");
-        return -1;
-    }
+#else
 
-    return sem_wait(&((net_sem_t *)sem)->semaphore);
+void net_base_hex(const unsigned char *data, size_t length) {
+    char line[NET_HEX_LINE_MAX];
+
+    // 每行格式化好后一次输出
+    for (size_t offset = 0; offset < length; offset += NET_HEX_BYTES_PER_LINE) {
+        size_t n = length - offset < NET_HEX_BYTES_PER_LINE ? length - offset : NET_HEX_BYTES_PER_LINE;
+        int len = net_hex_format_line(line, data + offset, n, offset);
+        line[len++] = '\n';
+        fwrite(line, 1, (size_t)len, stdout);
+    }
 }
 
-int net_sem_post(void *sem)
-{
-    if (sem == NULL) {
-        NET_LOGE("Semaphore is NULL");
-        return -1;
+// 基础日志函数（整行着色）
+void net_base_log(uint8_t level, const char* file, int line, const char* fmt, ...) {
+    const char* prefix = "";
+    const char* color = net_log_color(level, &prefix);
+    char buf[512];
+
+    (void)file;
+    (void)line;
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    if (n < 0) {
+        n = 0;
+    } else if ((size_t)n >= sizeof(buf)) {
+        n = sizeof(buf) - 1;
     }
 
-    return sem_post(&((net_sem_t *)sem)->semaphore);
+    // 整行一次输出，避免多线程交错
+    fprintf(stderr, "%s%s  %.*s%s\n", color, prefix, n, buf, COLOR_RESET);
 }
 
-int net_sem_destroy(void *sem)
-{
-    if (sem == NULL) {
-        NET_LOGE("Semaphore is NULL");
-        return -1;
+void net_log_flush(void) {
+    fflush(stdout);
+    fflush(stderr);
+}
+
+#endif
+
+// 调用点限速：每个窗口内最多放行NET_LOG_RATELIMIT_BURST条，窗口开始时报告上个窗口被抑制的条数
+int net_log_ratelimit(net_log_ratelimit_t *rl) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint32_t now = (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+    uint32_t start = __atomic_load_n(&rl->window_start, __ATOMIC_RELAXED);
+
+    if (!rl->initialized || now - start >= NET_LOG_RATELIMIT_INTERVAL_MS) {
+        if (__atomic_compare_exchange_n(&rl->window_start, &start, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            uint32_t suppressed = __atomic_exchange_n(&rl->suppressed, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&rl->count, 0, __ATOMIC_RELAXED);
+            rl->initialized = 1;
+            if (suppressed) {
+                net_base_log(NET_LOG_LEVEL_WARNING, __FILE__, __LINE__, "%u similar messages suppressed", suppressed);
+            }
+        }
     }
 
-    sem_destroy(&((net_sem_t *)sem)->semaphore);
-    NET_FREE(sem);
+    if (__atomic_add_fetch(&rl->count, 1, __ATOMIC_RELAXED) <= NET_LOG_RATELIMIT_BURST) {
+        return 1;
+    }
 
+    __atomic_add_fetch(&rl->suppressed, 1, __ATOMIC_RELAXED);
     return 0;
 }
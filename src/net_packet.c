@@ -0,0 +1,220 @@
+#include <stdint.h>
+#include <string.h>
+#include "net_device.h"
+#include "net_packet.h"
+#include "net_pool.h"
+
+net_pkt_t *net_pkt_alloc(net_device_t *dev, size_t length) {
+    size_t need = sizeof(net_pkt_t) + NET_PKT_HEADROOM + length;
+    net_pkt_t *pkt = (net_pkt_t *)net_packet_alloc(dev, need);
+
+    if (!pkt) {
+        return NULL;
+    }
+
+    pkt->size = (uint32_t)(net_pool_block_size(dev->pool, pkt) - sizeof(net_pkt_t));
+    pkt->data = pkt->buf + NET_PKT_HEADROOM;
+    pkt->len = 0;
+    return pkt;
+}
+
+void net_pkt_free(net_device_t *dev, net_pkt_t *pkt) {
+    net_packet_free(dev, (uint8_t *)pkt);
+}
+
+net_pkt_t *net_pkt_from_data(net_device_t *dev, uint8_t *data) {
+    return (net_pkt_t *)net_pool_block_start(dev->pool, data);
+}
+
+size_t net_eth_build_header(uint8_t *frame, const uint8_t dst[NET_ETH_ALEN],
+                            const uint8_t src[NET_ETH_ALEN], uint16_t ethertype) {
+    memcpy(frame, dst, NET_ETH_ALEN);
+    memcpy(frame + NET_ETH_ALEN, src, NET_ETH_ALEN);
+    frame[12] = (uint8_t)(ethertype >> 8);
+    frame[13] = (uint8_t)ethertype;
+    return NET_ETH_HLEN;
+}
+
+int net_pkt_push_eth(net_pkt_t *pkt, const uint8_t dst[NET_ETH_ALEN],
+                     const uint8_t src[NET_ETH_ALEN], uint16_t ethertype) {
+    uint8_t *hdr = net_pkt_push(pkt, NET_ETH_HLEN);
+    if (!hdr) {
+        return -1;
+    }
+
+    net_eth_build_header(hdr, dst, src, ethertype);
+    return 0;
+}
+
+int net_pkt_push_vlan(net_pkt_t *pkt, uint16_t tpid, uint8_t pcp, uint16_t vid) {
+    if (pkt->len < NET_ETH_HLEN || !net_pkt_push(pkt, NET_VLAN_HLEN)) {
+        return -1;
+    }
+
+    uint8_t *frame = pkt->data;
+    uint16_t tci = (uint16_t)(((pcp & 0x7) << 13) | (vid & 0x0FFF));
+
+    memmove(frame, frame + NET_VLAN_HLEN, NET_ETH_ALEN * 2);
+    frame[12] = (uint8_t)(tpid >> 8);
+    frame[13] = (uint8_t)tpid;
+    frame[14] = (uint8_t)(tci >> 8);
+    frame[15] = (uint8_t)tci;
+    return 0;
+}
+
+static inline int net_eth_is_vlan(uint16_t type) {
+    return type == NET_ETHERTYPE_VLAN || type == NET_ETHERTYPE_QINQ;
+}
+
+int net_pkt_pop_vlan(net_pkt_t *pkt, uint16_t *tci) {
+    uint8_t *frame = pkt->data;
+
+    if (pkt->len < NET_ETH_HLEN + NET_VLAN_HLEN ||
+        !net_eth_is_vlan((uint16_t)((frame[12] << 8) | frame[13]))) {
+        return -1;
+    }
+
+    if (tci) {
+        *tci = (uint16_t)((frame[14] << 8) | frame[15]);
+    }
+
+    memmove(frame + NET_VLAN_HLEN, frame, NET_ETH_ALEN * 2);
+    net_pkt_pull(pkt, NET_VLAN_HLEN);
+    return 0;
+}
+
+uint16_t net_eth_get_type(const uint8_t *frame, size_t length) {
+    size_t off = NET_ETH_ALEN * 2;
+
+    while (off + 2 <= length) {
+        uint16_t type = (uint16_t)((frame[off] << 8) | frame[off + 1]);
+        if (!net_eth_is_vlan(type)) {
+            return type;
+        }
+        off += NET_VLAN_HLEN;
+    }
+
+    return 0;
+}
+
+// ---------------------------------------------------------------- 流哈希
+
+#define NET_IPPROTO_TCP     6
+#define NET_IPPROTO_UDP     17
+#define NET_IPPROTO_SCTP    132
+
+_Static_assert(sizeof(net_pkt_meta_t) == NET_PKT_META_SIZE, "net_pkt_meta_t must fill one cache line");
+
+static inline uint32_t net_load32(const uint8_t *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// MurmurHash3的一轮与收尾
+static inline uint32_t net_hash_mix(uint32_t h, uint32_t k) {
+    k *= 0xCC9E2D51u;
+    k = (k << 15) | (k >> 17);
+    k *= 0x1B873593u;
+    h ^= k;
+    h = (h << 13) | (h >> 19);
+    return h * 5 + 0xE6546B64u;
+}
+
+static inline uint32_t net_hash_final(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+static inline int net_proto_has_ports(uint8_t proto) {
+    return proto == NET_IPPROTO_TCP || proto == NET_IPPROTO_UDP || proto == NET_IPPROTO_SCTP;
+}
+
+static inline uint16_t net_load16(const uint8_t *p) {
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t net_flow_hash(const uint8_t *frame, size_t length) {
+    size_t off = NET_ETH_ALEN * 2;
+    uint16_t type;
+    uint32_t h = 0;
+
+    for (;;) {
+        if (off + 2 > length) {
+            return 0;
+        }
+        type = (uint16_t)((frame[off] << 8) | frame[off + 1]);
+        if (!net_eth_is_vlan(type)) {
+            off += 2;
+            break;
+        }
+        off += NET_VLAN_HLEN;
+    }
+
+    const uint8_t *ip = frame + off;
+    size_t remain = length - off;
+    const uint8_t *src;
+    const uint8_t *dst;
+    size_t alen;
+    uint8_t proto;
+    size_t l4;
+
+    if (type == NET_ETHERTYPE_IPV4 && remain >= 20) {
+        proto = ip[9];
+        l4 = (size_t)(ip[0] & 0x0F) * 4;
+        src = ip + 12;
+        dst = ip + 16;
+        alen = 4;
+        // 分片没有端口，按地址对哈希，保证同一报文的各分片落在一起
+        if ((((ip[6] << 8) | ip[7]) & 0x3FFF) != 0) {
+            proto = 0;
+        }
+    } else if (type == NET_ETHERTYPE_IPV6 && remain >= 40) {
+        proto = ip[6];
+        l4 = 40;
+        src = ip + 8;
+        dst = ip + 24;
+        alen = 16;
+    } else {
+        return 0;
+    }
+
+    uint16_t sport = 0;
+    uint16_t dport = 0;
+    bool ports = net_proto_has_ports(proto) && l4 + 4 <= remain;
+    if (ports) {
+        sport = net_load16(ip + l4);
+        dport = net_load16(ip + l4 + 2);
+    }
+
+    // 对称：(地址,端口)较小的一端在前，两个方向得到同一哈希
+    int cmp = memcmp(src, dst, alen);
+    if (cmp > 0 || (cmp == 0 && sport > dport)) {
+        const uint8_t *addr = src;
+        src = dst;
+        dst = addr;
+        uint16_t port = sport;
+        sport = dport;
+        dport = port;
+    }
+
+    for (size_t i = 0; i < alen; i += 4) {
+        h = net_hash_mix(h, net_load32(src + i));
+    }
+    for (size_t i = 0; i < alen; i += 4) {
+        h = net_hash_mix(h, net_load32(dst + i));
+    }
+    h = net_hash_mix(h, proto);
+    if (ports) {
+        h = net_hash_mix(h, (uint32_t)sport | ((uint32_t)dport << 16));
+    }
+
+    h = net_hash_final(h ^ (uint32_t)type);
+    return h ? h : 1;
+}
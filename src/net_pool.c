@@ -0,0 +1,220 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include "net_device.h"
+#include "net_ring.h"
+#include "net_pool.h"
+#include "net_packet.h"
+
+#define NET_POOL_HUGEPAGE_SIZE  (2 * 1024 * 1024)
+#define NET_POOL_PAGE_SIZE      4096
+
+#define NET_POOL_BIT_WORD(i)    ((i) / 64)
+#define NET_POOL_BIT_MASK(i)    (1ULL << ((i) % 64))
+
+static size_t net_pool_align(size_t value, size_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+// 优先MAP_HUGETLB；大页未预留时退回普通页并建议内核使用透明大页
+static uint8_t *net_pool_map(size_t *size, bool hugepages, bool *huge_used) {
+    void *mem;
+
+    *huge_used = false;
+
+#ifdef MAP_HUGETLB
+    if (hugepages) {
+        size_t huge_size = net_pool_align(*size, NET_POOL_HUGEPAGE_SIZE);
+        mem = mmap(NULL, huge_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mem != MAP_FAILED) {
+            *size = huge_size;
+            *huge_used = true;
+            return (uint8_t *)mem;
+        }
+        NET_LOGW("Hugepage pool unavailable (%d), falling back to normal pages", errno);
+    }
+#endif
+
+    *size = net_pool_align(*size, NET_POOL_PAGE_SIZE);
+    mem = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        return NULL;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (hugepages) {
+        madvise(mem, *size, MADV_HUGEPAGE);
+    }
+#endif
+    return (uint8_t *)mem;
+}
+
+net_pool_t *net_pool_create(const net_pool_class_t *classes, int class_nr, bool hugepages) {
+    net_pool_class_t sorted[NET_POOL_CLASS_MAX];
+    int nr = 0;
+
+    // 去掉空项并按大小升序排列
+    for (int i = 0; i < class_nr && i < NET_POOL_CLASS_MAX; i++) {
+        if (classes[i].size == 0 || classes[i].count == 0) {
+            continue;
+        }
+
+        int j = nr++;
+        while (j > 0 && sorted[j - 1].size > classes[i].size) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = classes[i];
+    }
+
+    if (nr == 0) {
+        NET_LOGE("No packet pool size class configured");
+        return NULL;
+    }
+
+    net_pool_t *pool = (net_pool_t *)calloc(1, sizeof(net_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+
+    size_t total = 0;
+    for (int i = 0; i < nr; i++) {
+        net_pool_class_state_t *cls = &pool->classes[i];
+        cls->size = sorted[i].size;
+        cls->count = sorted[i].count;
+        cls->block_size = net_pool_align(sorted[i].size, NET_CACHE_LINE);
+        cls->stride = NET_PKT_META_SIZE + cls->block_size;
+        total += cls->stride * cls->count;
+        pool->capacity += cls->count;
+    }
+    pool->class_nr = nr;
+
+    pool->region_size = total;
+    pool->region = net_pool_map(&pool->region_size, hugepages, &pool->hugepages);
+    if (!pool->region) {
+        NET_LOGE("Failed to map packet pool (%zu bytes)", total);
+        free(pool);
+        return NULL;
+    }
+
+    uint8_t *base = pool->region;
+    for (int i = 0; i < nr; i++) {
+        net_pool_class_state_t *cls = &pool->classes[i];
+
+        cls->base = base;
+        base += cls->stride * cls->count;
+
+        cls->free_stack = (uint32_t *)malloc(cls->count * sizeof(uint32_t));
+        cls->in_use = (uint64_t *)calloc(NET_POOL_BIT_WORD(cls->count) + 1, sizeof(uint64_t));
+        if (!cls->free_stack || !cls->in_use) {
+            free(cls->free_stack);
+            free(cls->in_use);
+            cls->free_stack = NULL;
+            cls->in_use = NULL;
+            net_pool_destroy(pool);
+            return NULL;
+        }
+
+        // 低地址的块先出栈
+        for (uint32_t k = 0; k < cls->count; k++) {
+            cls->free_stack[k] = cls->count - 1 - k;
+        }
+        cls->free_top = cls->count;
+        pthread_spin_init(&cls->lock, PTHREAD_PROCESS_PRIVATE);
+    }
+
+    return pool;
+}
+
+void net_pool_destroy(net_pool_t *pool) {
+    if (!pool) {
+        return;
+    }
+
+    for (int i = 0; i < pool->class_nr; i++) {
+        if (pool->classes[i].free_stack) {
+            pthread_spin_destroy(&pool->classes[i].lock);
+            free(pool->classes[i].free_stack);
+            free(pool->classes[i].in_use);
+        }
+    }
+
+    if (pool->region) {
+        munmap(pool->region, pool->region_size);
+    }
+    free(pool);
+}
+
+void *net_pool_alloc(net_pool_t *pool, size_t length) {
+    for (int i = 0; i < pool->class_nr; i++) {
+        net_pool_class_state_t *cls = &pool->classes[i];
+        if (length > cls->size) {
+            continue;
+        }
+
+        pthread_spin_lock(&cls->lock);
+        if (cls->free_top > 0) {
+            uint32_t index = cls->free_stack[--cls->free_top];
+            cls->in_use[NET_POOL_BIT_WORD(index)] |= NET_POOL_BIT_MASK(index);
+            pthread_spin_unlock(&cls->lock);
+            return cls->base + (size_t)index * cls->stride + NET_PKT_META_SIZE;
+        }
+        pthread_spin_unlock(&cls->lock);
+    }
+
+    return NULL;
+}
+
+// 块内任意地址都能找到所属等级
+static net_pool_class_state_t *net_pool_find_class(net_pool_t *pool, const uint8_t *ptr) {
+    if (ptr < pool->region || ptr >= pool->region + pool->region_size) {
+        return NULL;
+    }
+
+    for (int i = 0; i < pool->class_nr; i++) {
+        net_pool_class_state_t *cls = &pool->classes[i];
+        if (ptr >= cls->base && ptr < cls->base + cls->stride * cls->count) {
+            return cls;
+        }
+    }
+
+    return NULL;
+}
+
+int net_pool_free(net_pool_t *pool, void *buffer) {
+    net_pool_class_state_t *cls = net_pool_find_class(pool, (const uint8_t *)buffer);
+    if (!cls) {
+        return -1;
+    }
+
+    uint32_t index = (uint32_t)((size_t)((uint8_t *)buffer - cls->base) / cls->stride);
+    pthread_spin_lock(&cls->lock);
+    // 重复释放会让同一块被分配两次，栈满后还会写出free_stack
+    if (!(cls->in_use[NET_POOL_BIT_WORD(index)] & NET_POOL_BIT_MASK(index)) || cls->free_top >= cls->count) {
+        pthread_spin_unlock(&cls->lock);
+        NET_LOGE("Double free of pool block %u (size %u)", index, cls->size);
+        return -1;
+    }
+    cls->in_use[NET_POOL_BIT_WORD(index)] &= ~NET_POOL_BIT_MASK(index);
+    cls->free_stack[cls->free_top++] = index;
+    pthread_spin_unlock(&cls->lock);
+    return 0;
+}
+
+void *net_pool_block_start(net_pool_t *pool, const void *ptr) {
+    net_pool_class_state_t *cls = net_pool_find_class(pool, (const uint8_t *)ptr);
+    if (!cls) {
+        return NULL;
+    }
+
+    size_t index = (size_t)((const uint8_t *)ptr - cls->base) / cls->stride;
+    return cls->base + index * cls->stride + NET_PKT_META_SIZE;
+}
+
+size_t net_pool_block_size(net_pool_t *pool, const void *ptr) {
+    net_pool_class_state_t *cls = net_pool_find_class(pool, (const uint8_t *)ptr);
+    return cls ? cls->block_size : 0;
+}
@@ -0,0 +1,59 @@
+#ifndef NET_POOL_H
+#define NET_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "net_device.h"
+
+// ======================================================================
+// 分级报文内存池（内部使用）
+//
+// 每个大小等级是一段连续内存上的定长块，空闲块用下标栈管理。
+// 所有等级放在同一次mmap中，可选大页，减少TLB缺失。
+// 申请时取能装下的最小等级，该等级耗尽时向更大的等级借用。
+// 每块前面紧挨着一个缓存行的元数据槽（net_pkt_meta_t），块本身仍按缓存行对齐：
+//
+//  +------+---------+------+---------+----
+//  | meta | block 0 | meta | block 1 | ...
+//  +------+---------+------+---------+----
+// ======================================================================
+
+typedef struct {
+    uint8_t *base;              // 第一个元数据槽
+    size_t block_size;          // 按缓存行对齐后的块大小
+    size_t stride;              // 元数据槽加块的大小
+    uint32_t size;              // 配置的可用大小
+    uint32_t count;
+    pthread_spinlock_t lock;
+    uint32_t *free_stack;       // 空闲块下标
+    uint32_t free_top;
+    uint64_t *in_use;           // 每块一位，置位表示已分配，用来拦截重复释放
+} net_pool_class_state_t;
+
+typedef struct net_pool {
+    net_pool_class_state_t classes[NET_POOL_CLASS_MAX];
+    int class_nr;
+    uint8_t *region;            // 所有等级共用的mmap区域
+    size_t region_size;
+    uint32_t capacity;          // 总块数
+    bool hugepages;             // 实际是否使用了大页
+} net_pool_t;
+
+net_pool_t *net_pool_create(const net_pool_class_t *classes, int class_nr, bool hugepages);
+void net_pool_destroy(net_pool_t *pool);
+
+void *net_pool_alloc(net_pool_t *pool, size_t length);
+// buffer可以指向块内任意位置；返回0成功，-1表示不是本池的缓冲区或该块未分配（重复释放）
+int net_pool_free(net_pool_t *pool, void *buffer);
+// 块内地址所在块的起始地址与大小，不是本池的地址返回NULL/0
+void *net_pool_block_start(net_pool_t *pool, const void *ptr);
+size_t net_pool_block_size(net_pool_t *pool, const void *ptr);
+
+// 最大等级的可用大小
+static inline size_t net_pool_max_size(const net_pool_t *pool) {
+    return pool->classes[pool->class_nr - 1].size;
+}
+
+#endif
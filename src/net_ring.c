@@ -0,0 +1,125 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "net_ring.h"
+#include "net_futex.h"
+
+net_ring_t *net_ring_create(size_t capacity) {
+    size_t size = 1;
+
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    net_ring_t *ring = (net_ring_t *)aligned_alloc(NET_CACHE_LINE, sizeof(net_ring_t));
+    if (!ring) {
+        return NULL;
+    }
+    memset(ring, 0, sizeof(net_ring_t));
+
+    ring->slots = (net_desc_t *)calloc(size, sizeof(net_desc_t));
+    if (!ring->slots) {
+        free(ring);
+        return NULL;
+    }
+
+    ring->capacity = capacity;
+    ring->mask = size - 1;
+    return ring;
+}
+
+void net_ring_destroy(net_ring_t *ring) {
+    if (!ring) {
+        return;
+    }
+
+    free(ring->slots);
+    free(ring);
+}
+
+void net_ring_wake(net_ring_t *ring) {
+    __atomic_add_fetch(&ring->wake_seq, 1, __ATOMIC_RELEASE);
+    net_futex_wake(&ring->wake_seq, 1);
+}
+
+void net_ring_cancel_wait(net_ring_t *ring) {
+    // 先置位再递增wake_seq：等待方读到新的wake_seq后一定能看到置位
+    __atomic_store_n(&ring->cancelled, 1, __ATOMIC_RELAXED);
+    net_ring_wake(ring);
+}
+
+static inline bool net_ring_empty(net_ring_t *ring) {
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == ring->tail;
+}
+
+int net_ring_wait(net_ring_t *ring, int timeout_ms) {
+    struct timespec deadline = { 0 };
+
+    // 先短暂自旋，数据通常很快到达，省去一次挂起/唤醒
+    for (int i = 0; i < NET_RING_SPIN_COUNT; i++) {
+        if (!net_ring_empty(ring)) {
+            return 1;
+        }
+        net_cpu_relax();
+    }
+
+    if (timeout_ms == 0) {
+        return 0;
+    }
+
+    if (timeout_ms > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&ring->wake_seq, __ATOMIC_ACQUIRE);
+
+        // 先声明挂起再检查，与生产者的 入队->检查waiting 配对，避免丢失唤醒
+        __atomic_store_n(&ring->waiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (!net_ring_empty(ring)) {
+            __atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+            return 1;
+        }
+        if (__atomic_load_n(&ring->cancelled, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+            return 0;
+        }
+
+        struct timespec remain;
+        struct timespec *timeout = NULL;
+        if (timeout_ms > 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            remain.tv_sec = deadline.tv_sec - now.tv_sec;
+            remain.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+            if (remain.tv_nsec < 0) {
+                remain.tv_sec--;
+                remain.tv_nsec += 1000000000L;
+            }
+            if (remain.tv_sec < 0) {
+                __atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+                return 0;
+            }
+            timeout = &remain;
+        }
+
+        net_futex_wait(&ring->wake_seq, seq, timeout);
+        __atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+
+        if (!net_ring_empty(ring)) {
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef NET_RING_H
+#define NET_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// ======================================================================
+// 单生产者/单消费者无锁描述符环
+//
+// 生产者与消费者的索引位于不同缓存行，各自缓存对方的索引，
+// 只有缓存值判断为满/空时才去读对方缓存行，避免缓存行来回迁移。
+// 消费者可以挂起等待（先自旋再futex），生产者只在消费者挂起时才发起唤醒。
+// ======================================================================
+
+#define NET_CACHE_LINE      64
+#define NET_CACHE_ALIGNED   __attribute__((aligned(NET_CACHE_LINE)))
+
+#define NET_RING_SPIN_COUNT 2048   // 挂起前自旋检查次数
+
+typedef struct {
+    uint8_t *buffer;
+    size_t length;
+    uint64_t stamp;     // 入队时间(ns)，用于统计排队延迟
+} net_desc_t;
+
+typedef struct net_ring {
+    // 只读
+    NET_CACHE_ALIGNED net_desc_t *slots;
+    size_t capacity;
+    size_t mask;
+
+    // 生产者
+    NET_CACHE_ALIGNED size_t head;
+    size_t tail_cache;
+
+    // 消费者
+    NET_CACHE_ALIGNED size_t tail;
+    size_t head_cache;
+
+    // 等待/唤醒
+    NET_CACHE_ALIGNED uint32_t wake_seq;  // futex字，生产者唤醒时递增
+    uint32_t waiting;                     // 消费者已挂起
+    uint32_t cancelled;                   // net_ring_cancel_wait之后不再挂起
+} net_ring_t;
+
+static inline void net_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+net_ring_t *net_ring_create(size_t capacity);
+void net_ring_destroy(net_ring_t *ring);
+
+// 消费者挂起等待，timeout_ms<0一直等待
+// 返回 1：有数据；0：超时或等待已取消
+int net_ring_wait(net_ring_t *ring, int timeout_ms);
+void net_ring_wake(net_ring_t *ring);
+// 取消等待并唤醒消费者：之后net_ring_wait在队列为空时立即返回0（停止消费线程用）
+void net_ring_cancel_wait(net_ring_t *ring);
+
+// ---------------------------------------------------------------- 生产者
+
+// 可写入的空位数
+static inline size_t net_ring_free_count(net_ring_t *ring) {
+    size_t head = ring->head;
+    size_t free = ring->capacity - (head - ring->tail_cache);
+
+    if (free == 0) {
+        ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        free = ring->capacity - (head - ring->tail_cache);
+    }
+
+    return free;
+}
+
+static inline size_t net_ring_enqueue_burst(net_ring_t *ring, const net_desc_t *descs, size_t n) {
+    size_t head = ring->head;
+
+    if (ring->capacity - (head - ring->tail_cache) < n) {
+        ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        size_t free = ring->capacity - (head - ring->tail_cache);
+        if (n > free) {
+            n = free;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        ring->slots[(head + i) & ring->mask] = descs[i];
+    }
+
+    __atomic_store_n(&ring->head, head + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+static inline bool net_ring_enqueue(net_ring_t *ring, uint8_t *buffer, size_t length, uint64_t stamp) {
+    net_desc_t desc = { .buffer = buffer, .length = length, .stamp = stamp };
+    return net_ring_enqueue_burst(ring, &desc, 1) == 1;
+}
+
+// 一批入队后调用：消费者挂起时才唤醒
+static inline void net_ring_notify(net_ring_t *ring) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->waiting, __ATOMIC_RELAXED)) {
+        net_ring_wake(ring);
+    }
+}
+
+// ---------------------------------------------------------------- 消费者
+
+static inline size_t net_ring_dequeue_burst(net_ring_t *ring, net_desc_t *descs, size_t n) {
+    size_t tail = ring->tail;
+
+    if (ring->head_cache - tail < n) {
+        ring->head_cache = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        size_t avail = ring->head_cache - tail;
+        if (n > avail) {
+            n = avail;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        descs[i] = ring->slots[(tail + i) & ring->mask];
+    }
+
+    __atomic_store_n(&ring->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+static inline uint8_t *net_ring_dequeue(net_ring_t *ring, size_t *length) {
+    net_desc_t desc;
+
+    if (net_ring_dequeue_burst(ring, &desc, 1) == 0) {
+        return NULL;
+    }
+
+    if (length) {
+        *length = desc.length;
+    }
+    return desc.buffer;
+}
+
+// 当前元素个数（近似值，任意线程可调用）
+static inline size_t net_ring_count(const net_ring_t *ring) {
+    // 先读tail再读head，保证差值不会为负
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+}
+
+#endif
@@ -0,0 +1,138 @@
+#include <stdlib.h>
+#include <string.h>
+#include "net_device.h"
+#include "net_backend.h"
+#include "net_stats.h"
+
+net_stats_t *net_stats_create(uint32_t pool_capacity) {
+    net_stats_t *stats = (net_stats_t *)aligned_alloc(NET_CACHE_LINE, sizeof(net_stats_t));
+    if (!stats) {
+        return NULL;
+    }
+
+    memset(stats, 0, sizeof(net_stats_t));
+    stats->pool_capacity = pool_capacity;
+    stats->rx.pool_free_min = pool_capacity;
+    return stats;
+}
+
+void net_stats_destroy(net_stats_t *stats) {
+    free(stats);
+}
+
+uint32_t net_stats_pool_in_use(const net_stats_t *stats) {
+    uint64_t alloc = __atomic_load_n(&stats->rx.pool_alloc, __ATOMIC_RELAXED) +
+                     __atomic_load_n(&stats->tx.pool_alloc, __ATOMIC_RELAXED);
+    uint64_t freed = __atomic_load_n(&stats->app.pool_free, __ATOMIC_RELAXED);
+
+    return alloc > freed ? (uint32_t)(alloc - freed) : 0;
+}
+
+// 每批只读一次对方缓存行，不在每帧上付出跨核访问
+void net_stats_rx_commit(net_device_t *dev) {
+    net_stats_t *stats = dev->stats;
+    uint32_t depth = (uint32_t)net_ring_count(dev->rx_ring);
+    uint32_t in_use = net_stats_pool_in_use(stats);
+    uint32_t free_blocks = in_use < stats->pool_capacity ? stats->pool_capacity - in_use : 0;
+
+    if (depth > stats->rx.ring_depth_max) {
+        __atomic_store_n(&stats->rx.ring_depth_max, depth, __ATOMIC_RELAXED);
+    }
+    if (free_blocks < stats->rx.pool_free_min) {
+        __atomic_store_n(&stats->rx.pool_free_min, free_blocks, __ATOMIC_RELAXED);
+    }
+}
+
+static void net_hist_snapshot(net_hist_t *dst, const net_hist_t *src) {
+    dst->count = __atomic_load_n(&src->count, __ATOMIC_RELAXED);
+    dst->sum = __atomic_load_n(&src->sum, __ATOMIC_RELAXED);
+    dst->max = __atomic_load_n(&src->max, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < NET_HIST_BUCKETS; i++) {
+        dst->buckets[i] = __atomic_load_n(&src->buckets[i], __ATOMIC_RELAXED);
+    }
+}
+
+#define NET_STAT_LOAD(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+
+int net_get_stats(net_device_t *dev, net_device_stats_t *out) {
+    net_stats_t *stats = dev->stats;
+
+    if (!stats || !out) {
+        return -1;
+    }
+
+    memset(out, 0, sizeof(net_device_stats_t));
+
+    out->rx_packets         = NET_STAT_LOAD(stats->rx.packets);
+    out->rx_bytes           = NET_STAT_LOAD(stats->rx.bytes);
+    out->rx_delivered       = NET_STAT_LOAD(stats->app.delivered);
+    out->rx_gro_merged      = NET_STAT_LOAD(stats->rx.gro_merged);
+    out->rx_drop_oversize   = NET_STAT_LOAD(stats->rx.drop_oversize);
+    out->rx_drop_desync     = NET_STAT_LOAD(stats->rx.drop_desync);
+    out->rx_drop_fcs        = NET_STAT_LOAD(stats->rx.drop_fcs);
+    out->rx_drop_csum       = NET_STAT_LOAD(stats->rx.drop_csum);
+    out->rx_drop_filter     = NET_STAT_LOAD(stats->rx.drop_filter);
+    out->rx_diverted        = NET_STAT_LOAD(stats->rx.diverted);
+    out->rx_drop_overload   = NET_STAT_LOAD(stats->rx.drop_overload) + NET_STAT_LOAD(stats->app.drop_stale);
+    out->rx_overload_events = NET_STAT_LOAD(stats->rx.overload);
+    out->rx_stall_nobuf     = NET_STAT_LOAD(stats->rx.stall_nobuf);
+    out->rx_stall_ring_full = NET_STAT_LOAD(stats->rx.stall_ring_full);
+
+    out->tx_packets         = NET_STAT_LOAD(stats->tx.packets);
+    out->tx_bytes           = NET_STAT_LOAD(stats->tx.bytes);
+    out->tx_errors          = NET_STAT_LOAD(stats->tx.errors);
+    out->tx_drop_nobuf      = NET_STAT_LOAD(stats->tx.drop_nobuf);
+
+    out->pool_capacity      = stats->pool_capacity;
+    out->pool_in_use        = net_stats_pool_in_use(stats);
+    out->pool_free_min      = NET_STAT_LOAD(stats->rx.pool_free_min);
+    out->rx_ring_depth      = dev->rx_ring ? (uint32_t)net_ring_count(dev->rx_ring) : 0;
+    out->rx_ring_depth_max  = NET_STAT_LOAD(stats->rx.ring_depth_max);
+
+    net_hist_snapshot(&out->rx_latency, &stats->rx_latency);
+    net_hist_snapshot(&out->tx_latency, &stats->tx_latency);
+
+    // 后端补充的计数（如内核丢包）
+    if (dev->backend && dev->backend->stats) {
+        dev->backend->stats(dev, out);
+    }
+
+    return 0;
+}
+
+uint64_t net_hist_percentile(const net_hist_t *hist, double percentile) {
+    if (hist->count == 0) {
+        return 0;
+    }
+
+    if (percentile < 0) {
+        percentile = 0;
+    } else if (percentile > 100) {
+        percentile = 100;
+    }
+
+    uint64_t target = (uint64_t)((double)hist->count * percentile / 100.0 + 0.5);
+    uint64_t seen = 0;
+
+    if (target == 0) {
+        target = 1;
+    }
+
+    for (size_t i = 0; i < NET_HIST_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen < target) {
+            continue;
+        }
+
+        if (i < (1u << NET_HIST_SUB_BITS)) {
+            return i;
+        }
+
+        unsigned shift = (unsigned)(i >> NET_HIST_SUB_BITS) - 1;
+        uint64_t sub = i & ((1u << NET_HIST_SUB_BITS) - 1);
+        uint64_t upper = (((1ULL << NET_HIST_SUB_BITS) + sub + 1) << shift) - 1;
+        return upper < hist->max ? upper : hist->max;
+    }
+
+    return hist->max;
+}
@@ -0,0 +1,121 @@
+#ifndef NET_STATS_H
+#define NET_STATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include "net_time.h"
+#include "net_device.h"
+#include "net_ring.h"
+
+// ======================================================================
+// 设备统计（内部使用）
+//
+// 计数器按写入线程分组，每组独占缓存行：
+//   rx  —— 后端接收线程（单写者）
+//   app —— 接收接口的使用者线程（单个接收队列时单写者，多队列时原子加）
+//   tx  —— 发送线程（可能多个，用原子加）
+// 单写者计数用普通读加原子写，不产生锁前缀指令。
+// ======================================================================
+
+typedef struct net_stats {
+    struct {
+        uint64_t packets;
+        uint64_t bytes;
+        uint64_t drop_oversize;
+        uint64_t drop_desync;
+        uint64_t drop_fcs;
+        uint64_t drop_csum;
+        uint64_t drop_filter;
+        uint64_t diverted;
+        uint64_t drop_overload;
+        uint64_t overload;
+        uint64_t stall_nobuf;
+        uint64_t stall_ring_full;
+        uint64_t gro_merged;
+        uint64_t pool_alloc;
+        uint32_t pool_free_min;
+        uint32_t ring_depth_max;
+    } NET_CACHE_ALIGNED rx;
+
+    struct {
+        uint64_t delivered;
+        uint64_t pool_free;
+        uint64_t drop_stale;        // DROP_OLD策略修剪掉的帧
+    } NET_CACHE_ALIGNED app;
+
+    struct {
+        uint64_t packets;
+        uint64_t bytes;
+        uint64_t errors;
+        uint64_t drop_nobuf;
+        uint64_t pool_alloc;
+    } NET_CACHE_ALIGNED tx;
+
+    uint32_t pool_capacity;
+
+    NET_CACHE_ALIGNED net_hist_t rx_latency;  // 使用者线程写
+    NET_CACHE_ALIGNED net_hist_t tx_latency;  // 发送线程写
+} net_stats_t;
+
+net_stats_t *net_stats_create(uint32_t pool_capacity);
+void net_stats_destroy(net_stats_t *stats);
+
+// 内存池在用块数（接收+发送申请减去释放）
+uint32_t net_stats_pool_in_use(const net_stats_t *stats);
+
+// 接收线程一批入队后调用：更新接收环深度与内存池低水位
+void net_stats_rx_commit(net_device_t *dev);
+
+static inline uint64_t net_stats_now_ns(void) {
+    return net_time_ns();
+}
+
+// 单写者计数
+static inline void net_stat_add(uint64_t *counter, uint64_t n) {
+    __atomic_store_n(counter, *counter + n, __ATOMIC_RELAXED);
+}
+
+// 多写者计数
+static inline void net_stat_add_shared(uint64_t *counter, uint64_t n) {
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+static inline size_t net_hist_index(uint64_t value) {
+    if (value < (1u << NET_HIST_SUB_BITS)) {
+        return (size_t)value;
+    }
+
+    unsigned msb = 63u - (unsigned)__builtin_clzll(value);
+    if (msb > NET_HIST_MAX_BITS) {
+        return NET_HIST_BUCKETS - 1;
+    }
+
+    unsigned shift = msb - NET_HIST_SUB_BITS;
+    return ((size_t)(shift + 1) << NET_HIST_SUB_BITS) +
+           (size_t)((value >> shift) & ((1u << NET_HIST_SUB_BITS) - 1));
+}
+
+static inline void net_hist_record(net_hist_t *hist, uint64_t value) {
+    uint64_t *bucket = &hist->buckets[net_hist_index(value)];
+
+    __atomic_store_n(bucket, *bucket + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->count, hist->count + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->sum, hist->sum + value, __ATOMIC_RELAXED);
+    if (value > hist->max) {
+        __atomic_store_n(&hist->max, value, __ATOMIC_RELAXED);
+    }
+}
+
+static inline void net_hist_record_shared(net_hist_t *hist, uint64_t value) {
+    uint64_t max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+
+    __atomic_fetch_add(&hist->buckets[net_hist_index(value)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->sum, value, __ATOMIC_RELAXED);
+    while (value > max &&
+           !__atomic_compare_exchange_n(&hist->max, &max, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+#endif
@@ -0,0 +1,507 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "net_device.h"
+#include "net_backend.h"
+#include "net_ring.h"
+#include "net_futex.h"
+
+#define NET_MALLOC(size)    malloc(size)
+#define NET_FREE(ptr)       free(ptr)
+
+// ======================================================================
+// 任务池
+//
+// 固定数量的工作线程，每个线程一个有界多生产者/多消费者队列（每格带序号）。
+// 工作线程提交的任务进自己的队列，其他线程轮流投递到各队列；
+// 工作线程先取自己的队列，空了再依次从其他队列窃取，都空时短暂自旋后在futex上睡眠。
+// 提交只需一次CAS，只有存在睡眠的工作线程时才多一次futex唤醒。
+// ======================================================================
+
+#define NET_TASK_SPIN           256     // 睡眠前空转检查的次数
+
+typedef struct {
+    size_t seq;                 // 等于下标时可写，等于下标+1时可读
+    void (*fn)(void *);
+    void *arg;
+} net_task_cell_t;
+
+typedef struct {
+    NET_CACHE_ALIGNED size_t tail;      // 提交者
+    NET_CACHE_ALIGNED size_t head;      // 本线程与窃取者
+    net_task_cell_t *cells;
+    size_t mask;
+} net_task_queue_t;
+
+typedef struct {
+    net_task_queue_t queue;
+    pthread_t thread_id;
+    uint32_t index;
+    struct net_task_pool *pool;
+} NET_CACHE_ALIGNED net_task_worker_t;
+
+typedef struct net_task_pool {
+    uint32_t worker_nr;
+    volatile bool running;
+    NET_CACHE_ALIGNED uint32_t epoch;       // futex：有新任务且有线程睡眠时递增
+    NET_CACHE_ALIGNED uint32_t sleepers;    // 正在睡眠或准备睡眠的工作线程数
+    net_task_worker_t workers[];
+} net_task_pool_t;
+
+// 可重复提交的任务句柄
+#define NET_TASK_IDLE       0
+#define NET_TASK_QUEUED     1
+#define NET_TASK_RUNNING    2
+#define NET_TASK_CANCELLED  3
+#define NET_TASK_WAITER     0x80000000u     // net_task_delete在等待
+
+typedef struct net_task {
+    void (*start_routine)(void *);
+    void *arg;
+    uint32_t state;             // NET_TASK_xxx，可带NET_TASK_WAITER
+} net_task_t;
+
+// futex信号量
+typedef struct net_sem {
+    uint32_t count;
+    uint32_t waiters;
+    void *userdata; // 用户数据
+} net_sem_t;
+
+static net_task_pool_t *net_task_pool;
+static pthread_mutex_t net_task_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread net_task_worker_t *net_task_self;  // 当前线程是工作线程时指向自己
+static __thread uint32_t net_task_next;            // 非工作线程轮流投递的起点
+
+// ---------------------------------------------------------------- 队列
+
+static int net_task_queue_init(net_task_queue_t *q, size_t depth) {
+    q->cells = (net_task_cell_t *)NET_MALLOC(depth * sizeof(net_task_cell_t));
+    if (!q->cells) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < depth; i++) {
+        q->cells[i].seq = i;
+    }
+    q->mask = depth - 1;
+    q->head = 0;
+    q->tail = 0;
+    return 0;
+}
+
+static int net_task_queue_push(net_task_queue_t *q, void (*fn)(void *), void *arg) {
+    size_t pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+    net_task_cell_t *cell;
+
+    for (;;) {
+        cell = &q->cells[pos & q->mask];
+        intptr_t dif = (intptr_t)__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - (intptr_t)pos;
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&q->tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return -1;
+        } else {
+            pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->fn = fn;
+    cell->arg = arg;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static bool net_task_queue_pop(net_task_queue_t *q, void (**fn)(void *), void **arg) {
+    size_t pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    net_task_cell_t *cell;
+
+    for (;;) {
+        cell = &q->cells[pos & q->mask];
+        intptr_t dif = (intptr_t)__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - (intptr_t)(pos + 1);
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&q->head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return false;
+        } else {
+            pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    *fn = cell->fn;
+    *arg = cell->arg;
+    __atomic_store_n(&cell->seq, pos + q->mask + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static inline bool net_task_queue_empty(const net_task_queue_t *q) {
+    return __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) == __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+}
+
+// ---------------------------------------------------------------- 工作线程
+
+// 先取自己的队列，再从下一个线程开始依次窃取
+static bool net_task_take(net_task_worker_t *self, void (**fn)(void *), void **arg) {
+    net_task_pool_t *pool = self->pool;
+
+    if (net_task_queue_pop(&self->queue, fn, arg)) {
+        return true;
+    }
+    for (uint32_t i = 1; i < pool->worker_nr; i++) {
+        net_task_worker_t *victim = &pool->workers[(self->index + i) % pool->worker_nr];
+        if (net_task_queue_pop(&victim->queue, fn, arg)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool net_task_pool_idle(const net_task_pool_t *pool) {
+    for (uint32_t i = 0; i < pool->worker_nr; i++) {
+        if (!net_task_queue_empty(&pool->workers[i].queue)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *net_task_worker_func(void *arg) {
+    net_task_worker_t *self = (net_task_worker_t *)arg;
+    net_task_pool_t *pool = self->pool;
+    void (*fn)(void *);
+    void *fn_arg;
+    int spin = 0;
+
+    net_task_self = self;
+
+    for (;;) {
+        if (net_task_take(self, &fn, &fn_arg)) {
+            fn(fn_arg);
+            spin = 0;
+            continue;
+        }
+
+        // 停止时先把队列里的任务做完
+        if (!pool->running) {
+            break;
+        }
+
+        if (++spin < NET_TASK_SPIN) {
+            net_cpu_relax();
+            continue;
+        }
+        spin = 0;
+
+        // 先登记再复查队列：提交者入队后看到sleepers为0时，这里的复查一定能看到任务
+        uint32_t epoch = __atomic_load_n(&pool->epoch, __ATOMIC_ACQUIRE);
+        __atomic_add_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+        if (net_task_pool_idle(pool) && pool->running) {
+            net_futex_wait(&pool->epoch, epoch, NULL);
+        }
+        __atomic_sub_fetch(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+    }
+
+    return NULL;
+}
+
+// 唤醒一个睡眠的工作线程，没有睡眠的线程时只是一次读
+static inline void net_task_pool_kick(net_task_pool_t *pool) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->sleepers, __ATOMIC_RELAXED)) {
+        __atomic_add_fetch(&pool->epoch, 1, __ATOMIC_RELEASE);
+        net_futex_wake(&pool->epoch, 1);
+    }
+}
+
+static void net_task_pool_stop(net_task_pool_t *pool, uint32_t started) {
+    pool->running = false;
+    __atomic_add_fetch(&pool->epoch, 1, __ATOMIC_RELEASE);
+    net_futex_wake(&pool->epoch, INT_MAX);
+
+    for (uint32_t i = 0; i < started; i++) {
+        pthread_join(pool->workers[i].thread_id, NULL);
+    }
+    for (uint32_t i = 0; i < pool->worker_nr; i++) {
+        NET_FREE(pool->workers[i].queue.cells);
+    }
+    NET_FREE(pool);
+}
+
+static int net_task_pool_start(uint32_t worker_nr, const int *cpus) {
+    if (net_task_pool) {
+        NET_LOGE("Task pool already running");
+        return -1;
+    }
+
+    if (worker_nr == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_nr = online > 0 ? (uint32_t)online : 1;
+    }
+    if (worker_nr > NET_TASK_WORKER_MAX) {
+        worker_nr = NET_TASK_WORKER_MAX;
+    }
+
+    net_task_pool_t *pool = (net_task_pool_t *)aligned_alloc(NET_CACHE_LINE,
+        (sizeof(net_task_pool_t) + worker_nr * sizeof(net_task_worker_t) + NET_CACHE_LINE - 1) & ~(size_t)(NET_CACHE_LINE - 1));
+    if (!pool) {
+        NET_LOGE("Failed to allocate task pool");
+        return -1;
+    }
+    memset(pool, 0, sizeof(net_task_pool_t) + worker_nr * sizeof(net_task_worker_t));
+    pool->worker_nr = worker_nr;
+    pool->running = true;
+
+    for (uint32_t i = 0; i < worker_nr; i++) {
+        pool->workers[i].index = i;
+        pool->workers[i].pool = pool;
+        if (net_task_queue_init(&pool->workers[i].queue, NET_TASK_QUEUE_DEPTH) != 0) {
+            NET_LOGE("Failed to allocate task queue");
+            net_task_pool_stop(pool, 0);
+            return -1;
+        }
+    }
+
+    for (uint32_t i = 0; i < worker_nr; i++) {
+        char name[16];
+
+        if (pthread_create(&pool->workers[i].thread_id, NULL, net_task_worker_func, &pool->workers[i]) != 0) {
+            perror("Failed to create task worker");
+            net_task_pool_stop(pool, i);
+            return -1;
+        }
+        snprintf(name, sizeof(name), "net-task%u", (unsigned)(uint8_t)i);
+        net_thread_setup(pool->workers[i].thread_id, name, cpus ? cpus[i] : NET_CPU_NONE);
+    }
+
+    __atomic_store_n(&net_task_pool, pool, __ATOMIC_RELEASE);
+    NET_LOGD("Task pool started with %u workers", worker_nr);
+    return 0;
+}
+
+int net_task_pool_init(uint32_t worker_nr, const int *cpus) {
+    pthread_mutex_lock(&net_task_pool_lock);
+    int ret = net_task_pool_start(worker_nr, cpus);
+    pthread_mutex_unlock(&net_task_pool_lock);
+    return ret;
+}
+
+void net_task_pool_shutdown(void) {
+    pthread_mutex_lock(&net_task_pool_lock);
+    net_task_pool_t *pool = net_task_pool;
+    if (pool) {
+        __atomic_store_n(&net_task_pool, NULL, __ATOMIC_RELEASE);
+        net_task_pool_stop(pool, pool->worker_nr);
+    }
+    pthread_mutex_unlock(&net_task_pool_lock);
+}
+
+// 第一次提交时按默认参数启动
+static net_task_pool_t *net_task_pool_get(void) {
+    net_task_pool_t *pool = __atomic_load_n(&net_task_pool, __ATOMIC_ACQUIRE);
+    if (pool) {
+        return pool;
+    }
+
+    pthread_mutex_lock(&net_task_pool_lock);
+    if (!net_task_pool) {
+        net_task_pool_start(0, NULL);
+    }
+    pool = net_task_pool;
+    pthread_mutex_unlock(&net_task_pool_lock);
+    return pool;
+}
+
+int net_task_submit(void (*fn)(void *), void *arg) {
+    net_task_pool_t *pool = net_task_pool_get();
+    net_task_worker_t *self = net_task_self;
+
+    if (!pool || !fn) {
+        return -1;
+    }
+
+    // 工作线程提交的任务留在本地，缓存更热；其他线程轮流投递，队列满时换下一个
+    uint32_t start = (self && self->pool == pool) ? self->index : net_task_next++;
+    for (uint32_t i = 0; i < pool->worker_nr; i++) {
+        net_task_worker_t *worker = &pool->workers[(start + i) % pool->worker_nr];
+        if (net_task_queue_push(&worker->queue, fn, arg) == 0) {
+            net_task_pool_kick(pool);
+            return 0;
+        }
+    }
+
+    // 工作线程等队列空出会卡住自己，直接在当前线程执行
+    if (self && self->pool == pool) {
+        fn(arg);
+        return 0;
+    }
+
+    NET_LOG_RATELIMITED(NET_LOGW, "Task queues full, task rejected");
+    return -1;
+}
+
+// ---------------------------------------------------------------- 任务句柄
+
+static void net_task_run(void *arg) {
+    net_task_t *task = (net_task_t *)arg;
+    uint32_t state = NET_TASK_QUEUED;
+
+    if (__atomic_compare_exchange_n(&task->state, &state, NET_TASK_RUNNING, false,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        task->start_routine(task->arg);
+    }
+
+    if (__atomic_exchange_n(&task->state, NET_TASK_IDLE, __ATOMIC_ACQ_REL) & NET_TASK_WAITER) {
+        net_futex_wake(&task->state, INT_MAX);
+    }
+}
+
+void *net_create_task(void (*start_routine)(void *), void *arg)
+{
+    if (start_routine == NULL) {
+        NET_LOGE("Task routine is NULL");
+        return NULL;
+    }
+
+    net_task_t *task = (net_task_t *)NET_MALLOC(sizeof(net_task_t));
+    if (task == NULL) {
+        NET_LOGE("Failed to allocate memory for task");
+        return NULL;
+    }
+    task->start_routine = start_routine;
+    task->arg = arg;
+    task->state = NET_TASK_IDLE;
+    return (void *)task;
+}
+
+int net_task_start(void *task)
+{
+    net_task_t *t = (net_task_t *)task;
+    uint32_t state = NET_TASK_IDLE;
+
+    if (task == NULL) {
+        NET_LOGE("Task is NULL");
+        return -1;
+    }
+
+    if (!__atomic_compare_exchange_n(&t->state, &state, NET_TASK_QUEUED, false,
+                                     __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        NET_LOGE("Task is already queued or running");
+        return -1;
+    }
+
+    if (net_task_submit(net_task_run, t) != 0) {
+        __atomic_store_n(&t->state, NET_TASK_IDLE, __ATOMIC_RELEASE);
+        NET_LOGE("Failed to submit task");
+        return -1;
+    }
+
+    return 0;
+}
+
+int net_task_delete(void *task)
+{
+    net_task_t *t = (net_task_t *)task;
+
+    if (task == NULL) {
+        NET_LOGE("Task is NULL");
+        return -1;
+    }
+
+    // 还在队列中的取消，正在运行的等它返回；工作线程执行完后才释放句柄
+    for (;;) {
+        uint32_t state = __atomic_load_n(&t->state, __ATOMIC_ACQUIRE);
+
+        if (state == NET_TASK_IDLE) {
+            break;
+        }
+        if (!(state & NET_TASK_WAITER)) {
+            uint32_t next = (state == NET_TASK_QUEUED ? NET_TASK_CANCELLED : state) | NET_TASK_WAITER;
+            __atomic_compare_exchange_n(&t->state, &state, next, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+            continue;
+        }
+        net_futex_wait(&t->state, state, NULL);
+    }
+
+    NET_FREE(task);
+    return 0;
+}
+
+// ---------------------------------------------------------------- 信号量
+
+void *net_create_sem(void)
+{
+    net_sem_t *sem = (net_sem_t *)NET_MALLOC(sizeof(net_sem_t));
+    if (sem == NULL) {
+        NET_LOGE("Failed to allocate memory for semaphore");
+        return NULL;
+    }
+
+    sem->count = 1;
+    sem->waiters = 0;
+    sem->userdata = NULL;
+
+    return sem;
+}
+
+int net_sem_wait(void *sem)
+{
+    net_sem_t *s = (net_sem_t *)sem;
+
+    if (sem == NULL) {
+        NET_LOGE("Semaphore is NULL");
+        return -1;
+    }
+
+    for (;;) {
+        uint32_t count = __atomic_load_n(&s->count, __ATOMIC_RELAXED);
+        while (count > 0) {
+            if (__atomic_compare_exchange_n(&s->count, &count, count - 1, true,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return 0;
+            }
+        }
+
+        // 先登记再睡：post在计数加一之后看waiters，两边至少有一方看到对方
+        __atomic_add_fetch(&s->waiters, 1, __ATOMIC_SEQ_CST);
+        net_futex_wait(&s->count, 0, NULL);
+        __atomic_sub_fetch(&s->waiters, 1, __ATOMIC_RELAXED);
+    }
+}
+
+int net_sem_post(void *sem)
+{
+    net_sem_t *s = (net_sem_t *)sem;
+
+    if (sem == NULL) {
+        NET_LOGE("Semaphore is NULL");
+        return -1;
+    }
+
+    __atomic_add_fetch(&s->count, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&s->waiters, __ATOMIC_SEQ_CST)) {
+        net_futex_wake(&s->count, 1);
+    }
+
+    return 0;
+}
+
+int net_sem_destroy(void *sem)
+{
+    if (sem == NULL) {
+        NET_LOGE("Semaphore is NULL");
+        return -1;
+    }
+
+    NET_FREE(sem);
+
+    return 0;
+}
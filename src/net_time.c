@@ -0,0 +1,84 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include "net_device.h"
+#include "net_time.h"
+
+#if NET_TIME_TSC
+#include <cpuid.h>
+#endif
+
+#define NET_TIME_CALIBRATE_NS   (10 * 1000000L)     // 校准区间
+#define NET_TIME_SAMPLE_NR      16
+
+net_clock_t net_clock;
+
+static pthread_once_t net_time_once = PTHREAD_ONCE_INIT;
+
+#if NET_TIME_TSC
+static bool net_time_tsc_invariant(void) {
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid_max(0x80000000, NULL) < 0x80000007) {
+        return false;
+    }
+    __cpuid(0x80000007, eax, ebx, ecx, edx);
+    return (edx & (1u << 8)) != 0;
+}
+
+// 读一对(TSC, CLOCK_MONOTONIC)：取前后两次TSC间隔最短的一组，避开被中断或抢占的读数
+static void net_time_sample(uint64_t *tsc, uint64_t *ns) {
+    uint64_t best = UINT64_MAX;
+
+    for (int i = 0; i < NET_TIME_SAMPLE_NR; i++) {
+        uint64_t t0 = __rdtsc();
+        uint64_t now = net_time_ns_monotonic();
+        uint64_t t1 = __rdtsc();
+
+        if (t1 - t0 < best) {
+            best = t1 - t0;
+            *tsc = t0 + (t1 - t0) / 2;
+            *ns = now;
+        }
+    }
+}
+
+static void net_time_calibrate(void) {
+    uint64_t tsc0, ns0, tsc1, ns1;
+    struct timespec interval = { .tv_sec = 0, .tv_nsec = NET_TIME_CALIBRATE_NS };
+
+    if (!net_time_tsc_invariant()) {
+        NET_LOGI("TSC is not invariant, using CLOCK_MONOTONIC");
+        return;
+    }
+
+    net_time_sample(&tsc0, &ns0);
+    while (nanosleep(&interval, &interval) != 0) {
+    }
+    net_time_sample(&tsc1, &ns1);
+
+    if (tsc1 <= tsc0 || ns1 <= ns0) {
+        NET_LOGW("TSC calibration failed, using CLOCK_MONOTONIC");
+        return;
+    }
+
+    net_clock.mult = (uint64_t)(((unsigned __int128)(ns1 - ns0) << 32) / (tsc1 - tsc0));
+    net_clock.tsc_base = tsc1;
+    net_clock.ns_base = ns1;
+    __atomic_store_n(&net_clock.tsc, true, __ATOMIC_RELEASE);
+
+    NET_LOGD("TSC calibrated: %.3f MHz", (double)(tsc1 - tsc0) * 1000.0 / (double)(ns1 - ns0));
+}
+#else
+static void net_time_calibrate(void) {
+}
+#endif
+
+void net_time_init(void) {
+    pthread_once(&net_time_once, net_time_calibrate);
+}
+
+const char *net_time_source(void) {
+    return __atomic_load_n(&net_clock.tsc, __ATOMIC_ACQUIRE) ? "tsc" : "monotonic";
+}
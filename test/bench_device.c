@@ -0,0 +1,353 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "net_device.h"
+
+// ======================================================================
+// net_device 吞吐与延迟基准
+//
+// 进程内起一个回环TCP对端，按帧长×批量扫描：
+//   sink —— 对端只收不回，测发送吞吐
+//   echo —— 对端原样回送，测往返吞吐与往返延迟（帧内带发送时间戳）
+// 每个用例一行JSON输出到stdout（或-o文件），便于版本间比对。
+// CPU时间是整个进程的（含对端线程与设备接收线程）。
+// ======================================================================
+
+#define BENCH_PEER_SINK     0
+#define BENCH_PEER_ECHO     1
+#define BENCH_WINDOW        64      // echo模式在途帧上限，避免测到的是排队延迟
+#define BENCH_STAMP_OFF     14      // 时间戳写在以太网头之后
+#define BENCH_PEER_BUF      (256 * 1024)
+#define BENCH_FRAME_HDR_LEN 2       // 模拟链路的长度头
+
+static const size_t bench_frame_sizes[] = { 64, 256, 1500 };
+static const int bench_burst_sizes[] = { 1, 8, 32 };
+
+typedef struct {
+    int listen_fd;
+    int mode;
+    pthread_t thread;
+    uint64_t bytes;                 // 对端收到的字节数（原子读写）
+} bench_peer_t;
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t bench_cpu_ns(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ((uint64_t)ru.ru_utime.tv_sec + (uint64_t)ru.ru_stime.tv_sec) * 1000000000ULL +
+           ((uint64_t)ru.ru_utime.tv_usec + (uint64_t)ru.ru_stime.tv_usec) * 1000ULL;
+}
+
+// ---------------------------------------------------------------- 对端
+
+static void *bench_peer_func(void *arg) {
+    bench_peer_t *peer = (bench_peer_t *)arg;
+    uint8_t *buf = (uint8_t *)malloc(BENCH_PEER_BUF);
+    int one = 1;
+
+    int fd = accept(peer->listen_fd, NULL, NULL);
+    if (fd < 0 || !buf) {
+        perror("peer accept failed");
+        free(buf);
+        return NULL;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    // 回送整段字节流即可，长度头随数据一起原样返回
+    for (;;) {
+        ssize_t n = recv(fd, buf, BENCH_PEER_BUF, 0);
+        if (n <= 0) {
+            break;
+        }
+        __atomic_add_fetch(&peer->bytes, (uint64_t)n, __ATOMIC_RELAXED);
+
+        if (peer->mode == BENCH_PEER_ECHO) {
+            ssize_t off = 0;
+            while (off < n) {
+                ssize_t sent = send(fd, buf + off, (size_t)(n - off), MSG_NOSIGNAL);
+                if (sent < 0) {
+                    goto out;
+                }
+                off += sent;
+            }
+        }
+    }
+
+out:
+    close(fd);
+    free(buf);
+    return NULL;
+}
+
+// 监听回环临时端口，返回端口号
+static int bench_peer_start(bench_peer_t *peer, int mode) {
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t addr_len = sizeof(addr);
+
+    memset(peer, 0, sizeof(*peer));
+    peer->mode = mode;
+    peer->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (peer->listen_fd < 0 ||
+        bind(peer->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(peer->listen_fd, 1) < 0 ||
+        getsockname(peer->listen_fd, (struct sockaddr *)&addr, &addr_len) < 0) {
+        perror("peer listen failed");
+        return -1;
+    }
+
+    if (pthread_create(&peer->thread, NULL, bench_peer_func, peer) != 0) {
+        perror("peer thread failed");
+        close(peer->listen_fd);
+        return -1;
+    }
+
+    return ntohs(addr.sin_port);
+}
+
+static void bench_peer_stop(bench_peer_t *peer) {
+    pthread_join(peer->thread, NULL);
+    close(peer->listen_fd);
+}
+
+// ---------------------------------------------------------------- 用例
+
+typedef struct {
+    net_device_t *dev;
+    size_t frame_len;
+    int burst;
+    uint64_t packets;
+    uint64_t inflight;              // echo模式在途帧数
+    bool windowed;
+} bench_sender_t;
+
+static void *bench_sender_func(void *arg) {
+    bench_sender_t *s = (bench_sender_t *)arg;
+    uint8_t frames[NET_BURST_MAX][NET_MTU_MAX + 14];
+    uint8_t *data[NET_BURST_MAX];
+    size_t lengths[NET_BURST_MAX];
+    uint64_t sent = 0;
+
+    for (int i = 0; i < s->burst; i++) {
+        memset(frames[i], 0, s->frame_len);
+        memset(frames[i], 0xFF, 6);                         // 广播目的地址
+        frames[i][12] = 0x88;                               // 本地实验用EtherType
+        frames[i][13] = 0xB5;
+        data[i] = frames[i];
+        lengths[i] = s->frame_len;
+    }
+
+    while (sent < s->packets) {
+        int n = (int)(s->packets - sent < (uint64_t)s->burst ? s->packets - sent : (uint64_t)s->burst);
+
+        if (s->windowed) {
+            while (__atomic_load_n(&s->inflight, __ATOMIC_ACQUIRE) + (uint64_t)n > BENCH_WINDOW) {
+                sched_yield();
+            }
+            __atomic_add_fetch(&s->inflight, (uint64_t)n, __ATOMIC_RELEASE);
+        }
+
+        uint64_t stamp = bench_now_ns();
+        for (int i = 0; i < n; i++) {
+            memcpy(frames[i] + BENCH_STAMP_OFF, &stamp, sizeof(stamp));
+        }
+
+        // 发送不阻塞调用者：内存池暂时耗尽时只提交一部分，让出CPU后重试剩余的帧
+        int done = 0;
+        while (done < n) {
+            int ret = n - done == 1 ? (net_send(s->dev, data[done], lengths[done]) == 0 ? 1 : -1)
+                                    : net_send_burst(s->dev, &data[done], &lengths[done], n - done);
+            if (ret > 0) {
+                done += ret;
+            } else {
+                sched_yield();
+            }
+        }
+        sent += (uint64_t)n;
+    }
+
+    return NULL;
+}
+
+static int bench_cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint64_t bench_percentile(const uint64_t *sorted, uint64_t n, double p) {
+    uint64_t index = (uint64_t)((double)n * p / 100.0);
+    return sorted[index < n ? index : n - 1];
+}
+
+static int bench_run(FILE *out, int mode, size_t frame_len, int burst, uint64_t packets) {
+    bench_peer_t peer;
+    char remote[32];
+    int port = bench_peer_start(&peer, mode);
+    if (port < 0) {
+        return -1;
+    }
+
+    snprintf(remote, sizeof(remote), "127.0.0.1:%d", port);
+    net_device_t dev = { .mode = NET_MODE_TCPIP, .remote = remote };
+    if (net_init(&dev) != 0) {
+        NET_LOGE("Failed to initialize device");
+        return -1;
+    }
+
+    uint64_t *rtt = NULL;
+    if (mode == BENCH_PEER_ECHO) {
+        rtt = (uint64_t *)malloc(packets * sizeof(uint64_t));
+        if (!rtt) {
+            net_deinit(&dev);
+            return -1;
+        }
+    }
+
+    bench_sender_t sender = {
+        .dev = &dev, .frame_len = frame_len, .burst = burst,
+        .packets = packets, .windowed = (mode == BENCH_PEER_ECHO),
+    };
+    pthread_t tx_thread;
+    uint64_t received = 0;
+    uint64_t cpu_start = bench_cpu_ns();
+    uint64_t start = bench_now_ns();
+
+    pthread_create(&tx_thread, NULL, bench_sender_func, &sender);
+
+    if (mode == BENCH_PEER_ECHO) {
+        uint8_t *buffers[NET_BURST_MAX];
+        size_t lengths[NET_BURST_MAX];
+        int idle = 0;
+
+        while (received < packets && idle < 20) {
+            if (net_receive_wait(&dev, 100) == 0) {
+                idle++;     // 2秒无数据视为丢失，结束用例
+                continue;
+            }
+            idle = 0;
+
+            int n = net_receive_burst(&dev, buffers, lengths, NET_BURST_MAX);
+            uint64_t now = bench_now_ns();
+            for (int i = 0; i < n; i++) {
+                uint64_t stamp;
+                memcpy(&stamp, buffers[i] + BENCH_STAMP_OFF, sizeof(stamp));
+                if (received < packets) {
+                    rtt[received++] = now - stamp;
+                }
+                net_packet_free(&dev, buffers[i]);
+            }
+            __atomic_sub_fetch(&sender.inflight, (uint64_t)n, __ATOMIC_RELEASE);
+        }
+    } else {
+        // 发送吞吐以对端收齐为准
+        uint64_t expect = packets * (BENCH_FRAME_HDR_LEN + frame_len);
+        uint64_t deadline = bench_now_ns() + 30ULL * 1000000000ULL;
+        while (__atomic_load_n(&peer.bytes, __ATOMIC_RELAXED) < expect && bench_now_ns() < deadline) {
+            usleep(100);
+        }
+        received = __atomic_load_n(&peer.bytes, __ATOMIC_RELAXED) / (BENCH_FRAME_HDR_LEN + frame_len);
+    }
+
+    pthread_join(tx_thread, NULL);
+    double seconds = (double)(bench_now_ns() - start) / 1e9;
+    uint64_t cpu = bench_cpu_ns() - cpu_start;
+
+    net_device_stats_t stats;
+    net_get_stats(&dev, &stats);
+    net_deinit(&dev);
+    bench_peer_stop(&peer);
+
+    double pps = received / seconds;
+    fprintf(out, "{\"test\":\"%s\",\"frame\":%zu,\"burst\":%d,\"packets\":%llu,\"completed\":%llu,"
+                 "\"seconds\":%.6f,\"pps\":%.0f,\"gbps\":%.4f,",
+            mode == BENCH_PEER_ECHO ? "echo" : "sink", frame_len, burst,
+            (unsigned long long)packets, (unsigned long long)received,
+            seconds, pps, pps * (double)frame_len * 8 / 1e9);
+
+    if (rtt && received > 0) {
+        qsort(rtt, received, sizeof(uint64_t), bench_cmp_u64);
+        fprintf(out, "\"rtt_p50_ns\":%llu,\"rtt_p99_ns\":%llu,\"rtt_p999_ns\":%llu,",
+                (unsigned long long)bench_percentile(rtt, received, 50),
+                (unsigned long long)bench_percentile(rtt, received, 99),
+                (unsigned long long)bench_percentile(rtt, received, 99.9));
+    } else {
+        fprintf(out, "\"rtt_p50_ns\":null,\"rtt_p99_ns\":null,\"rtt_p999_ns\":null,");
+    }
+
+    fprintf(out, "\"pool_exhausted\":%llu,\"cpu_ns_per_pkt\":%.1f}\n",
+            (unsigned long long)(stats.rx_stall_nobuf + stats.tx_drop_nobuf),
+            received ? (double)cpu / (double)received : 0.0);
+    fflush(out);
+
+    free(rtt);
+    return received == packets ? 0 : -1;
+}
+
+static void bench_usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n packets per case] [-o output.jsonl]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    uint64_t packets = 200000;
+    FILE *out = stdout;
+    int failed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:o:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            packets = strtoull(optarg, NULL, 0);
+            break;
+        case 'o':
+            out = fopen(optarg, "w");
+            if (!out) {
+                perror("open output failed");
+                return 1;
+            }
+            break;
+        default:
+            bench_usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (packets == 0) {
+        bench_usage(argv[0]);
+        return 1;
+    }
+
+    net_log_set_level(NET_LOG_LEVEL_WARNING);
+
+    for (int mode = BENCH_PEER_SINK; mode <= BENCH_PEER_ECHO; mode++) {
+        for (size_t f = 0; f < sizeof(bench_frame_sizes) / sizeof(bench_frame_sizes[0]); f++) {
+            for (size_t b = 0; b < sizeof(bench_burst_sizes) / sizeof(bench_burst_sizes[0]); b++) {
+                if (bench_run(out, mode, bench_frame_sizes[f], bench_burst_sizes[b], packets) != 0) {
+                    failed++;
+                }
+            }
+        }
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    return failed ? 1 : 0;
+}
@@ -72,7 +72,7 @@ int main() {
     void *task = net_create_task(test_task, &dev);
     if (task) {
         net_task_start(task);
-        // 这里应该等待任务完成，简化示例中直接继续
+        // net_task_delete等待任务执行完再释放句柄
         net_task_delete(task);
     }
 #endif
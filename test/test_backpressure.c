@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "net_device.h"
+#include "test_link.h"
+
+// 接收过载策略测试，夹具见test_link.h
+
+// 过载策略：接收环32项，高水位50%，低水位25%，对端一次发100帧
+static void rx_test_policy_config(rx_test_t *t, uint8_t policy) {
+    memset(t, 0, sizeof(*t));
+    t->config.rx_queue_depth = 32;
+    t->config.rx_policy = policy;
+    t->config.rx_high_pct = 50;
+    t->config.rx_low_pct = 25;
+}
+
+// BLOCK：接收线程停在满队列上，使用者取走后继续，一帧不丢
+static int test_policy_block(void) {
+    static rx_test_t t;
+    net_device_stats_t stats;
+
+    rx_test_policy_config(&t, NET_RX_POLICY_BLOCK);
+    if (rx_test_start(&t, "block", 100, 8, "A") != 0) {
+        return 1;
+    }
+
+    rx_test_settle(&t);
+    RX_EXPECT(&t, net_get_stats(&t.dev, &stats) == 0);
+    RX_EXPECT(&t, stats.rx_packets < (uint64_t)t.count);
+
+    rx_test_drain(&t, 4);
+    RX_EXPECT(&t, t.frame_nr == t.count);
+    RX_EXPECT(&t, rx_test_in_order(&t));
+    RX_EXPECT(&t, rx_test_hysteresis(&t));
+    RX_EXPECT(&t, t.event_nr >= 2);
+
+    RX_EXPECT(&t, net_get_stats(&t.dev, &stats) == 0);
+    RX_EXPECT(&t, stats.rx_drop_overload == 0);
+    RX_EXPECT(&t, stats.rx_overload_events == (uint64_t)(t.event_nr + 1) / 2);
+
+    rx_test_finish(&t, t.frame_nr);
+    return t.failures;
+}
+
+// DROP_NEW：过载后新到的帧丢弃，收到的是最早的一段
+static int test_policy_drop_new(void) {
+    static rx_test_t t;
+    net_device_stats_t stats;
+
+    rx_test_policy_config(&t, NET_RX_POLICY_DROP_NEW);
+    if (rx_test_start(&t, "dropnew", 100, 8, "A") != 0) {
+        return 1;
+    }
+
+    rx_test_settle(&t);
+    rx_test_drain(&t, NET_BURST_MAX);
+    RX_EXPECT(&t, net_get_stats(&t.dev, &stats) == 0);
+    RX_EXPECT(&t, t.frame_nr > 0 && t.frame_nr < t.count);
+    RX_EXPECT(&t, t.frames[0].seq == 0);
+    RX_EXPECT(&t, rx_test_in_order(&t));
+    RX_EXPECT(&t, stats.rx_drop_overload == (uint64_t)(t.count - t.frame_nr));
+    RX_EXPECT(&t, rx_test_hysteresis(&t));
+    // 过了高水位就开始丢，不等接收环满
+    RX_EXPECT(&t, t.frame_nr < (int)t.config.rx_queue_depth);
+
+    rx_test_finish(&t, t.frame_nr + (int)stats.rx_drop_overload);
+    return t.failures;
+}
+
+// DROP_OLD：取帧时把队列修剪到低水位，丢最旧的，最新的帧一定交付
+static int test_policy_drop_old(void) {
+    static rx_test_t t;
+    net_device_stats_t stats;
+
+    rx_test_policy_config(&t, NET_RX_POLICY_DROP_OLD);
+    if (rx_test_start(&t, "dropold", 100, 8, "A") != 0) {
+        return 1;
+    }
+
+    rx_test_settle(&t);
+    rx_test_drain(&t, NET_BURST_MAX);
+    RX_EXPECT(&t, net_get_stats(&t.dev, &stats) == 0);
+    RX_EXPECT(&t, t.frame_nr > 0 && t.frame_nr < t.count);
+    RX_EXPECT(&t, t.frames[0].seq > 0);
+    RX_EXPECT(&t, t.frame_nr > 0 && t.frames[t.frame_nr - 1].seq == (uint32_t)(t.count - 1));
+    RX_EXPECT(&t, rx_test_in_order(&t));
+    RX_EXPECT(&t, stats.rx_drop_overload == (uint64_t)(t.count - t.frame_nr));
+    RX_EXPECT(&t, rx_test_hysteresis(&t));
+
+    rx_test_finish(&t, t.frame_nr + (int)stats.rx_drop_overload);
+    return t.failures;
+}
+
+static const test_case_t backpressure_tests[] = {
+    { "policy_block",       test_policy_block },
+    { "policy_drop_new",    test_policy_drop_new },
+    { "policy_drop_old",    test_policy_drop_old },
+};
+
+int main(int argc, char **argv) {
+    return rx_test_main(argc, argv, backpressure_tests, TEST_COUNT(backpressure_tests));
+}
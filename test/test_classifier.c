@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "net_device.h"
+#include "net_classify.h"
+#include "net_classifier.h"
+#include "test_util.h"
+
+// 接收分类规则匹配测试：在共享内存设备（不需要对端）上安装规则表，
+// 直接用net_classify_match匹配构造的帧，检查目标队列、回调与统计。
+// 没有对端发帧，接收线程不会同时匹配，测试线程可以代替它调用
+
+#define CLS_TEST_QUEUES     4
+#define CLS_TEST_FRAME_LEN  60
+#define CLS_TEST_NO_VLAN    0xFFFF
+
+static const uint8_t cls_test_host[NET_ETH_ALEN] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+static const uint8_t cls_test_blocked[NET_ETH_ALEN] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0xAA };
+static const uint8_t cls_test_mcast[NET_ETH_ALEN] = { 0x01, 0x00, 0x5E, 0x00, 0x00, 0x01 };
+
+static int cls_test_callbacks;
+
+static void cls_test_callback(NET_MSG_TYPE msg_type, void *userdata, uint8_t *data, size_t length) {
+    (void)data;
+    if (msg_type == NET_MSG_TYPE_RX_PACKET && userdata == &cls_test_callbacks && length == CLS_TEST_FRAME_LEN) {
+        cls_test_callbacks++;
+    }
+}
+
+// 目的MAC为dst的帧，vlan不为CLS_TEST_NO_VLAN时带一层802.1Q标签
+static size_t cls_test_frame(uint8_t *frame, const uint8_t *dst, uint16_t vlan, uint16_t type) {
+    static const uint8_t src[NET_ETH_ALEN] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    size_t off = NET_ETH_ALEN * 2;
+
+    memset(frame, 0, CLS_TEST_FRAME_LEN);
+    memcpy(frame, dst, NET_ETH_ALEN);
+    memcpy(frame + NET_ETH_ALEN, src, NET_ETH_ALEN);
+    if (vlan != CLS_TEST_NO_VLAN) {
+        frame[off++] = (uint8_t)(NET_ETHERTYPE_VLAN >> 8);
+        frame[off++] = (uint8_t)NET_ETHERTYPE_VLAN;
+        frame[off++] = (uint8_t)(vlan >> 8);
+        frame[off++] = (uint8_t)vlan;
+    }
+    frame[off++] = (uint8_t)(type >> 8);
+    frame[off] = (uint8_t)type;
+    return CLS_TEST_FRAME_LEN;
+}
+
+static int cls_test_match(net_device_t *dev, const uint8_t *dst, uint16_t vlan, uint16_t type) {
+    uint8_t frame[CLS_TEST_FRAME_LEN];
+    size_t length = cls_test_frame(frame, dst, vlan, type);
+
+    return net_classify_match(dev, frame, length);
+}
+
+static int cls_test_open(net_device_t *dev, net_device_config_t *config, char *link, size_t size) {
+    snprintf(link, size, "net-cls-test-%d", (int)getpid());
+    memset(config, 0, sizeof(*config));
+    config->rx_queue_nr = CLS_TEST_QUEUES;
+    memset(dev, 0, sizeof(*dev));
+    dev->mode = NET_MODE_SHM;
+    dev->remote = link;
+    dev->config = config;
+    return net_init(dev);
+}
+
+// 规则按顺序匹配，第一条生效；VLAN规则看外层ID，EtherType跳过标签比较
+static int test_rule_order(void) {
+    static net_device_t dev;
+    static net_device_config_t config;
+    char link[64];
+    net_device_stats_t stats;
+    int failures = 0;
+    const net_rule_t rules[] = {
+        { .match = NET_MATCH_DST_MAC, .action = NET_ACTION_DROP,
+          .dst_mac = { 0x02, 0x00, 0x00, 0x00, 0x00, 0xAA } },
+        { .match = NET_MATCH_ETHERTYPE, .ethertype = NET_ETHERTYPE_ARP,
+          .action = NET_ACTION_QUEUE, .queue = 1 },
+        { .match = NET_MATCH_VLAN, .vlan_id = 100, .action = NET_ACTION_QUEUE, .queue = 2 },
+        { .match = NET_MATCH_DST_MAC, .dst_mac = { 0x01 }, .dst_mask = { 0x01 },
+          .action = NET_ACTION_CALLBACK, .callback = cls_test_callback, .userdata = &cls_test_callbacks },
+        { .match = NET_MATCH_UNTAGGED | NET_MATCH_ETHERTYPE, .ethertype = NET_ETHERTYPE_IPV4,
+          .action = NET_ACTION_QUEUE, .queue = 3 },
+    };
+
+    if (cls_test_open(&dev, &config, link, sizeof(link)) != 0) {
+        return 1;
+    }
+
+    // 无规则：全部进队列0
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_blocked, CLS_TEST_NO_VLAN, NET_ETHERTYPE_IPV4) == 0);
+
+    TEST_EXPECT(failures, net_classify_set(&dev, rules, (int)(sizeof(rules) / sizeof(rules[0]))) == 0);
+    cls_test_callbacks = 0;
+
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_blocked, CLS_TEST_NO_VLAN, NET_ETHERTYPE_ARP) == -1);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_host, CLS_TEST_NO_VLAN, NET_ETHERTYPE_ARP) == 1);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_host, 100, NET_ETHERTYPE_ARP) == 1);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_host, 100, NET_ETHERTYPE_IPV4) == 2);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_host, (7 << 13) | 100, NET_ETHERTYPE_IPV4) == 2);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_mcast, 100, NET_ETHERTYPE_IPV4) == 2);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_mcast, CLS_TEST_NO_VLAN, NET_ETHERTYPE_IPV4) == -1);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_host, CLS_TEST_NO_VLAN, NET_ETHERTYPE_IPV4) == 3);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_host, 200, NET_ETHERTYPE_IPV4) == 0);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_host, CLS_TEST_NO_VLAN, NET_ETHERTYPE_IPV6) == 0);
+    TEST_EXPECT(failures, cls_test_callbacks == 1);
+
+    // 不足以太网头的帧不匹配任何规则
+    uint8_t runt[NET_ETH_HLEN - 1];
+    memcpy(runt, cls_test_blocked, NET_ETH_ALEN);
+    TEST_EXPECT(failures, net_classify_match(&dev, runt, sizeof(runt)) == 0);
+
+    TEST_EXPECT(failures, net_get_stats(&dev, &stats) == 0);
+    TEST_EXPECT(failures, stats.rx_drop_filter == 1);
+    TEST_EXPECT(failures, stats.rx_diverted == 1);
+
+    net_deinit(&dev);
+    return failures;
+}
+
+// 非法规则整表拒绝，原表继续生效；count为0清除规则
+static int test_rule_replace(void) {
+    static net_device_t dev;
+    static net_device_config_t config;
+    char link[64];
+    int failures = 0;
+    const net_rule_t drop_ipv4[] = {
+        { .match = NET_MATCH_ETHERTYPE, .ethertype = NET_ETHERTYPE_IPV4, .action = NET_ACTION_DROP },
+    };
+    const net_rule_t bad_queue[] = {
+        { .match = 0, .action = NET_ACTION_QUEUE, .queue = 1 },
+        { .match = 0, .action = NET_ACTION_QUEUE, .queue = CLS_TEST_QUEUES },
+    };
+    const net_rule_t bad_vlan[] = {
+        { .match = NET_MATCH_VLAN | NET_MATCH_UNTAGGED, .vlan_id = 1, .action = NET_ACTION_DROP },
+    };
+    const net_rule_t bad_callback[] = {
+        { .match = 0, .action = NET_ACTION_CALLBACK },
+    };
+
+    if (cls_test_open(&dev, &config, link, sizeof(link)) != 0) {
+        return 1;
+    }
+
+    TEST_EXPECT(failures, net_classify_set(&dev, drop_ipv4, 1) == 0);
+    TEST_EXPECT(failures, net_classify_set(&dev, bad_queue, 2) == -1);
+    TEST_EXPECT(failures, net_classify_set(&dev, bad_vlan, 1) == -1);
+    TEST_EXPECT(failures, net_classify_set(&dev, bad_callback, 1) == -1);
+    TEST_EXPECT(failures, net_classify_set(&dev, drop_ipv4, NET_RULE_MAX + 1) == -1);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_host, CLS_TEST_NO_VLAN, NET_ETHERTYPE_IPV4) == -1);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_host, CLS_TEST_NO_VLAN, NET_ETHERTYPE_ARP) == 0);
+
+    TEST_EXPECT(failures, net_classify_set(&dev, NULL, 0) == 0);
+    TEST_EXPECT(failures, cls_test_match(&dev, cls_test_host, CLS_TEST_NO_VLAN, NET_ETHERTYPE_IPV4) == 0);
+
+    net_deinit(&dev);
+    return failures;
+}
+
+static const test_case_t classifier_tests[] = {
+    { "rule_order",         test_rule_order },
+    { "rule_replace",       test_rule_replace },
+};
+
+int main(void) {
+    return test_run(classifier_tests, TEST_COUNT(classifier_tests));
+}
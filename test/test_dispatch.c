@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "net_device.h"
+#include "test_link.h"
+
+// 接收批量投递测试，夹具见test_link.h
+
+// INLINE/DEFERRED：ops.rx_burst按批收到全部帧；INLINE在接收线程里调用，DEFERRED不在
+static int rx_test_deliver(const char *name, uint8_t deliver) {
+    static rx_test_t t;
+    int frames = 0;
+
+    memset(&t, 0, sizeof(t));
+    t.config.rx_deliver = deliver;
+    if (rx_test_start(&t, name, 200, 200, "AB") != 0) {
+        return 1;
+    }
+
+    for (int waited = 0; waited < RX_TEST_WAIT_MS && frames < t.count; waited++) {
+        usleep(1000);
+        pthread_mutex_lock(&t.lock);
+        frames = t.frame_nr;
+        pthread_mutex_unlock(&t.lock);
+    }
+
+    pthread_mutex_lock(&t.lock);
+    RX_EXPECT(&t, t.frame_nr == t.count);
+    for (int i = 0; i < t.frame_nr; i++) {
+        RX_EXPECT(&t, t.frames[i].seq == (uint32_t)i);
+        RX_EXPECT(&t, t.frames[i].flow == ((i % 2) ? 'B' : 'A'));
+    }
+    RX_EXPECT(&t, t.burst_max > 0 && t.burst_max <= NET_RX_CALLBACK_BATCH);
+    if (deliver == NET_RX_DELIVER_INLINE) {
+        RX_EXPECT(&t, pthread_equal(t.burst_thread, t.rx_thread));
+    } else {
+        RX_EXPECT(&t, !pthread_equal(t.burst_thread, t.rx_thread));
+    }
+    pthread_mutex_unlock(&t.lock);
+
+    rx_test_finish(&t, frames);
+    return t.failures;
+}
+
+static int test_deliver_inline(void) {
+    return rx_test_deliver("inline", NET_RX_DELIVER_INLINE);
+}
+
+static int test_deliver_deferred(void) {
+    return rx_test_deliver("deferred", NET_RX_DELIVER_DEFERRED);
+}
+
+static const test_case_t dispatch_tests[] = {
+    { "deliver_inline",     test_deliver_inline },
+    { "deliver_deferred",   test_deliver_deferred },
+};
+
+int main(int argc, char **argv) {
+    return rx_test_main(argc, argv, dispatch_tests, TEST_COUNT(dispatch_tests));
+}
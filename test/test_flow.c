@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "net_packet.h"
+#include "net_classifier.h"
+#include "test_util.h"
+
+// 对称流哈希测试：连接两个方向的帧哈希相同，VLAN标签不影响结果
+
+#define FLOW_TEST_FRAME_LEN 128
+#define FLOW_TEST_NO_VLAN   0xFFFF
+
+typedef struct {
+    uint16_t type;              // NET_ETHERTYPE_IPV4/IPV6
+    uint8_t proto;
+    uint8_t src[16];
+    uint8_t dst[16];
+    uint16_t sport;
+    uint16_t dport;
+    uint16_t frag;              // IPv4分片字段（MF与偏移）
+    uint16_t vlan;
+} flow_test_t;
+
+static size_t flow_test_frame(uint8_t *frame, const flow_test_t *f) {
+    static const uint8_t mac[NET_ETH_ALEN] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    size_t off = NET_ETH_ALEN * 2;
+
+    memset(frame, 0, FLOW_TEST_FRAME_LEN);
+    net_eth_build_header(frame, mac, mac, 0);
+    if (f->vlan != FLOW_TEST_NO_VLAN) {
+        frame[off++] = (uint8_t)(NET_ETHERTYPE_VLAN >> 8);
+        frame[off++] = (uint8_t)NET_ETHERTYPE_VLAN;
+        frame[off++] = (uint8_t)(f->vlan >> 8);
+        frame[off++] = (uint8_t)f->vlan;
+    }
+    frame[off++] = (uint8_t)(f->type >> 8);
+    frame[off++] = (uint8_t)f->type;
+
+    uint8_t *ip = frame + off;
+    uint8_t *l4;
+    if (f->type == NET_ETHERTYPE_IPV4) {
+        ip[0] = 0x45;
+        ip[6] = (uint8_t)(f->frag >> 8);
+        ip[7] = (uint8_t)f->frag;
+        ip[9] = f->proto;
+        memcpy(ip + 12, f->src, 4);
+        memcpy(ip + 16, f->dst, 4);
+        l4 = ip + 20;
+    } else {
+        ip[0] = 0x60;
+        ip[6] = f->proto;
+        memcpy(ip + 8, f->src, 16);
+        memcpy(ip + 24, f->dst, 16);
+        l4 = ip + 40;
+    }
+    l4[0] = (uint8_t)(f->sport >> 8);
+    l4[1] = (uint8_t)f->sport;
+    l4[2] = (uint8_t)(f->dport >> 8);
+    l4[3] = (uint8_t)f->dport;
+    return FLOW_TEST_FRAME_LEN;
+}
+
+static uint32_t flow_test_hash(const flow_test_t *f) {
+    uint8_t frame[FLOW_TEST_FRAME_LEN];
+    size_t length = flow_test_frame(frame, f);
+
+    return net_flow_hash(frame, length);
+}
+
+// 交换源/目的地址与端口
+static flow_test_t flow_test_reverse(const flow_test_t *f) {
+    flow_test_t r = *f;
+
+    memcpy(r.src, f->dst, sizeof(r.src));
+    memcpy(r.dst, f->src, sizeof(r.dst));
+    r.sport = f->dport;
+    r.dport = f->sport;
+    return r;
+}
+
+// 两个方向哈希相同且不为0，换一个端口哈希不同
+static int flow_test_symmetric(const flow_test_t *f) {
+    flow_test_t r = flow_test_reverse(f);
+    flow_test_t other = *f;
+    uint32_t h = flow_test_hash(f);
+    int failures = 0;
+
+    other.sport++;
+    TEST_EXPECT(failures, h != 0);
+    TEST_EXPECT(failures, flow_test_hash(&r) == h);
+    TEST_EXPECT(failures, flow_test_hash(&other) != h);
+    TEST_EXPECT(failures, net_rss_queue(flow_test_hash(&r), 4) == net_rss_queue(h, 4));
+    return failures;
+}
+
+static int test_ipv4(void) {
+    flow_test_t tcp = { .type = NET_ETHERTYPE_IPV4, .proto = 6, .src = { 10, 0, 0, 1 }, .dst = { 10, 0, 0, 2 },
+                        .sport = 40000, .dport = 80, .vlan = FLOW_TEST_NO_VLAN };
+    flow_test_t udp = tcp;
+    int failures = 0;
+
+    udp.proto = 17;
+    failures += flow_test_symmetric(&tcp);
+    failures += flow_test_symmetric(&udp);
+    TEST_EXPECT(failures, flow_test_hash(&tcp) != flow_test_hash(&udp));
+    return failures;
+}
+
+static int test_ipv6(void) {
+    flow_test_t udp = { .type = NET_ETHERTYPE_IPV6, .proto = 17,
+                        .src = { 0xfd, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },
+                        .dst = { 0xfd, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2 },
+                        .sport = 5353, .dport = 5353, .vlan = FLOW_TEST_NO_VLAN };
+
+    return flow_test_symmetric(&udp);
+}
+
+// 地址相同时按端口决定方向，两个方向仍然相同
+static int test_same_address(void) {
+    flow_test_t loop = { .type = NET_ETHERTYPE_IPV4, .proto = 6, .src = { 127, 0, 0, 1 }, .dst = { 127, 0, 0, 1 },
+                         .sport = 2000, .dport = 1000, .vlan = FLOW_TEST_NO_VLAN };
+
+    return flow_test_symmetric(&loop);
+}
+
+// VLAN标签不参与哈希；分片只按地址对，同一报文的各分片与两个方向都相同
+static int test_vlan_and_fragments(void) {
+    flow_test_t tcp = { .type = NET_ETHERTYPE_IPV4, .proto = 6, .src = { 10, 0, 0, 1 }, .dst = { 10, 0, 0, 2 },
+                        .sport = 40000, .dport = 80, .vlan = FLOW_TEST_NO_VLAN };
+    flow_test_t tagged = tcp;
+    flow_test_t first = tcp;
+    flow_test_t later = tcp;
+    int failures = 0;
+
+    tagged.vlan = 100;
+    TEST_EXPECT(failures, flow_test_hash(&tagged) == flow_test_hash(&tcp));
+
+    first.frag = 0x2000;
+    later.frag = 0x00B9;
+    later.sport = 0x1234;
+    later.dport = 0x5678;
+    flow_test_t reversed = flow_test_reverse(&later);
+    TEST_EXPECT(failures, flow_test_hash(&first) != 0);
+    TEST_EXPECT(failures, flow_test_hash(&first) == flow_test_hash(&later));
+    TEST_EXPECT(failures, flow_test_hash(&reversed) == flow_test_hash(&first));
+    TEST_EXPECT(failures, flow_test_hash(&first) != flow_test_hash(&tcp));
+    return failures;
+}
+
+// 非IP帧与截断的IP头返回0
+static int test_non_ip(void) {
+    flow_test_t arp = { .type = NET_ETHERTYPE_ARP, .vlan = FLOW_TEST_NO_VLAN };
+    flow_test_t tcp = { .type = NET_ETHERTYPE_IPV4, .proto = 6, .src = { 10, 0, 0, 1 }, .dst = { 10, 0, 0, 2 },
+                        .sport = 40000, .dport = 80, .vlan = 100 };
+    uint8_t frame[FLOW_TEST_FRAME_LEN];
+    int failures = 0;
+
+    flow_test_frame(frame, &arp);
+    TEST_EXPECT(failures, net_flow_hash(frame, FLOW_TEST_FRAME_LEN) == 0);
+
+    flow_test_frame(frame, &tcp);
+    TEST_EXPECT(failures, net_flow_hash(frame, NET_ETH_HLEN + NET_VLAN_HLEN + 19) == 0);
+    TEST_EXPECT(failures, net_flow_hash(frame, NET_ETH_HLEN + 1) == 0);
+    TEST_EXPECT(failures, net_flow_hash(frame, NET_ETH_HLEN + NET_VLAN_HLEN + 20) != 0);
+    return failures;
+}
+
+static const test_case_t flow_tests[] = {
+    { "ipv4",               test_ipv4 },
+    { "ipv6",               test_ipv6 },
+    { "same_address",       test_same_address },
+    { "vlan_and_fragments", test_vlan_and_fragments },
+    { "non_ip",             test_non_ip },
+};
+
+int main(void) {
+    return test_run(flow_tests, TEST_COUNT(flow_tests));
+}
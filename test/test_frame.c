@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "net_frame.h"
+#include "test_util.h"
+
+// 模拟链路帧格式的重组测试：同一段字节流按不同大小拆成多次写入，切出的帧不变
+
+#define FRAME_TEST_NR       4
+#define FRAME_TEST_BYTES    (FRAME_TEST_NR * NET_FRAME_HDR_LEN + 1 + 60 + 1500 + 9000)
+
+static const size_t frame_test_lens[FRAME_TEST_NR] = { 1, 60, 1500, 9000 };
+
+static uint8_t frame_test_byte(int frame, size_t i) {
+    return (uint8_t)(frame * 31 + i);
+}
+
+// 把全部测试帧编码成一段字节流，返回总长
+static size_t frame_test_encode(uint8_t *out) {
+    size_t off = 0;
+
+    for (int f = 0; f < FRAME_TEST_NR; f++) {
+        net_frame_encode_header(out + off, frame_test_lens[f]);
+        off += NET_FRAME_HDR_LEN;
+        for (size_t i = 0; i < frame_test_lens[f]; i++) {
+            out[off++] = frame_test_byte(f, i);
+        }
+    }
+    return off;
+}
+
+// 校验第f帧的长度与内容
+static bool frame_test_check(int f, const uint8_t *frame, size_t length) {
+    if (f >= FRAME_TEST_NR || length != frame_test_lens[f]) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (frame[i] != frame_test_byte(f, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 每次写入chunk字节，写完一次就把能切出的帧都取走；不完整的帧不能提前返回
+static int frame_test_split(size_t chunk) {
+    static uint8_t wire[FRAME_TEST_BYTES];
+    size_t total = frame_test_encode(wire);
+    net_frame_stream_t stream;
+    size_t fed = 0;
+    size_t ends[FRAME_TEST_NR];
+    int got = 0;
+    int failures = 0;
+
+    ends[0] = NET_FRAME_HDR_LEN + frame_test_lens[0];
+    for (int f = 1; f < FRAME_TEST_NR; f++) {
+        ends[f] = ends[f - 1] + NET_FRAME_HDR_LEN + frame_test_lens[f];
+    }
+
+    TEST_EXPECT(failures, net_frame_stream_init(&stream, 0) == 0);
+    while (fed < total) {
+        size_t space = 0;
+        uint8_t *wptr = net_frame_stream_write_ptr(&stream, &space);
+        size_t n = total - fed < chunk ? total - fed : chunk;
+
+        TEST_EXPECT(failures, space >= n);
+        memcpy(wptr, wire + fed, n);
+        net_frame_stream_commit(&stream, n);
+        fed += n;
+
+        const uint8_t *frame;
+        size_t length;
+        int ret;
+        while ((ret = net_frame_stream_next(&stream, &frame, &length)) == 1) {
+            TEST_EXPECT(failures, frame_test_check(got, frame, length));
+            TEST_EXPECT(failures, got < FRAME_TEST_NR && fed >= ends[got]);
+            got++;
+        }
+        TEST_EXPECT(failures, ret == 0);
+    }
+    TEST_EXPECT(failures, got == FRAME_TEST_NR);
+
+    net_frame_stream_deinit(&stream);
+    if (failures) {
+        fprintf(stderr, "split reads of %zu bytes failed\n", chunk);
+    }
+    return failures;
+}
+
+static int test_split_reads(void) {
+    static const size_t chunks[] = { 1, 2, 3, 7, 61, 1024, FRAME_TEST_BYTES };
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        failures += frame_test_split(chunks[i]);
+    }
+    return failures;
+}
+
+// 尾部空间不足一个最大帧时，残留的半帧搬到缓冲区头部后继续拼接
+static int test_compact(void) {
+    static uint8_t first[40000];
+    static uint8_t second[30000];
+    net_frame_stream_t stream;
+    const uint8_t *frame;
+    size_t length;
+    size_t space;
+    uint8_t *wptr;
+    int failures = 0;
+
+    memset(first, 0xA5, sizeof(first));
+    for (size_t i = 0; i < sizeof(second); i++) {
+        second[i] = (uint8_t)(i * 7);
+    }
+
+    TEST_EXPECT(failures, net_frame_stream_init(&stream, 0) == 0);
+    TEST_EXPECT(failures, stream.size == NET_FRAME_HDR_LEN + NET_FRAME_MAX_LEN);
+
+    // 一整帧加下一帧的前10000字节
+    wptr = net_frame_stream_write_ptr(&stream, &space);
+    net_frame_encode_header(wptr, sizeof(first));
+    memcpy(wptr + NET_FRAME_HDR_LEN, first, sizeof(first));
+    net_frame_encode_header(wptr + NET_FRAME_HDR_LEN + sizeof(first), sizeof(second));
+    memcpy(wptr + 2 * NET_FRAME_HDR_LEN + sizeof(first), second, 10000);
+    net_frame_stream_commit(&stream, 2 * NET_FRAME_HDR_LEN + sizeof(first) + 10000);
+
+    TEST_EXPECT(failures, net_frame_stream_next(&stream, &frame, &length) == 1);
+    TEST_EXPECT(failures, length == sizeof(first) && memcmp(frame, first, length) == 0);
+    TEST_EXPECT(failures, net_frame_stream_next(&stream, &frame, &length) == 0);
+
+    wptr = net_frame_stream_write_ptr(&stream, &space);
+    TEST_EXPECT(failures, stream.head == 0);
+    TEST_EXPECT(failures, space >= sizeof(second) - 10000);
+    memcpy(wptr, second + 10000, sizeof(second) - 10000);
+    net_frame_stream_commit(&stream, sizeof(second) - 10000);
+
+    TEST_EXPECT(failures, net_frame_stream_peek(&stream, &length) == 1 && length == sizeof(second));
+    TEST_EXPECT(failures, net_frame_stream_next(&stream, &frame, &length) == 1);
+    TEST_EXPECT(failures, length == sizeof(second) && memcmp(frame, second, length) == 0);
+    TEST_EXPECT(failures, net_frame_stream_next(&stream, &frame, &length) == 0);
+
+    net_frame_stream_deinit(&stream);
+    return failures;
+}
+
+// 长度头为0说明流已失步，只头部到了一半时还不能判断
+static int test_desync(void) {
+    net_frame_stream_t stream;
+    const uint8_t *frame;
+    size_t length;
+    size_t space;
+    uint8_t *wptr;
+    int failures = 0;
+
+    TEST_EXPECT(failures, net_frame_stream_init(&stream, 0) == 0);
+    wptr = net_frame_stream_write_ptr(&stream, &space);
+    wptr[0] = 0;
+    wptr[1] = 0;
+    net_frame_stream_commit(&stream, 1);
+    TEST_EXPECT(failures, net_frame_stream_next(&stream, &frame, &length) == 0);
+    net_frame_stream_commit(&stream, 1);
+    TEST_EXPECT(failures, net_frame_stream_next(&stream, &frame, &length) == -1);
+
+    net_frame_stream_reset(&stream);
+    TEST_EXPECT(failures, net_frame_stream_next(&stream, &frame, &length) == 0);
+
+    net_frame_stream_deinit(&stream);
+    return failures;
+}
+
+static const test_case_t frame_tests[] = {
+    { "split_reads",        test_split_reads },
+    { "compact",            test_compact },
+    { "desync",             test_desync },
+};
+
+int main(void) {
+    return test_run(frame_tests, TEST_COUNT(frame_tests));
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "net_device.h"
+#include "net_packet.h"
+#include "test_link.h"
+
+// GRO合并测试，夹具见test_link.h
+
+// ---------------------------------------------------------------- 用例
+
+// GRO：同一条流的连续帧串成链，换流或满max段时另起一条
+static int test_gro_chain(void) {
+    static rx_test_t t;
+    static const char flows[] = "AAABBAAAAAAB";
+    static const int expect_chain[] = { 0, 0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 4 };
+    net_device_stats_t stats;
+
+    memset(&t, 0, sizeof(t));
+    t.config.rx_gro_segs = 4;
+    if (rx_test_start(&t, "gro", (int)strlen(flows), (int)strlen(flows), flows) != 0) {
+        return 1;
+    }
+
+    rx_test_drain(&t, NET_BURST_MAX);
+    RX_EXPECT(&t, t.frame_nr == t.count);
+    RX_EXPECT(&t, t.chain_nr == 5);
+    for (int i = 0; i < t.frame_nr; i++) {
+        RX_EXPECT(&t, t.frames[i].seq == (uint32_t)i);
+        RX_EXPECT(&t, t.frames[i].flow == flows[i]);
+        RX_EXPECT(&t, t.frames[i].chain == expect_chain[i]);
+    }
+
+    RX_EXPECT(&t, net_get_stats(&t.dev, &stats) == 0);
+    RX_EXPECT(&t, stats.rx_packets == (uint64_t)t.count);
+    RX_EXPECT(&t, stats.rx_gro_merged == (uint64_t)(t.count - 5));
+    RX_EXPECT(&t, stats.rx_delivered == 5);
+
+    rx_test_finish(&t, t.frame_nr);
+    return t.failures;
+}
+
+// GRO链经net_receive_pool逐帧复制交付，一帧不少
+static int test_gro_pool(void) {
+    static rx_test_t t;
+    static const char flows[] = "AAABBAAAAAAB";
+    uint8_t data[RX_TEST_FRAME_LEN * 2];
+
+    memset(&t, 0, sizeof(t));
+    t.config.rx_gro_segs = 4;
+    if (rx_test_start(&t, "pool", (int)strlen(flows), (int)strlen(flows), flows) != 0) {
+        return 1;
+    }
+
+    while (net_receive_wait(&t.dev, RX_TEST_SETTLE_MS) > 0) {
+        int length = net_receive_pool(&t.dev, data, sizeof(data));
+        RX_EXPECT(&t, length == RX_TEST_FRAME_LEN);
+        if (length <= 0) {
+            break;
+        }
+        RX_EXPECT(&t, rx_test_seq(data) == (uint32_t)t.frame_nr);
+        RX_EXPECT(&t, data[RX_TEST_FLOW_OFF] == flows[t.frame_nr % t.count]);
+        t.frame_nr++;
+    }
+    RX_EXPECT(&t, t.frame_nr == t.count);
+
+    rx_test_finish(&t, t.frame_nr);
+    return t.failures;
+}
+
+static const test_case_t gro_tests[] = {
+    { "gro_chain",          test_gro_chain },
+    { "gro_pool",           test_gro_pool },
+};
+
+int main(int argc, char **argv) {
+    return rx_test_main(argc, argv, gro_tests, TEST_COUNT(gro_tests));
+}
@@ -0,0 +1,268 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include "net_device.h"
+#include "net_packet.h"
+#include "test_link.h"
+
+// ---------------------------------------------------------------- 帧
+
+size_t rx_test_build(uint8_t *frame, char flow, uint32_t seq) {
+    static const uint8_t eth[] = {
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0x08, 0x00,
+    };
+    uint8_t *ip = frame + sizeof(eth);
+    uint8_t *udp = ip + 20;
+
+    memset(frame, 0, RX_TEST_FRAME_LEN);
+    memcpy(frame, eth, sizeof(eth));
+    ip[0] = 0x45;
+    ip[3] = RX_TEST_FRAME_LEN - sizeof(eth);
+    ip[8] = 64;
+    ip[9] = 17;
+    ip[12] = 10; ip[15] = 1;
+    ip[16] = 10; ip[19] = 2;
+    udp[0] = 0x10;
+    udp[1] = (uint8_t)flow;
+    udp[2] = 0x30;
+    udp[3] = 0x39;
+    udp[5] = RX_TEST_FRAME_LEN - sizeof(eth) - 20;
+    frame[RX_TEST_SEQ_OFF] = (uint8_t)(seq >> 24);
+    frame[RX_TEST_SEQ_OFF + 1] = (uint8_t)(seq >> 16);
+    frame[RX_TEST_SEQ_OFF + 2] = (uint8_t)(seq >> 8);
+    frame[RX_TEST_SEQ_OFF + 3] = (uint8_t)seq;
+    return RX_TEST_FRAME_LEN;
+}
+
+uint32_t rx_test_seq(const uint8_t *frame) {
+    return ((uint32_t)frame[RX_TEST_SEQ_OFF] << 24) | ((uint32_t)frame[RX_TEST_SEQ_OFF + 1] << 16) |
+           ((uint32_t)frame[RX_TEST_SEQ_OFF + 2] << 8) | frame[RX_TEST_SEQ_OFF + 3];
+}
+
+// ---------------------------------------------------------------- 对端
+
+static int rx_test_peer(const char *link, int count, int burst, const char *flows) {
+    static uint8_t frames[RX_TEST_FRAME_MAX][RX_TEST_FRAME_LEN];
+    uint8_t *data[RX_TEST_FRAME_MAX];
+    size_t lengths[RX_TEST_FRAME_MAX];
+    size_t flow_nr = strlen(flows);
+    net_device_t dev = { .mode = NET_MODE_SHM, .remote = link };
+    int sent = 0;
+    int ret = 1;
+
+    if (count <= 0 || count > RX_TEST_FRAME_MAX || burst <= 0 || flow_nr == 0 || net_init(&dev) != 0) {
+        return 1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        lengths[i] = rx_test_build(frames[i], flows[i % flow_nr], (uint32_t)i);
+        data[i] = frames[i];
+    }
+
+    // 一次发出的帧不超过NET_BURST_MAX时，对方在同一批内看到全部
+    while (sent < count) {
+        int n = count - sent < burst ? count - sent : burst;
+        if (sent > 0) {
+            usleep(RX_TEST_GAP_MS * 1000);
+        }
+        if (net_send_burst(&dev, data + sent, lengths + sent, n) != n) {
+            break;
+        }
+        sent += n;
+    }
+
+    if (sent == count && net_receive_wait(&dev, RX_TEST_WAIT_MS) > 0) {
+        size_t length = 0;
+        uint8_t *ack = net_receive_zerocpy_with_length(&dev, &length);
+        if (ack) {
+            if (length == RX_TEST_FRAME_LEN && ack[RX_TEST_FLOW_OFF] == RX_TEST_ACK_FLOW &&
+                rx_test_seq(ack) == (uint32_t)count) {
+                ret = 0;
+            } else {
+                fprintf(stderr, "peer: %d frames sent, %u acknowledged\n", count, rx_test_seq(ack));
+            }
+            net_packet_free(&dev, ack);
+        }
+    }
+
+    net_deinit(&dev);
+    return ret;
+}
+
+// ---------------------------------------------------------------- 本端
+
+static void rx_test_callback(NET_MSG_TYPE msg_type, void *userdata, uint8_t *data, size_t length) {
+    rx_test_t *t = (rx_test_t *)userdata;
+    (void)data;
+
+    pthread_mutex_lock(&t->lock);
+    if (msg_type == NET_MSG_TYPE_RX_PACKET) {
+        t->rx_thread = pthread_self();
+    } else if ((msg_type == NET_MSG_TYPE_RX_OVERLOAD || msg_type == NET_MSG_TYPE_RX_RECOVER) &&
+               t->event_nr < RX_TEST_EVENT_MAX) {
+        t->events[t->event_nr] = msg_type;
+        t->levels[t->event_nr] = length;
+        t->event_nr++;
+    }
+    pthread_mutex_unlock(&t->lock);
+}
+
+static void rx_test_burst(void *userdata, uint8_t **buffers, const size_t *lengths, int count) {
+    rx_test_t *t = (rx_test_t *)userdata;
+
+    pthread_mutex_lock(&t->lock);
+    t->burst_thread = pthread_self();
+    if (count > t->burst_max) {
+        t->burst_max = count;
+    }
+    for (int i = 0; i < count; i++) {
+        if (t->frame_nr < RX_TEST_FRAME_MAX && lengths[i] == RX_TEST_FRAME_LEN) {
+            t->frames[t->frame_nr].seq = rx_test_seq(buffers[i]);
+            t->frames[t->frame_nr].flow = (char)buffers[i][RX_TEST_FLOW_OFF];
+            t->frame_nr++;
+        }
+        net_packet_free(&t->dev, buffers[i]);
+    }
+    pthread_mutex_unlock(&t->lock);
+}
+
+int rx_test_start(rx_test_t *t, const char *name, int count, int burst, const char *flows) {
+    char count_arg[16];
+    char burst_arg[16];
+
+    snprintf(t->link, sizeof(t->link), "net-rx-test-%d-%s", (int)getpid(), name);
+    snprintf(count_arg, sizeof(count_arg), "%d", count);
+    snprintf(burst_arg, sizeof(burst_arg), "%d", burst);
+
+    t->count = count;
+    t->dev.mode = NET_MODE_SHM;
+    t->dev.remote = t->link;
+    t->dev.config = &t->config;
+    t->dev.callback = rx_test_callback;
+    t->dev.userdata = t;
+    t->dev.ops.rx_burst = rx_test_burst;
+    pthread_mutex_init(&t->lock, NULL);
+
+    if (net_init(&t->dev) != 0) {
+        fprintf(stderr, "%s: net_init failed\n", name);
+        return -1;
+    }
+
+    t->peer = fork();
+    if (t->peer == 0) {
+        execl("/proc/self/exe", "rx_test_peer", "--peer", t->link, count_arg, burst_arg, flows,
+              (char *)NULL);
+        _exit(127);
+    }
+    if (t->peer < 0) {
+        perror("fork failed");
+        net_deinit(&t->dev);
+        return -1;
+    }
+    return 0;
+}
+
+void rx_test_finish(rx_test_t *t, int claimed) {
+    uint8_t ack[RX_TEST_FRAME_LEN];
+    int status = 0;
+
+    rx_test_build(ack, RX_TEST_ACK_FLOW, (uint32_t)claimed);
+    RX_EXPECT(t, net_send(&t->dev, ack, sizeof(ack)) == 0);
+    RX_EXPECT(t, waitpid(t->peer, &status, 0) == t->peer);
+    RX_EXPECT(t, WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    net_deinit(&t->dev);
+    pthread_mutex_destroy(&t->lock);
+}
+
+void rx_test_drain(rx_test_t *t, int burst) {
+    uint8_t *buffers[NET_BURST_MAX];
+    size_t lengths[NET_BURST_MAX];
+
+    while (net_receive_wait(&t->dev, RX_TEST_SETTLE_MS) > 0) {
+        int n = net_receive_burst(&t->dev, buffers, lengths, burst);
+
+        for (int i = 0; i < n; i++) {
+            size_t length = lengths[i];
+
+            for (uint8_t *b = buffers[i]; b; b = net_packet_next(b)) {
+                RX_EXPECT(t, length == RX_TEST_FRAME_LEN);
+                if (t->frame_nr < RX_TEST_FRAME_MAX) {
+                    t->frames[t->frame_nr].seq = rx_test_seq(b);
+                    t->frames[t->frame_nr].flow = (char)b[RX_TEST_FLOW_OFF];
+                    t->frames[t->frame_nr].chain = t->chain_nr;
+                    t->frame_nr++;
+                }
+                length = net_packet_next(b) ? net_packet_meta(net_packet_next(b))->length : 0;
+            }
+            t->chain_nr++;
+            net_packet_free_chain(&t->dev, buffers[i]);
+        }
+        if (burst < NET_BURST_MAX) {
+            usleep(1000);
+        }
+    }
+}
+
+void rx_test_settle(rx_test_t *t) {
+    net_device_stats_t stats;
+    uint64_t last = UINT64_MAX;
+
+    for (int waited = 0; waited < RX_TEST_WAIT_MS; waited += RX_TEST_SETTLE_MS) {
+        usleep(RX_TEST_SETTLE_MS * 1000);
+        if (net_get_stats(&t->dev, &stats) != 0 || stats.rx_packets + stats.rx_drop_overload == last) {
+            break;
+        }
+        last = stats.rx_packets + stats.rx_drop_overload;
+    }
+}
+
+bool rx_test_in_order(const rx_test_t *t) {
+    for (int i = 1; i < t->frame_nr; i++) {
+        if (t->frames[i].seq <= t->frames[i - 1].seq) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool rx_test_hysteresis(rx_test_t *t) {
+    bool ok = t->event_nr > 0;
+
+    pthread_mutex_lock(&t->lock);
+    for (int i = 0; i < t->event_nr; i++) {
+        NET_MSG_TYPE expect = (i % 2) == 0 ? NET_MSG_TYPE_RX_OVERLOAD : NET_MSG_TYPE_RX_RECOVER;
+        if (t->events[i] != expect) {
+            ok = false;
+        } else if (expect == NET_MSG_TYPE_RX_OVERLOAD && t->levels[i] < t->config.rx_high_pct) {
+            ok = false;
+        } else if (expect == NET_MSG_TYPE_RX_RECOVER && t->levels[i] > t->config.rx_low_pct) {
+            ok = false;
+        }
+    }
+    pthread_mutex_unlock(&t->lock);
+    return ok;
+}
+
+// ---------------------------------------------------------------- 入口
+
+int rx_test_main(int argc, char **argv, const test_case_t *tests, size_t count) {
+    if (argc == 6 && strcmp(argv[1], "--peer") == 0) {
+        return rx_test_peer(argv[2], atoi(argv[3]), atoi(argv[4]), argv[5]);
+    }
+
+    // 用例检查加入失败时没有误关描述符0，先保证它是打开的
+    if (fcntl(STDIN_FILENO, F_GETFD) == -1 && open("/dev/null", O_RDONLY) != STDIN_FILENO) {
+        perror("open /dev/null failed");
+        return 1;
+    }
+
+    return test_run(tests, count);
+}
@@ -0,0 +1,86 @@
+#ifndef TEST_LINK_H
+#define TEST_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "net_device.h"
+#include "test_util.h"
+
+// ======================================================================
+// 共享内存链路测试夹具
+//
+// 每个用例先按配置net_init共享内存链路（创建方），再fork+exec本程序作为
+// 对端（加入方），不需要网络与root。对端每次发burst帧、间隔RX_TEST_GAP_MS，
+// 共发count帧IPv4/UDP：第i帧属于flows[i % strlen(flows)]指定的流（源端口），
+// 载荷带序号i。
+// 本进程检查收到的帧、回调与统计后回一帧确认，序号是本端认领
+// （收到或按策略丢弃）的帧数，对端核对一致才以0退出。
+// 使用夹具的测试程序在main中调用rx_test_main，它同时处理对端模式。
+// ======================================================================
+
+#define RX_TEST_FRAME_LEN   64
+#define RX_TEST_FLOW_OFF    35      // UDP源端口低字节
+#define RX_TEST_SEQ_OFF     42      // 以太网14 + IPv4 20 + UDP 8
+#define RX_TEST_ACK_FLOW    'Z'
+#define RX_TEST_FRAME_MAX   256
+#define RX_TEST_EVENT_MAX   64
+#define RX_TEST_WAIT_MS     5000
+#define RX_TEST_SETTLE_MS   200     // 这么久没有新帧就认为对端的帧已处理完
+#define RX_TEST_GAP_MS      10      // 对端分批发送的间隔，让接收线程每批都重新计算占用
+
+typedef struct {
+    uint32_t seq;
+    char flow;
+    int chain;                      // 所在GRO链的序号（按到达顺序）
+} rx_test_frame_t;
+
+typedef struct {
+    net_device_t dev;
+    net_device_config_t config;
+    char link[64];                  // 链路名称，dev.remote指向这里
+    pid_t peer;
+    int count;                      // 对端发出的帧数
+    int failures;
+
+    rx_test_frame_t frames[RX_TEST_FRAME_MAX];
+    int frame_nr;
+    int chain_nr;
+
+    // 以下由接收线程或投递线程写
+    pthread_mutex_t lock;
+    NET_MSG_TYPE events[RX_TEST_EVENT_MAX];
+    size_t levels[RX_TEST_EVENT_MAX];
+    int event_nr;
+    pthread_t rx_thread;            // RX_PACKET回调所在线程
+    pthread_t burst_thread;         // ops.rx_burst所在线程
+    int burst_max;
+} rx_test_t;
+
+#define RX_EXPECT(t, cond) TEST_EXPECT((t)->failures, cond)
+
+// 构造第seq帧，返回帧长
+size_t rx_test_build(uint8_t *frame, char flow, uint32_t seq);
+uint32_t rx_test_seq(const uint8_t *frame);
+
+// 按t->config打开链路并启动对端
+int rx_test_start(rx_test_t *t, const char *name, int count, int burst, const char *flows);
+// 回确认帧，等对端退出后关闭设备
+void rx_test_finish(rx_test_t *t, int claimed);
+
+// 零拷贝取帧，直到RX_TEST_SETTLE_MS内没有新帧；GRO链逐段记录
+// 每次取burst帧，不足NET_BURST_MAX时每次取完稍等，让接收线程看到逐步回落的占用
+void rx_test_drain(rx_test_t *t, int burst);
+// 等对端发完、接收线程处理完：接收与过载丢弃的帧数RX_TEST_SETTLE_MS内不再变化
+void rx_test_settle(rx_test_t *t);
+
+// 收到的帧序号严格递增
+bool rx_test_in_order(const rx_test_t *t);
+// 过载/恢复通知交替出现，且分别在高水位以上、低水位以下
+bool rx_test_hysteresis(rx_test_t *t);
+
+// 测试程序入口：带--peer参数时作为对端运行，否则执行用例
+int rx_test_main(int argc, char **argv, const test_case_t *tests, size_t count);
+
+#endif
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "net_packet.h"
+#include "test_util.h"
+
+// 报文缓冲区加/去头部的边界测试，不经过内存池，描述符放在栈上的缓冲区里
+
+#define PKT_TEST_SIZE       256
+
+typedef struct {
+    uint8_t bytes[sizeof(net_pkt_t) + PKT_TEST_SIZE];
+} __attribute__((aligned(sizeof(void *)))) pkt_test_t;
+
+// 按net_pkt_alloc的布局初始化：data在headroom处，帧长为0
+static net_pkt_t *pkt_test_init(pkt_test_t *storage, size_t headroom) {
+    net_pkt_t *pkt = (net_pkt_t *)storage->bytes;
+
+    memset(storage, 0, sizeof(*storage));
+    pkt->size = PKT_TEST_SIZE;
+    pkt->data = pkt->buf + headroom;
+    pkt->len = 0;
+    return pkt;
+}
+
+// 写一个不带标签的以太网帧：目的/源MAC、IPv4类型、payload字节载荷
+static void pkt_test_eth(net_pkt_t *pkt, size_t payload) {
+    static const uint8_t dst[NET_ETH_ALEN] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+    static const uint8_t src[NET_ETH_ALEN] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    uint8_t *body = net_pkt_put(pkt, payload);
+
+    for (size_t i = 0; i < payload; i++) {
+        body[i] = (uint8_t)i;
+    }
+    net_pkt_push_eth(pkt, dst, src, NET_ETHERTYPE_IPV4);
+}
+
+// push/pull/put不越过头部、帧尾与尾部空间，失败时描述符不变
+static int test_push_pull(void) {
+    pkt_test_t storage;
+    net_pkt_t *pkt = pkt_test_init(&storage, 8);
+    int failures = 0;
+
+    TEST_EXPECT(failures, net_pkt_headroom(pkt) == 8);
+    TEST_EXPECT(failures, net_pkt_tailroom(pkt) == PKT_TEST_SIZE - 8);
+
+    TEST_EXPECT(failures, net_pkt_push(pkt, 9) == NULL);
+    TEST_EXPECT(failures, pkt->data == pkt->buf + 8 && pkt->len == 0);
+    TEST_EXPECT(failures, net_pkt_push(pkt, 8) == pkt->buf);
+    TEST_EXPECT(failures, pkt->len == 8 && net_pkt_headroom(pkt) == 0);
+    TEST_EXPECT(failures, net_pkt_push(pkt, 1) == NULL);
+
+    TEST_EXPECT(failures, net_pkt_pull(pkt, 9) == NULL);
+    TEST_EXPECT(failures, pkt->data == pkt->buf && pkt->len == 8);
+    TEST_EXPECT(failures, net_pkt_pull(pkt, 8) == pkt->buf + 8);
+    TEST_EXPECT(failures, pkt->len == 0);
+    TEST_EXPECT(failures, net_pkt_pull(pkt, 1) == NULL);
+
+    TEST_EXPECT(failures, net_pkt_put(pkt, PKT_TEST_SIZE - 8 + 1) == NULL);
+    TEST_EXPECT(failures, pkt->len == 0);
+    TEST_EXPECT(failures, net_pkt_put(pkt, PKT_TEST_SIZE - 8) == pkt->buf + 8);
+    TEST_EXPECT(failures, net_pkt_tailroom(pkt) == 0);
+    TEST_EXPECT(failures, net_pkt_put(pkt, 1) == NULL);
+
+    net_pkt_trim(pkt, PKT_TEST_SIZE);
+    TEST_EXPECT(failures, pkt->len == PKT_TEST_SIZE - 8);
+    net_pkt_trim(pkt, 10);
+    TEST_EXPECT(failures, pkt->len == 10);
+    return failures;
+}
+
+// 插入标签只搬动MAC地址，去掉后恢复原帧；QinQ两层按外层先出
+static int test_vlan_round_trip(void) {
+    pkt_test_t storage;
+    net_pkt_t *pkt = pkt_test_init(&storage, NET_PKT_HEADROOM);
+    uint8_t orig[NET_ETH_HLEN + 32];
+    uint16_t tci = 0;
+    int failures = 0;
+
+    pkt_test_eth(pkt, 32);
+    TEST_EXPECT(failures, pkt->len == sizeof(orig));
+    memcpy(orig, pkt->data, sizeof(orig));
+
+    TEST_EXPECT(failures, net_pkt_push_vlan(pkt, NET_ETHERTYPE_VLAN, 5, 100) == 0);
+    TEST_EXPECT(failures, pkt->len == sizeof(orig) + NET_VLAN_HLEN);
+    TEST_EXPECT(failures, memcmp(pkt->data, orig, NET_ETH_ALEN * 2) == 0);
+    TEST_EXPECT(failures, pkt->data[12] == 0x81 && pkt->data[13] == 0x00);
+    TEST_EXPECT(failures, pkt->data[14] == 0xA0 && pkt->data[15] == 100);
+    TEST_EXPECT(failures, memcmp(pkt->data + 16, orig + 12, sizeof(orig) - 12) == 0);
+
+    TEST_EXPECT(failures, net_pkt_push_vlan(pkt, NET_ETHERTYPE_QINQ, 0, 0xFFF) == 0);
+    TEST_EXPECT(failures, net_eth_get_type(pkt->data, pkt->len) == NET_ETHERTYPE_IPV4);
+
+    TEST_EXPECT(failures, net_pkt_pop_vlan(pkt, &tci) == 0);
+    TEST_EXPECT(failures, tci == 0x0FFF);
+    TEST_EXPECT(failures, net_pkt_pop_vlan(pkt, &tci) == 0);
+    TEST_EXPECT(failures, tci == ((5 << 13) | 100));
+    TEST_EXPECT(failures, pkt->len == sizeof(orig) && memcmp(pkt->data, orig, sizeof(orig)) == 0);
+    TEST_EXPECT(failures, net_pkt_headroom(pkt) == NET_PKT_HEADROOM - NET_ETH_HLEN);
+
+    TEST_EXPECT(failures, net_pkt_pop_vlan(pkt, NULL) == -1);
+    TEST_EXPECT(failures, pkt->len == sizeof(orig) && memcmp(pkt->data, orig, sizeof(orig)) == 0);
+    return failures;
+}
+
+// 帧太短或头部空间不够时加/去标签失败，帧保持原样
+static int test_vlan_bounds(void) {
+    pkt_test_t storage;
+    net_pkt_t *pkt = pkt_test_init(&storage, NET_PKT_HEADROOM);
+    uint8_t orig[NET_ETH_HLEN + 2];
+    int failures = 0;
+
+    // 不足一个以太网头
+    net_pkt_put(pkt, NET_ETH_HLEN - 1);
+    TEST_EXPECT(failures, net_pkt_push_vlan(pkt, NET_ETHERTYPE_VLAN, 0, 1) == -1);
+    TEST_EXPECT(failures, pkt->len == NET_ETH_HLEN - 1 && net_pkt_headroom(pkt) == NET_PKT_HEADROOM);
+
+    // 头部只剩3字节
+    pkt = pkt_test_init(&storage, NET_ETH_HLEN + NET_VLAN_HLEN - 1);
+    pkt_test_eth(pkt, 2);
+    memcpy(orig, pkt->data, sizeof(orig));
+    TEST_EXPECT(failures, net_pkt_headroom(pkt) == NET_VLAN_HLEN - 1);
+    TEST_EXPECT(failures, net_pkt_push_vlan(pkt, NET_ETHERTYPE_VLAN, 0, 1) == -1);
+    TEST_EXPECT(failures, pkt->len == sizeof(orig) && memcmp(pkt->data, orig, sizeof(orig)) == 0);
+
+    // 类型是VLAN但帧只有以太网头加2字节，放不下标签
+    pkt->data[12] = 0x81;
+    pkt->data[13] = 0x00;
+    TEST_EXPECT(failures, net_pkt_pop_vlan(pkt, NULL) == -1);
+    TEST_EXPECT(failures, pkt->len == sizeof(orig));
+    TEST_EXPECT(failures, net_eth_get_type(pkt->data, pkt->len) == 0);
+    TEST_EXPECT(failures, net_eth_get_type(pkt->data, NET_ETH_HLEN - 1) == 0);
+    return failures;
+}
+
+static const test_case_t packet_tests[] = {
+    { "push_pull",          test_push_pull },
+    { "vlan_round_trip",    test_vlan_round_trip },
+    { "vlan_bounds",        test_vlan_bounds },
+};
+
+int main(void) {
+    return test_run(packet_tests, TEST_COUNT(packet_tests));
+}
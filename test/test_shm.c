@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "net_device.h"
+#include "net_packet.h"
+#include "test_link.h"
+
+// 共享内存链路测试，夹具见test_link.h
+
+// 创建/加入/收发/释放一轮；加入失败的设备不能关掉别人的描述符
+static int test_shm_round_trip(void) {
+    static rx_test_t t;
+    net_device_stats_t stats;
+    size_t length = 0;
+
+    memset(&t, 0, sizeof(t));
+    if (rx_test_start(&t, "rt", 100, 100, "AB") != 0) {
+        return 1;
+    }
+
+    for (int i = 0; i < t.count && net_receive_wait(&t.dev, RX_TEST_WAIT_MS) > 0; i++) {
+        uint8_t *frame = net_receive_zerocpy_with_length(&t.dev, &length);
+        RX_EXPECT(&t, frame != NULL);
+        if (!frame) {
+            break;
+        }
+        RX_EXPECT(&t, length == RX_TEST_FRAME_LEN);
+        RX_EXPECT(&t, rx_test_seq(frame) == (uint32_t)i);
+        RX_EXPECT(&t, frame[RX_TEST_FLOW_OFF] == ((i % 2) ? 'B' : 'A'));
+        net_packet_free(&t.dev, frame);
+        t.frame_nr++;
+    }
+    RX_EXPECT(&t, t.frame_nr == t.count);
+    RX_EXPECT(&t, net_check_packet_input(&t.dev) == 0);
+
+    // 槽比本端缓冲区小的链路加入失败，出错路径只能关自己打开的描述符
+    char name[sizeof(t.link) + 8];
+    snprintf(name, sizeof(name), "%s-small", t.link);
+    net_device_config_t big = { .mtu = 9000, .pool = { { 9216 + NET_ETH_HLEN_MAX, 16 } } };
+    net_device_t small = { .mode = NET_MODE_SHM, .remote = name };
+    net_device_t other = { .mode = NET_MODE_SHM, .remote = name, .config = &big };
+    RX_EXPECT(&t, net_init(&small) == 0);
+    RX_EXPECT(&t, net_init(&other) != 0);
+    RX_EXPECT(&t, fcntl(STDIN_FILENO, F_GETFD) != -1);
+    net_deinit(&small);
+
+    RX_EXPECT(&t, net_get_stats(&t.dev, &stats) == 0);
+    RX_EXPECT(&t, stats.rx_packets == (uint64_t)t.count);
+    RX_EXPECT(&t, stats.rx_delivered == (uint64_t)t.count);
+
+    rx_test_finish(&t, t.frame_nr);
+    RX_EXPECT(&t, fcntl(STDIN_FILENO, F_GETFD) != -1);
+    return t.failures;
+}
+
+static const test_case_t shm_tests[] = {
+    { "shm_round_trip",     test_shm_round_trip },
+};
+
+int main(int argc, char **argv) {
+    return rx_test_main(argc, argv, shm_tests, TEST_COUNT(shm_tests));
+}
@@ -0,0 +1,44 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// ======================================================================
+// 测试公用：检查宏与用例表
+// 每个测试可执行文件列出自己的用例，用例返回失败的检查数，
+// 有用例失败时进程返回1，由ctest判定。
+// ======================================================================
+
+// 条件不成立时打印位置并把failures加1，继续往下检查
+#define TEST_EXPECT(failures, cond) do {                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: expect failed: %s\n", __FILE__, __LINE__, #cond); \
+            (failures)++;                                                           \
+        }                                                                           \
+    } while (0)
+
+typedef struct {
+    const char *name;
+    int (*func)(void);
+} test_case_t;
+
+// 依次执行用例并打印结果
+static inline int test_run(const test_case_t *tests, size_t count) {
+    int failed = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        int failures = tests[i].func();
+        printf("[%s] %s\n", failures ? "FAIL" : " OK ", tests[i].name);
+        fflush(stdout);
+        if (failures) {
+            failed++;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
+
+#define TEST_COUNT(tests) (sizeof(tests) / sizeof((tests)[0]))
+
+#endif